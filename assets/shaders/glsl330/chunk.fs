@@ -0,0 +1,37 @@
+#version 330
+
+in vec2 fragTexCoord;
+in vec4 fragColor;
+flat in int fragLayer;
+in vec3 fragViewPos;
+
+uniform sampler2D texture0;   // Block atlas
+uniform vec4 layerRects[30];  // Atlas x, y, width, height per layer; width 0 = untextured
+uniform vec4 layerColors[30]; // Flat color of untextured layers
+uniform vec4 fogColor;
+uniform vec2 fogRange;        // Untextured layers fade towards fogColor from x to y blocks away
+uniform vec2 ditherRange;     // Pixels whose dither threshold falls outside [x, y) are dropped
+
+out vec4 finalColor;
+
+// 4x4 ordered dither thresholds; two detail levels given complementary ranges cover every pixel once
+const float bayer[16] = float[16](0.0, 8.0, 2.0, 10.0, 12.0, 4.0, 14.0, 6.0, 3.0, 11.0, 1.0, 9.0, 15.0, 7.0, 13.0, 5.0);
+
+void main()
+{
+    int cell = (int(gl_FragCoord.x) & 3) + (int(gl_FragCoord.y) & 3)*4;
+    float threshold = (bayer[cell] + 0.5)/16.0;
+    if (threshold < ditherRange.x || threshold >= ditherRange.y) discard;
+
+    vec4 rect = layerRects[fragLayer];
+    vec4 color;
+    if (rect.z > 0.0) {
+        // Greedy quads span several blocks: wrap inside the layer's tile
+        color = texture(texture0, rect.xy + fract(fragTexCoord)*rect.zw);
+    } else {
+        color = layerColors[fragLayer];
+        float fog = clamp((length(fragViewPos) - fogRange.x)/(fogRange.y - fogRange.x), 0.0, 1.0);
+        color.rgb = mix(color.rgb, fogColor.rgb, fog);
+    }
+    finalColor = color*fragColor;
+}
@@ -0,0 +1,24 @@
+#version 330
+
+// Chunk terrain: packed ChunkVertex attributes (see chunk_vertices.c)
+in vec3 vertexPosition;
+in vec2 vertexTexCoord;  // In blocks, repeats every 1.0
+in vec4 vertexColor;     // Face shading
+in float vertexLayer;    // Texture layer, block type * 3 + face group
+
+uniform mat4 mvp;
+uniform vec3 viewOffset; // Chunk origin relative to the camera
+
+out vec2 fragTexCoord;
+out vec4 fragColor;
+flat out int fragLayer;
+out vec3 fragViewPos;    // Relative to the camera, for fog
+
+void main()
+{
+    fragTexCoord = vertexTexCoord;
+    fragColor = vertexColor;
+    fragLayer = int(vertexLayer);
+    fragViewPos = vertexPosition + viewOffset;
+    gl_Position = mvp*vec4(vertexPosition, 1.0);
+}
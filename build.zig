@@ -3,6 +3,7 @@ const std = @import("std");
 pub fn build(b: *std.Build) void {
     const target = b.standardTargetOptions(.{});
     const optimize = b.standardOptimizeOption(.{});
+    const use_lz4 = b.option(bool, "lz4", "Compress saved chunks with LZ4 instead of zlib (links liblz4)") orelse false;
 
     const client_mod = b.createModule(.{
         .root_source_file = b.path("src/root.zig"),
@@ -34,9 +35,18 @@ pub fn build(b: *std.Build) void {
         "src/client/clouds.c",
         "src/client/menu.c",
         "src/client/rendering.c",
+        "src/client/chunk_gpu.c",
+        "src/client/chunk_cull.c",
         "src/client/neutrino_detect.c",
         "src/common/world_generation.c",
+        "src/common/chunk_storage.c",
+        "src/common/chunk_pool.c",
+        "src/common/region_file.c",
+        "src/common/chunk_vertices.c",
+        "src/common/block_atlas.c",
         "src/common/worker.c",
+        "src/common/save_queue.c",
+        "src/common/chunk_io.c",
         "src/common/player.c",
         "src/common/game_server.c",
         "src/common/console.c",
@@ -48,8 +58,16 @@ pub fn build(b: *std.Build) void {
 
     const server_sources = &.{
         "src/server/main.c",
+        "src/server/checks.c",
         "src/common/world_generation.c",
+        "src/common/chunk_storage.c",
+        "src/common/chunk_pool.c",
+        "src/common/region_file.c",
+        "src/common/chunk_vertices.c",
+        "src/common/block_atlas.c",
         "src/common/worker.c",
+        "src/common/save_queue.c",
+        "src/common/chunk_io.c",
         "src/common/player.c",
         "src/common/game_server.c",
         "src/common/console.c",
@@ -79,6 +97,12 @@ pub fn build(b: *std.Build) void {
     for (server_link_libs) |lib| {
         server_mod.linkSystemLibrary(lib, .{});
     }
+    if (use_lz4) {
+        for ([_]*std.Build.Module{ client_mod, server_mod }) |mod| {
+            mod.addCMacro("HAVE_LZ4", "1");
+            mod.linkSystemLibrary("lz4", .{});
+        }
+    }
 
     switch (target.result.os.tag) {
         .linux => {
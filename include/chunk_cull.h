@@ -0,0 +1,62 @@
+#ifndef CHUNK_CULL_H
+#define CHUNK_CULL_H
+
+#include "chunk_gpu.h"
+#include "raylib.h"
+#include "utils.h"
+#include "world.h"
+
+// Plane as dot(normal, p) + d; points with a non-negative result are inside
+typedef struct {
+    Vector3 normal;
+    float d;
+} CullPlane;
+
+// Near, far, left, right, top and bottom planes of a camera, normals pointing inwards
+typedef struct {
+    CullPlane planes[6];
+} ChunkFrustum;
+
+typedef struct {
+    int chunks_total;
+    int chunks_visible;
+    int columns_total;
+    int columns_culled;          // Whole vertical stacks rejected by one test
+    int chunks_column_culled;    // Chunks inside those columns
+    int chunks_frustum_culled;   // Rejected one by one, in a column that passed
+    int chunks_distance_culled;  // In the frustum but farther than max_distance
+    int chunks_occlusion_culled; // In view but walled off from the camera (cave culling)
+} ChunkCullStats;
+
+// Build the frustum of a camera at `position` looking along `forward`. half_vert_tan and
+// half_horiz_tan are tan(fov / 2) per axis; near_dist and far_dist bound the depth.
+void chunk_frustum_from_camera(ChunkFrustum *frustum, Vector3 position, Vector3 forward, Vector3 up,
+                               float half_vert_tan, float half_horiz_tan, float near_dist, float far_dist);
+
+// True unless the box is completely outside one of the planes (conservative)
+bool chunk_frustum_test_aabb(const ChunkFrustum *frustum, Vector3 box_min, Vector3 box_max);
+
+// Write the chunks of `chunks` that can be seen into `out_visible` (room for `count`)
+// and return how many. Chunks are grouped into (chunk_x, chunk_z) columns; each column's
+// bounding box is tested first so a stack outside the frustum costs one test. Survivors
+// are tested per chunk and dropped when their closest point is beyond max_distance.
+// Positions are relative to camera_offset, like the frustum. `stats` may be NULL.
+int chunk_cull(const ChunkFrustum *frustum, Chunk *const *chunks, int count, Vector3 camera_offset,
+               Vector3 camera_position, float max_distance, Chunk **out_visible, ChunkCullStats *stats);
+
+// Cave culling: keep only the chunks of `visible` that a walk from the camera's chunk can
+// reach through Chunk.visibility, entering each chunk through one face and leaving through
+// a connected one, never reversing along an axis and never leaving the frustum. `chunks` is
+// every loaded chunk; gaps between them are treated as open air. Scratch memory comes from
+// `arena`. Returns the new visible count and updates `stats` (may be NULL).
+int chunk_cull_occlusion(const ChunkFrustum *frustum, Chunk *const *chunks, int count, Vector3 camera_offset,
+                         Vector3 camera_position, Chunk **visible, int visible_count, FrameArena *arena,
+                         ChunkCullStats *stats);
+
+// Pick the detail level(s) to draw a chunk at, from the distance between the camera and the
+// chunk's closest point. Writes one draw covering every pixel, or two with complementary
+// dither ranges while the chunk fades into the next coarser level; returns how many.
+int chunk_lod_select(const Chunk *chunk, Vector3 camera_offset, Vector3 camera_position, float render_distance,
+                     ChunkLodDraw out[2]);
+
+#endif
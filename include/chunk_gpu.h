@@ -0,0 +1,90 @@
+#ifndef CHUNK_GPU_H
+#define CHUNK_GPU_H
+
+#include "raylib.h"
+#include "world.h"
+
+// Distance of one glass quad to the camera, for back to front sorting
+typedef struct {
+    float dist_sq;
+    int quad;
+} ChunkGlassKey;
+
+// A chunk's baked vertices, resident in a GPU vertex buffer
+typedef struct {
+    uint32_t generation;   // Chunk.generation this entry was uploaded for, 0 when unused
+    uint32_t mesh_version; // Chunk.mesh_version last uploaded, 0 before the first upload
+    unsigned int vao_id;   // 0 when vertex arrays are unsupported, attributes are then bound per draw
+    unsigned int vbo_id;
+    int vertex_count;
+    ChunkMeshRange ranges[CHUNK_LOD_LEVELS * CHUNK_MESH_LAYER_COUNT];
+    int range_count;
+    int lod_ranges[CHUNK_LOD_LEVELS + 1]; // Ranges of each detail level, see MergedMesh
+    bool has_transparent;
+    // Full resolution transparent span [glass_first, glass_first + glass_count): meshed order
+    // followed by the copy last uploaded, sorted back to front from glass_sort_cell
+    ChunkVertex *glass_vertices;
+    ChunkGlassKey *glass_keys;
+    int glass_first;
+    int glass_count;
+    int glass_sort_cell[3]; // Chunk-local block the camera was in at the last sort
+    bool glass_sorted;
+    bool glass_sorted_whole; // Sorted as one span rather than per texture range
+} ChunkGpuMesh;
+
+// Detail level of a chunk to draw. While two levels cross-fade each covers a complementary
+// share of the pixels: those whose screen-space dither threshold lies in [dither_min, dither_max).
+typedef struct {
+    int level;        // 0 = full resolution, up to CHUNK_LOD_LEVELS - 1
+    float dither_min; // 0 and 1 cover every pixel
+    float dither_max;
+} ChunkLodDraw;
+
+// GPU meshes for every live chunk, indexed by Chunk.pool_index. Render thread only.
+typedef struct {
+    ChunkGpuMesh *meshes;
+    int capacity;
+    Shader atlas_shader;          // Samples the block atlas per vertex layer, id 0 if unavailable
+    int layer_loc;                // vertexLayer attribute, -1 without the atlas shader
+    int layer_rects_loc;          // Uniform locations in atlas_shader
+    int layer_colors_loc;
+    int fog_color_loc;
+    int fog_range_loc;
+    int view_offset_loc;
+    int dither_range_loc;
+    unsigned int tables_atlas_id; // Atlas texture whose layer tables are loaded in atlas_shader
+    Vector3 camera_position;      // This frame's camera and fog, see chunk_gpu_begin_frame
+    float fog_start;
+    float fog_end;
+} ChunkGpuCache;
+
+void chunk_gpu_init(ChunkGpuCache *cache);
+void chunk_gpu_shutdown(ChunkGpuCache *cache);
+
+// Set the camera position (in the same shifted space as draws) and the distances over which
+// untextured layers fade into the sky color. Call once per frame before drawing chunks.
+void chunk_gpu_begin_frame(ChunkGpuCache *cache, Vector3 camera_position, float fog_start, float fog_end);
+
+// Upload the chunk's active merged mesh if it changed since the last call. Takes
+// chunk->mesh_swap_mutex only for that upload. Returns NULL when there is nothing to draw.
+ChunkGpuMesh *chunk_gpu_sync(ChunkGpuCache *cache, Chunk *chunk);
+
+// Entry for a chunk previously returned by chunk_gpu_sync
+ChunkGpuMesh *chunk_gpu_get(ChunkGpuCache *cache, const Chunk *chunk);
+
+// Release buffers of chunks that are no longer live. Call with world->cache_mutex held.
+void chunk_gpu_collect(ChunkGpuCache *cache, ChunkCache *chunks);
+
+// Blend state of the transparent pass, set once around all transparent chunk draws:
+// alpha blending without depth writes
+void chunk_gpu_begin_transparent(void);
+void chunk_gpu_end_transparent(void);
+
+// Draw the opaque or the transparent ranges of one detail level of a chunk, in one draw call
+// with the block atlas. Draw transparent ranges after all opaque ones, chunks back to front,
+// between chunk_gpu_begin_transparent and chunk_gpu_end_transparent; their quads are re-sorted
+// back to front whenever the camera has entered another block. Returns the number of vertices drawn.
+int chunk_gpu_draw(ChunkGpuCache *cache, ChunkGpuMesh *mesh, const Chunk *chunk, World *world,
+                   Vector3 camera_offset, ChunkLodDraw lod, bool transparent, bool show_wireframe);
+
+#endif
@@ -0,0 +1,18 @@
+#ifndef SERVER_CHECKS_H
+#define SERVER_CHECKS_H
+
+// Self-checks and benchmarks the server binary runs instead of serving a world
+// (see src/server/checks.c). Those that take a world name work on that world.
+// Each returns the process exit code: 0 when every check passed.
+int server_bench_noise(int chunks);                             // --noise-bench [chunks]
+int server_bench_hash(int slots);                               // --hash-bench [slots]
+int server_bench_mesh(const char *world_name, int passes);      // --mesh-bench [passes]
+int server_check_mesh(const char *world_name);                  // --mesh-check
+int server_check_raycast(const char *world_name);               // --raycast-check
+int server_check_region(const char *world_name);                // --region-check (world must not exist yet)
+int server_bench_load(const char *world_name, int passes);      // --load-bench [passes]
+int server_bench_load_storm(const char *world_name, int jumps); // --load-storm [jumps]
+int server_check_save(const char *world_name);                  // --save-check
+int server_check_smoke(const char *world_name);                 // --smoke
+
+#endif
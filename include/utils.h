@@ -3,6 +3,7 @@
 
 #include <stdbool.h>
 #include <stddef.h>
+#include <stdio.h>
 
 int get_process_memory_mb(void);
 void get_cpu_model(char *buffer, size_t size);
@@ -10,6 +11,23 @@ void get_gpu_model(char *buffer, size_t size);
 void get_kernel_info(char *buffer, size_t size);
 bool get_chat_history_line(int lines_back, char *out_line, size_t max_len);
 void trim_string(char *str);
+bool options_read_line(FILE *file, char *line, size_t size, char **key, char **value); // Next key=value line of options.conf
+
+// Per-frame bump allocator: everything allocated in a frame is released at once by
+// frame_arena_reset. Allocations that do not fit fall back to the heap for that frame
+// and the block grows at the next reset, so steady-state frames never touch the heap.
+typedef struct FrameArenaOverflow FrameArenaOverflow;
+typedef struct {
+    unsigned char *base;
+    size_t capacity;
+    size_t used;
+    size_t overflow_bytes;        // Bytes requested this frame that did not fit in base
+    FrameArenaOverflow *overflow; // Heap blocks handed out this frame, freed on reset
+} FrameArena;
+
+void *frame_arena_alloc(FrameArena *arena, size_t size);
+void frame_arena_reset(FrameArena *arena);
+void frame_arena_free(FrameArena *arena);
 
 #define B3DV_MAIN_LOOP
 #define UNIMPLEMENTED
@@ -5,7 +5,9 @@
 #include "utils.h"
 #include <pthread.h>
 #include <stdbool.h>
+#include <stddef.h>
 #include <stdint.h>
+#include <time.h>
 
 // Forward declare Player so World can reference the active player without including player.h
 struct Player;
@@ -68,25 +70,54 @@ static inline bool block_face_is_exposed(BlockType current, BlockType neighbor)
     return false;
 }
 
-// Cached visible block entry for mesh caching
+// Merged quad from greedy meshing, represents a rectangular face region.
+// (x, y, z) is the minimum-corner block of the region; the quad lies on that
+// block's `face` side. w and h run along the face's in-plane axes:
+//   +X/-X (0/1): w along z, h along y
+//   +Y/-Y (2/3): w along x, h along z
+//   +Z/-Z (4/5): w along x, h along y
 typedef struct {
-    int x, y, z;           // Local chunk coordinates
-    uint8_t exposed_faces; // Bitmask of which faces are exposed (bits 0-5 = faces 0-5)
-} CachedVisibleBlock;
-
-// Merged quad from greedy meshing, represents a rectangular face region
-typedef struct {
-    int x, y, z;    // World position of one corner of the quad
+    int x, y, z;    // World position of the minimum-corner block
     int w, h;       // Width and height in blocks
     int face;       // Face direction (0-5)
     BlockType type; // Block type (for color/texture)
 } MergedQuad;
 
+// Packed chunk vertex, ready to upload to a GPU vertex buffer (see chunk_vertices.c)
+typedef struct {
+    uint8_t x, y, z;  // Chunk-local corner position, 0..CHUNK_HEIGHT
+    uint8_t layer;    // Texture layer, block type * 3 + BlockFace (see chunk_mesh_layer)
+    uint8_t u, v;     // Texture coordinates in blocks, the texture repeats every 1.0
+    uint8_t pad[2];   // Keeps color 4-byte aligned
+    uint8_t color[4]; // Face shading in rgb, alpha 255
+} ChunkVertex;
+
+// Number of distinct texture layers a chunk mesh can use
+#define CHUNK_MESH_LAYER_COUNT ((BLOCK_GLASS + 1) * 3)
+
+// Run of vertices sharing one texture layer, drawn with a single draw call
+typedef struct {
+    uint8_t layer;
+    bool transparent; // Drawn after all opaque ranges, with blending
+    int first_vertex;
+    int vertex_count;
+} ChunkMeshRange;
+
+// Detail levels baked per chunk: full resolution, then 2x, 4x and 8x downsampled voxels
+#define CHUNK_LOD_LEVELS 4
+
 // Chunk mesh data, holds merged quads per face direction
 typedef struct {
     MergedQuad *quads[6]; // Merged quads for each face direction
     int quad_count[6];    // Number of quads per face
     int quad_capacity[6]; // Allocated capacity per face
+    // Triangle list baked from the quads of every detail level, level after level; within a
+    // level grouped by layer, opaque ranges first
+    ChunkVertex *vertices;
+    int vertex_count;
+    ChunkMeshRange ranges[CHUNK_LOD_LEVELS * CHUNK_MESH_LAYER_COUNT];
+    int range_count;
+    int lod_ranges[CHUNK_LOD_LEVELS + 1]; // Level l owns ranges [lod_ranges[l], lod_ranges[l + 1])
 } MergedMesh;
 
 // Chunk system for infinite worlds
@@ -94,6 +125,11 @@ typedef struct {
 #define CHUNK_HEIGHT 64
 #define CHUNK_DEPTH 32
 
+// Region files group chunks on disk (see region_file.c)
+#define REGION_WIDTH 16  // Chunks along x and z
+#define REGION_HEIGHT 4  // Chunks along y
+#define REGION_SECTOR_SIZE 4096
+
 // World height limits - prevents unloaded chunk light leaks
 #define WORLD_Y_MIN 0
 #define WORLD_Y_MAX 500
@@ -110,6 +146,41 @@ typedef enum {
     BLOCK_FACE_BOTTOM
 } BlockFace;
 
+// Texture group of a face direction (0-5, see MergedQuad)
+static inline BlockFace block_face_group(int face) {
+    switch (face) {
+    case 2: // +Y top
+        return BLOCK_FACE_TOP;
+    case 3: // -Y bottom
+        return BLOCK_FACE_BOTTOM;
+    default:
+        return BLOCK_FACE_SIDE;
+    }
+}
+
+// Texture layer of a block type's face group, indexes ChunkVertex.layer
+static inline uint8_t chunk_mesh_layer(BlockType type, BlockFace group) {
+    return (uint8_t)(type * 3 + group);
+}
+
+// Chunk visibility graph: one bit per unordered pair of face directions (0-5, see
+// MergedQuad), set when air or glass connects the two faces through the chunk
+#define CHUNK_VISIBILITY_ALL 0x7FFF
+
+static inline uint16_t chunk_visibility_bit(int face_a, int face_b) {
+    int a = face_a < face_b ? face_a : face_b;
+    int b = face_a < face_b ? face_b : face_a;
+    return (uint16_t)(1u << (a * 5 - a * (a - 1) / 2 + (b - a - 1)));
+}
+
+static inline bool chunk_visibility_connected(uint16_t visibility, int face_a, int face_b) {
+    return face_a != face_b && (visibility & chunk_visibility_bit(face_a, face_b)) != 0;
+}
+
+// Per face direction shading and texture coordinates shared by the renderers (chunk_vertices.c)
+extern const float block_face_shading[6];
+extern const Vector2 block_face_uv[6][4];
+
 // A block's three textures: top, side, and bottom faces
 typedef struct {
     Texture2D top;
@@ -117,15 +188,54 @@ typedef struct {
     Texture2D bottom;
 } BlockTextureSet;
 
+// Source image for one atlas tile, RGBA pixels
+typedef struct {
+    const Color *pixels;
+    int width;
+    int height;
+} BlockAtlasImage;
+
+// All block face textures packed into one grid of bordered square tiles (see block_atlas.c)
+typedef struct {
+    Color *pixels;     // RGBA atlas image, NULL once uploaded
+    int width, height; // Atlas size in pixels, tile borders included
+    int tile_size;     // Tile edge in pixels
+    int tile_count;
+    float layer_rects[CHUNK_MESH_LAYER_COUNT][4]; // Normalized x, y, width, height per texture layer, all 0 when untextured
+} BlockAtlas;
+
 // Texture cache for block types - one BlockTextureSet per BlockType
 typedef struct {
     BlockTextureSet sets[BLOCK_GLASS + 1];
+    BlockAtlas atlas;        // Tile rectangles of every set, by texture layer
+    Texture2D atlas_texture; // GPU copy of the atlas, id 0 if it could not be built
     bool textures_loaded;
 } TextureCache;
 
-// Chunk structure - a 32x64x32 section of the world
+// Chunk block storage is split into 32x16x32 sections
+#define CHUNK_SECTION_HEIGHT 16
+#define CHUNK_SECTION_COUNT (CHUNK_HEIGHT / CHUNK_SECTION_HEIGHT)
+#define CHUNK_SECTION_VOLUME (CHUNK_WIDTH * CHUNK_SECTION_HEIGHT * CHUNK_DEPTH)
+
+// Palette plus bit-packed palette indices for one section (see chunk_storage.c)
+typedef struct ChunkSectionData {
+    struct ChunkSectionData *retired_next; // Link in the owning section's retired list
+    uint16_t palette_count;
+    uint8_t bits;         // Bits per block index: 1, 2, 4 or 8
+    uint8_t palette[256]; // Palette index -> BlockType
+    uint64_t words[];     // CHUNK_SECTION_VOLUME indices, packed
+} ChunkSectionData;
+
+// One section of a chunk. NULL data means every block is single_value.
 typedef struct {
-    Block blocks[CHUNK_HEIGHT][CHUNK_DEPTH][CHUNK_WIDTH];
+    ChunkSectionData *data;
+    ChunkSectionData *retired; // Replaced buffers readers may still hold, freed on release
+    uint8_t single_value;
+} ChunkSection;
+
+// Chunk structure - a 32x64x32 section of the world
+typedef struct Chunk {
+    ChunkSection sections[CHUNK_SECTION_COUNT]; // Palette-compressed blocks, use world_chunk_get/set_block
 
     int32_t chunk_x; // Chunk coordinates
     int32_t chunk_y;
@@ -133,44 +243,128 @@ typedef struct {
     bool loaded;               // Whether this chunk is currently in memory
     bool generated;            // Whether terrain has been generated
     bool modified;             // Whether this chunk has unsaved changes
-    bool meshed;               // Whether visible blocks have been cached
+    bool meshed;               // Whether the mesh has been built
     bool pending_save;         // Whether this chunk is queued to be saved asynchronously
     bool pending_unload;       // Whether this chunk is scheduled for unload after save completes
+    bool pending_generate;     // Whether terrain is being loaded or generated off the main thread (chunk stays hidden until published)
+    bool read_only;            // Stored record is in a method this build can't decode: shows generated terrain, never edited or saved
     volatile int in_use_count; // Worker jobs currently processing this chunk
-    // Double-buffered mesh: two buffers so render thread always has valid data
-    CachedVisibleBlock *visible_blocks[2]; // Pre-computed list of blocks with exposed faces (ping-pong buffers)
-    int visible_count[2];                  // Number of blocks in each buffer
-    int visible_capacity[2];               // Allocated capacity for each buffer
-    volatile int active_mesh;              // Index of which buffer is currently being rendered (0 or 1), volatile for inter-thread visibility
-    // Greedy meshed geometry - merged quads instead of individual blocks
+    // Greedy meshed geometry, double-buffered so the render thread always has valid data
     MergedMesh *merged_mesh[2];      // Double-buffered merged quads (0 or 1)
     volatile int active_merged_mesh; // Which merged mesh buffer is active
+    uint32_t mesh_version;           // Bumped (release) after every merged mesh swap, 0 until the first one
+    uint16_t visibility;             // Face pairs connected through see-through blocks, swapped in with the mesh
+    bool visibility_dirty;           // Blocks changed opacity since `visibility` was computed
     pthread_mutex_t mesh_swap_mutex; // Protects mesh swap to ensure atomicity
     pthread_mutex_t mutex;           // Protects this chunk during worker processing
+    // Pool bookkeeping (see chunk_pool.c), owned by the cache
+    uint32_t pool_index; // Slot index: slab * CHUNK_SLAB_SIZE + slot
+    uint32_t generation; // Unique per allocation while live, 0 once freed
+    int32_t live_index;  // Position in ChunkCache.live, -1 once retired
+    struct Chunk *retired_next; // Link in ChunkCache.retired while lock-free readers drain
+    uint32_t retired_epoch;     // Read epoch at which the chunk left the hash table
 } Chunk;
 
+// Chunks are allocated from fixed-size slabs so their addresses never change
+#define CHUNK_SLAB_SHIFT 6
+#define CHUNK_SLAB_SIZE (1 << CHUNK_SLAB_SHIFT)
+
+// Weak reference to a pooled chunk. Resolves to NULL once the chunk is freed,
+// even if its slot has been reused for another chunk since.
+typedef struct {
+    uint32_t index;
+    uint32_t generation; // 0 is never a live generation
+} ChunkHandle;
+
+// Open region file (defined in region_file.c)
+typedef struct RegionFile RegionFile;
+
+// A stored chunk record, read in place from its region file's mapping
+typedef struct {
+    const uint8_t *data;
+    size_t size;
+    RegionFile *region; // Kept open until region_unmap_chunk, NULL for a copied record
+    uint8_t *copy;      // Heap copy when the file could not be mapped
+} RegionChunkView;
+
+// Where a stored chunk record lies in its region file, for reads issued without stdio
+typedef struct {
+    int fd;          // The region file's descriptor
+    uint64_t offset; // Of the record, in bytes
+    size_t size;
+    RegionFile *region; // Kept open until region_unref_chunk
+} RegionChunkRef;
+
+// One chunk record for region_write_batch
+typedef struct {
+    int32_t chunk_x;
+    int32_t chunk_y;
+    int32_t chunk_z;
+    const uint8_t *data;
+    size_t size;
+    bool written; // Set by region_write_batch once the record is stored
+} RegionWrite;
+
+typedef struct {
+    Chunk chunks[CHUNK_SLAB_SIZE];
+    uint16_t free_slots[CHUNK_SLAB_SIZE]; // Stack of free slot numbers
+    int free_count;
+    uint64_t free_mask;    // Bit per free slot
+    uint64_t purged_slots; // Free slots whose mutexes were destroyed to hand their pages back
+    uint64_t purged_pages; // Pages handed back to the OS, bit per page from the slab start
+} ChunkSlab;
+
 // Hash table entry for chunk lookup (Issue #1: spatial hash for chunk lookup)
+#define CHUNK_HASH_MAX_LOAD 0.75f // The table doubles once an insert would fill it past this
 typedef struct {
     int32_t chunk_x;
     int32_t chunk_y;
     int32_t chunk_z;
-    Chunk *chunk;
+    uint32_t hash; // Cached chunk_hash_func result, gives the probe distance without rehashing
+    Chunk *chunk;  // NULL marks an empty slot
 } ChunkHashEntry;
 
+// Lock-free readers register in one of these per-thread counters, one count per
+// epoch parity. Padded to a cache line so threads don't contend on the counts.
+#define CHUNK_READER_SLOTS 16
+typedef struct {
+    int count[2];
+    char pad[64 - 2 * sizeof(int)];
+} ChunkReaderSlot;
+
+// Memory unlinked from the hash table, freed once readers from its epoch are gone
+typedef struct {
+    void *ptr;
+    uint32_t epoch;
+} ChunkDeferredFree;
+
 // Chunk cache - stores loaded chunks with spatial hash for O(1) lookup
 typedef struct {
-    Chunk *chunks;
-    int chunk_count;
-    int chunk_capacity;
+    ChunkSlab **slabs; // Slab pages; NULL entries have been released
+    int slab_count;    // Length of the slabs array
+    int spare_slab;    // Empty slab kept around to avoid map/unmap churn, -1 if none
+    Chunk **live;      // Dense list of live chunks, for iteration
+    int chunk_count;   // Number of live chunks
+    int live_capacity;
+    uint32_t next_generation;
     // Hash table for O(1) chunk lookup by coordinates (Issue #1)
     ChunkHashEntry *hash_table;
-    int hash_capacity;
+    int hash_capacity; // Always a power of two
+    int hash_count;
+    uint32_t hash_seq; // Seqlock for lock-free lookups: odd while the table is being written
+    // Deferred reclamation for lock-free readers (see chunk_pool.c)
+    uint32_t read_epoch;
+    ChunkReaderSlot readers[CHUNK_READER_SLOTS];
+    Chunk *retired;                // Unloaded chunks whose storage is not yet released
+    ChunkDeferredFree *deferred;   // Replaced hash tables and similar
+    int deferred_count;
+    int deferred_capacity;
 } ChunkCache;
 
 // Worker job types.
 typedef enum {
-    WORKER_JOB_MESH,      // Rebuild mesh for a chunk
-    WORKER_JOB_SAVE_CHUNK // Save chunk to disk (async)
+    WORKER_JOB_MESH,    // Rebuild mesh for a chunk
+    WORKER_JOB_GENERATE // Generate terrain into a detached buffer, then publish it
 } WorkerJobType;
 
 // Worker job - stores chunk coordinates and job type to avoid pointer invalidation
@@ -181,17 +375,155 @@ typedef struct {
     WorkerJobType type;
 } WorkerJob;
 
-// Worker thread job queue
+// Upper bound on worker pool size
+#define WORKER_MAX_THREADS 32
+
+// Queued job with its scheduling priority (lower runs first)
 typedef struct {
-    WorkerJob *queue; // Array of chunk coordinates, not pointers
+    WorkerJob job;
+    float priority;    // Distance to the interest point, weighted by view angle
+    uint32_t sequence; // Submission order, breaks priority ties first-in first-out
+} WorkerHeapEntry;
+
+// Binary min-heap of jobs shared by all workers (guarded by the queue mutex)
+typedef struct {
+    WorkerHeapEntry *entries;
     int count;
     int capacity;
-    int jobs_in_progress; // Number of jobs currently being processed by worker
+    uint32_t epoch; // Interest epoch the priorities were computed against
+} WorkerHeap;
+
+// Slot in the queued-job set
+typedef struct {
+    WorkerJob job;
+    bool occupied;
+} WorkerJobSlot;
+
+// Open-addressing set of queued jobs keyed on coordinates + type, for O(1) dedup
+typedef struct {
+    WorkerJobSlot *slots;
+    int count;
+    int capacity; // Always a power of two
+} WorkerJobSet;
+
+// Worker pool settings (options.conf, see world_config_load)
+typedef struct {
+    int thread_count; // 0 means one worker per core (minus the main thread)
+    bool pin_threads; // Pin each worker to its own core
+} WorkerConfig;
+
+// Worker thread pool taking jobs from one shared priority heap
+typedef struct {
+    WorkerHeap heap; // Jobs waiting to run, most urgent first
+    pthread_t *threads;
+    int thread_count;
+    int count;            // Jobs waiting in the heap
+    int jobs_in_progress; // Number of jobs currently being processed by workers
+    WorkerJobSet queued;  // Jobs waiting in the heap (dedup)
+    uint32_t next_sequence;
+    // Where the player is and where they look; mesh jobs near and in front run first
+    Vector3 interest_position;
+    Vector3 interest_forward;
+    uint32_t interest_epoch; // Bumped when queued priorities need recomputing
     pthread_mutex_t mutex;
     pthread_cond_t cond;
     bool shutdown;
 } WorkerQueue;
 
+// When saves wait for the disk (fsync) rather than just handing data to the OS
+typedef enum {
+    SAVE_FSYNC_NEVER,  // Fastest; a power loss can lose recently saved chunks
+    SAVE_FSYNC_BATCH,  // Once per region file per batch of saved chunks
+    SAVE_FSYNC_ALWAYS  // After every chunk
+} SaveFsyncMode;
+
+#define SAVE_QUEUE_DEFAULT_AUTOSAVE 120 // Seconds
+
+// Save settings (options.conf, see world_config_load)
+typedef struct {
+    SaveFsyncMode fsync_mode;
+    int autosave_interval; // Seconds between autosaves of modified chunks, 0 disables
+} SaveConfig;
+
+// Chunks waiting to be written by the save thread. A chunk is queued at most
+// once (Chunk.pending_save); saving it again before the write only updates
+// what the single write will contain.
+typedef struct {
+    ChunkHandle *pending; // Ring buffer, oldest at `head`
+    int head;
+    int count;
+    int capacity; // Zero or a power of two
+    bool busy;          // The save thread is writing a batch
+    bool shutdown;
+    bool running;
+    SaveConfig config;
+    time_t next_autosave; // Main thread only
+    pthread_t thread;
+    pthread_mutex_t mutex;
+    pthread_cond_t cond;      // Chunks were queued, or shutdown
+    pthread_cond_t idle_cond; // A batch finished
+} SaveQueue;
+
+// Which engine reads chunk records for world_update_chunks (see chunk_io.c)
+typedef enum {
+    CHUNK_IO_AUTO,    // io_uring where the kernel supports it, threads otherwise
+    CHUNK_IO_URING,   // Linux io_uring: a whole batch of reads in one submission
+    CHUNK_IO_THREADS, // A few threads doing blocking reads
+    CHUNK_IO_SYNC     // No engine: the main thread reads chunks as it creates them
+} ChunkIoBackend;
+
+// Chunk read settings (options.conf, see world_config_load)
+typedef struct {
+    ChunkIoBackend backend;
+    int thread_count; // Reader threads for CHUNK_IO_THREADS
+} ChunkIoConfig;
+
+#define CHUNK_IO_DEFAULT_THREADS 2
+#define CHUNK_IO_MAX_THREADS 8
+
+// Engine settings kept in options.conf next to the client's own. world_create
+// reads them once and hands each part to its subsystem; the menu writes them
+// back unchanged when it saves options.conf.
+typedef struct {
+    WorkerConfig worker;
+    SaveConfig save;
+    ChunkIoConfig chunk_io;
+} WorldConfig;
+
+// io_uring state (defined in chunk_io.c)
+typedef struct ChunkIoRing ChunkIoRing;
+
+// A queued chunk read, ordered like worker jobs (worker_chunk_priority)
+typedef struct {
+    ChunkHandle handle;
+    int32_t chunk_x;
+    int32_t chunk_y;
+    int32_t chunk_z;
+    float priority;    // Lower reads first
+    uint32_t sequence; // Breaks ties in request order
+} ChunkIoRequest;
+
+// Chunks waiting to be read from disk. Each is a pending (hidden) chunk that the
+// engine publishes once its record is decoded, or hands to a worker to generate.
+typedef struct {
+    ChunkIoRequest *pending; // Binary min-heap, most urgent read first
+    int count;
+    int capacity;
+    uint32_t next_sequence;
+    uint32_t epoch;  // Worker interest epoch the priorities were computed against
+    int in_progress; // Requests taken off the queue but not yet finished
+    bool shutdown;
+    bool running;
+    ChunkIoConfig config;
+    ChunkIoBackend backend; // The one in use; never CHUNK_IO_AUTO
+    ChunkIoRing *ring;      // NULL unless backend is CHUNK_IO_URING
+    pthread_t threads[CHUNK_IO_MAX_THREADS];
+    int thread_count;
+    pthread_mutex_t mutex;
+    pthread_cond_t cond;      // Requests were queued, or shutdown
+    pthread_cond_t idle_cond; // Requests finished
+} ChunkIo;
+
 // World structure - infinite world with chunk-based loading
 typedef struct {
     ChunkCache chunk_cache;
@@ -205,16 +537,26 @@ typedef struct {
     Vector3 last_chunk_update_forward;  // Last camera forward used for chunk load/unload updates
     uint64_t seed;                      // World seed for reproducible terrain generation
     bool compress_chunk_files;          // Whether this world's chunk files should be compressed
-    WorkerQueue worker_queue;           // Queue of chunks to process
-    pthread_t worker_thread;            // Worker thread handle
-    bool worker_running;                // Whether worker thread is active
-    pthread_mutex_t cache_mutex;        // Protects chunk_cache array from realloc while worker accesses it
+    bool legacy_chunk_files;            // Some per-chunk files could not be moved into region files
+    WorkerQueue worker_queue;           // Worker pool and its job heap
+    SaveQueue save_queue;               // Chunks waiting for the save thread
+    ChunkIo chunk_io;                   // Chunks waiting to be read from disk
+    bool worker_running;                // Whether worker threads are active
+    pthread_mutex_t cache_mutex;        // Protects chunk_cache lookups and slot reuse while workers access chunks
     // Pointer to the active player when in-game (used for saving player data)
     void *current_player;
     // Cached player nickname (from players.toml); used for chat display
     char player_nickname[64];
 } World;
 
+// First non-air block along a ray, see world_raycast
+typedef struct {
+    int x, y, z;                      // Block hit
+    int normal_x, normal_y, normal_z; // Face the ray entered through, all 0 if it started inside the block
+    float distance;                   // Along the ray to where it enters the block
+    BlockType type;
+} WorldRayHit;
+
 // Function declarations
 
 // Create a new world
@@ -231,6 +573,8 @@ Texture2D world_get_block_face_texture(World *world, BlockType type, BlockFace f
 
 void world_load_textures(World *world);
 void world_unload_textures(World *world);
+bool block_atlas_build(BlockAtlas *atlas, const BlockAtlasImage *layer_images[CHUNK_MESH_LAYER_COUNT]);
+void block_atlas_free_pixels(BlockAtlas *atlas);
 void world_generate_prism(World *world);
 void world_system_init(void);
 bool world_save(World *world, const char *world_name);
@@ -238,20 +582,75 @@ bool world_load(World *world, const char *world_name);
 bool world_save_chunk(Chunk *chunk, const char *world_name, bool allow_compression); // Save a single chunk to disk
 void world_update_chunks(World *world, Vector3 player_pos, Vector3 camera_forward, float render_distance_blocks);
 Chunk *world_get_chunk(World *world, int32_t chunk_x, int32_t chunk_y, int32_t chunk_z);
-void world_set_block(World *world, int x, int y, int z, BlockType type);
+bool world_set_block(World *world, int x, int y, int z, BlockType type); // False (nothing changed) while the chunk has no terrain yet, or is read-only
 BlockType world_get_block(World *world, int x, int y, int z);
+BlockType world_get_block_or_solid(World *world, int x, int y, int z); // Absent or pending chunks read as solid (collision)
+bool world_raycast(World *world, Vector3 origin, Vector3 direction, float max_distance, WorldRayHit *hit); // direction normalized
 void world_chunk_set_block(Chunk *chunk, int x, int y, int z, BlockType type);
 BlockType world_chunk_get_block(Chunk *chunk, int x, int y, int z);
+void chunk_storage_init(Chunk *chunk);                                              // Reset storage to all air (no frees)
+void chunk_storage_release(Chunk *chunk);                                           // Free block storage and reset to all air
+void chunk_storage_fill(Chunk *chunk, Block (*blocks)[CHUNK_DEPTH][CHUNK_WIDTH]); // Replace contents from a dense block array
+void chunk_storage_fill_types(Chunk *chunk, const uint8_t *types);                 // Same, from one type byte per block in y, z, x order
+void chunk_storage_read_types(const Chunk *chunk, uint8_t *types);                 // Decode all blocks to that layout
+size_t chunk_storage_bytes(const Chunk *chunk);                                     // Heap bytes used by block storage
+void chunk_storage_read_row(const Chunk *chunk, int y, int z, uint8_t out[CHUNK_WIDTH]); // Decode one x row
+void chunk_pool_init(ChunkCache *cache);                                            // Empty pool, no slabs mapped yet
+Chunk *chunk_pool_alloc(ChunkCache *cache);                                         // Claim a slot (not yet hashed), NULL on OOM
+void chunk_pool_retire(ChunkCache *cache, Chunk *chunk);                            // Unhashed chunk: release storage and slot after readers drain
+void chunk_pool_defer_free(ChunkCache *cache, void *ptr);                           // free() once current readers are gone
+void chunk_pool_reclaim(ChunkCache *cache);                                         // Advance the read epoch and free what is safe
+int chunk_read_begin(ChunkCache *cache);                                            // Enter a lock-free read section, returns a token
+void chunk_read_end(ChunkCache *cache, int token);                                  // Leave the read section
+void chunk_pool_destroy(ChunkCache *cache);                                         // Unmap all slabs
+ChunkHandle chunk_pool_handle(const Chunk *chunk);                                  // Weak reference to a live chunk
+Chunk *chunk_pool_resolve(ChunkCache *cache, ChunkHandle handle);                   // NULL if the chunk was freed since
+size_t chunk_pool_reserved_bytes(const ChunkCache *cache);                          // Slab bytes still backed by memory
+bool chunk_hash_init(ChunkCache *cache, int capacity);                              // Empty table, capacity a power of two; false on OOM
+void chunk_hash_destroy(ChunkCache *cache);                                         // Free the table (after chunk_pool_destroy)
+void chunk_hash_insert(ChunkCache *cache, int32_t chunk_x, int32_t chunk_y, int32_t chunk_z, Chunk *chunk); // Replaces an entry at the same coordinates
+void chunk_hash_remove(ChunkCache *cache, int32_t chunk_x, int32_t chunk_y, int32_t chunk_z);               // No-op if absent
+Chunk *chunk_hash_lookup(ChunkCache *cache, int32_t chunk_x, int32_t chunk_y, int32_t chunk_z);             // NULL if absent; serialized with writers
+bool region_map_chunk(const char *world_name, int32_t chunk_x, int32_t chunk_y, int32_t chunk_z,
+                      RegionChunkView *view);         // Chunk record in place, false if not stored
+void region_unmap_chunk(RegionChunkView *view);       // Done with a record from region_map_chunk
+bool region_ref_chunk(const char *world_name, int32_t chunk_x, int32_t chunk_y, int32_t chunk_z,
+                      RegionChunkRef *ref);           // Locate a chunk record for the caller to read, false if not stored
+void region_unref_chunk(RegionChunkRef *ref);         // Done with a record from region_ref_chunk
+bool region_write_chunk(const char *world_name, int32_t chunk_x, int32_t chunk_y, int32_t chunk_z,
+                        const uint8_t *data, size_t size);    // Store a chunk record, replacing the old one
+int region_write_batch(const char *world_name, RegionWrite *writes, int count, bool sync); // Store records, returns how many were written
+int region_migrate_chunk_files(const char *world_name, int *out_failed); // Move per-chunk files into regions
+void region_close_all(void);                                            // Close every open region file
 void world_generate_chunk(Chunk *chunk, uint64_t seed);
+void world_generate_chunk_blocks(Block (*blocks)[CHUNK_DEPTH][CHUNK_WIDTH], int32_t chunk_x, int32_t chunk_y, int32_t chunk_z, uint64_t seed);
+void world_generate_chunk_blocks_reference(Block (*blocks)[CHUNK_DEPTH][CHUNK_WIDTH], int32_t chunk_x, int32_t chunk_y, int32_t chunk_z, uint64_t seed); // Same, via the per-sample noise path (for --noise-bench)
 Chunk *world_load_or_create_chunk(World *world, int32_t chunk_x, int32_t chunk_y, int32_t chunk_z);
-void chunk_cache_visible_blocks(Chunk *chunk, World *world);                                                            // Pre-compute list of visible blocks
-void chunk_update_visible_blocks_region(Chunk *chunk, World *world, int local_x, int local_y, int local_z, int radius); // (Issue #2) Update only affected region
-void chunk_free_visible_blocks(Chunk *chunk);                                                                           // Clean up visible blocks cache
+void chunk_build_mesh(Chunk *chunk, World *world);                                                                      // Snapshot, greedy-mesh and bake a chunk, then swap the mesh in
+void chunk_free_merged_mesh(Chunk *chunk);                                                                              // Clean up merged mesh only
+bool chunk_mesh_build_vertices(MergedMesh *mesh, const Chunk *chunk, MergedMesh *const *lods);                        // Bake merged quads (and CHUNK_LOD_LEVELS - 1 coarser levels, entries may be NULL) into mesh->vertices
 void worker_queue_chunk(World *world, Chunk *chunk);                                                                    // Add chunk to worker queue for lighting/meshing
-void worker_queue_chunk_save(World *world, Chunk *chunk);                                                               // Add chunk to worker queue for saving
+void worker_queue_chunk_generate(World *world, Chunk *chunk);                                                           // Add chunk to worker queue for terrain generation
 void worker_flush_queue(World *world);                                                                                  // Wait for all worker queue jobs to complete
-void worker_shutdown(World *world);                                                                                     // Cleanly shut down worker thread
-void worker_init(World *world);                                                                                         // Initialize worker thread system
+void worker_shutdown(World *world);                                                                                     // Cleanly shut down worker threads
+void world_config_load(WorldConfig *config);                                                                            // Read engine settings from options.conf (defaults if missing)
+void world_config_write(FILE *file, const WorldConfig *config);                                                         // Write engine settings as options.conf lines
+void worker_init(World *world, const WorkerConfig *config);                                                             // Initialize worker thread pool
+void worker_set_interest(World *world, Vector3 position, Vector3 forward);                                              // Update the point jobs are prioritised around
+uint32_t worker_get_interest(World *world, Vector3 *position, Vector3 *forward);                                        // Current interest point, returns its epoch
+float worker_chunk_priority(int32_t chunk_x, int32_t chunk_y, int32_t chunk_z, Vector3 position, Vector3 forward);      // Lower runs first, for jobs and reads alike
+void save_queue_init(World *world, const SaveConfig *config);                                                           // Start the save thread
+void save_queue_shutdown(World *world);                                                                                 // Write queued chunks and stop the save thread
+bool save_queue_chunk(World *world, Chunk *chunk);                                                                      // Queue a chunk to be saved if it is modified (coalesced)
+void save_queue_flush(World *world);                                                                                    // Wait until every queued chunk is written
+void save_queue_autosave(World *world);                                                                                 // Queue modified chunks when the autosave interval is due, never blocks
+void chunk_io_init(World *world, const ChunkIoConfig *config);                                                          // Start the chunk read engine chosen in options.conf
+void chunk_io_shutdown(World *world);                                                                                   // Finish reads in progress, drop queued ones and stop
+void chunk_io_request(World *world, Chunk *chunk);                                                                      // Queue a pending chunk to be read (or generated if not stored)
+void chunk_io_flush(World *world);                                                                                      // Wait until every queued read has finished
+bool worker_publish_chunk_record(World *world, Chunk *chunk, const uint8_t *record, size_t size);                      // Decode a stored record into a pending chunk and show it
+bool chunk_load_record(const uint8_t *record, size_t size, Chunk *chunk, const char **out_error);                      // Decode a stored record into a chunk's storage
+uint8_t *chunk_encode_types(const uint8_t *types, bool allow_compression, size_t *out_size);                            // Chunk record from a block type snapshot, malloc'd
 // Apply saved player data from world players file into a runtime Player instance
 bool world_apply_players_to(World *world, void *player);
 
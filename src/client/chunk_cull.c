@@ -0,0 +1,322 @@
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "raylib.h"
+#include "../../include/chunk_cull.h"
+#include "../../include/vec_math.h"
+
+// ============================================================================
+// CHUNK VISIBILITY CULLING
+// ============================================================================
+// Decides which loaded chunks are worth drawing this frame, before any GPU
+// work: a column pass rejects whole (chunk_x, chunk_z) stacks against the
+// camera frustum, then surviving chunks are tested on their own AABB and on
+// distance. Pure math on chunk coordinates, no GL state, so it can be driven
+// with any camera.
+//
+// Cave culling then walks chunk to chunk from the camera, in the style of
+// Tommaso Checchi's "advanced cave culling": a chunk can only be seen if some
+// path of chunks leads to it whose entry and exit faces are connected by air
+// or glass inside every chunk along the way (the per-chunk visibility graph
+// built by the mesher). The path may never step back against a direction it
+// already took, which keeps it a rough line of sight rather than a maze walk.
+
+// Above this many grid cells the walk is skipped (scattered far-away chunks)
+#define CHUNK_CULL_MAX_GRID_CELLS (1 << 20)
+
+static float cull_dot(Vector3 a, Vector3 b) {
+    return a.x * b.x + a.y * b.y + a.z * b.z;
+}
+
+static CullPlane cull_plane(Vector3 normal, Vector3 point) {
+    normal = vec3_normalize(normal);
+    return (CullPlane){normal, -cull_dot(normal, point)};
+}
+
+void chunk_frustum_from_camera(ChunkFrustum *frustum, Vector3 position, Vector3 forward, Vector3 up,
+                               float half_vert_tan, float half_horiz_tan, float near_dist, float far_dist) {
+    forward = vec3_normalize(forward);
+    Vector3 right = vec3_normalize(vec3_cross(forward, up));
+    if (cull_dot(right, right) == 0.0f) {
+        right = (Vector3){1, 0, 0}; // Looking straight along `up`: any perpendicular will do
+    }
+    Vector3 cam_up = vec3_cross(right, forward);
+
+    frustum->planes[0] = cull_plane(forward, vec3_add(position, vec3_scale(forward, near_dist)));
+    frustum->planes[1] = cull_plane(vec3_scale(forward, -1.0f), vec3_add(position, vec3_scale(forward, far_dist)));
+    // Side planes contain the camera position and one edge of the view; normal = tan * forward -/+ axis
+    frustum->planes[2] = cull_plane(vec3_add(vec3_scale(forward, half_horiz_tan), right), position);
+    frustum->planes[3] = cull_plane(vec3_sub(vec3_scale(forward, half_horiz_tan), right), position);
+    frustum->planes[4] = cull_plane(vec3_sub(vec3_scale(forward, half_vert_tan), cam_up), position);
+    frustum->planes[5] = cull_plane(vec3_add(vec3_scale(forward, half_vert_tan), cam_up), position);
+}
+
+bool chunk_frustum_test_aabb(const ChunkFrustum *frustum, Vector3 box_min, Vector3 box_max) {
+    for (int i = 0; i < 6; i++) {
+        const CullPlane *plane = &frustum->planes[i];
+        // Corner furthest along the normal; if even that is outside, the whole box is
+        Vector3 corner = {
+            plane->normal.x >= 0.0f ? box_max.x : box_min.x,
+            plane->normal.y >= 0.0f ? box_max.y : box_min.y,
+            plane->normal.z >= 0.0f ? box_max.z : box_min.z};
+        if (cull_dot(plane->normal, corner) + plane->d < 0.0f) {
+            return false;
+        }
+    }
+    return true;
+}
+
+// Squared distance from `point` to the closest point of the box
+static float chunk_cull_nearest_dist_sq(Vector3 box_min, Vector3 box_max, Vector3 point) {
+    float near_x = fmaxf(box_min.x, fminf(point.x, box_max.x)) - point.x;
+    float near_y = fmaxf(box_min.y, fminf(point.y, box_max.y)) - point.y;
+    float near_z = fmaxf(box_min.z, fminf(point.z, box_max.z)) - point.z;
+    return near_x * near_x + near_y * near_y + near_z * near_z;
+}
+
+static int compare_chunk_columns(const void *a, const void *b) {
+    const Chunk *ca = *(Chunk *const *)a;
+    const Chunk *cb = *(Chunk *const *)b;
+    if (ca->chunk_x != cb->chunk_x) {
+        return ca->chunk_x < cb->chunk_x ? -1 : 1;
+    }
+    if (ca->chunk_z != cb->chunk_z) {
+        return ca->chunk_z < cb->chunk_z ? -1 : 1;
+    }
+    return 0;
+}
+
+int chunk_cull(const ChunkFrustum *frustum, Chunk *const *chunks, int count, Vector3 camera_offset,
+               Vector3 camera_position, float max_distance, Chunk **out_visible, ChunkCullStats *stats) {
+    ChunkCullStats local = {0};
+    local.chunks_total = count;
+    if (count <= 0) {
+        if (stats) {
+            *stats = local;
+        }
+        return 0;
+    }
+
+    // Group into columns in the output buffer, then compact survivors in place
+    memcpy(out_visible, chunks, sizeof(Chunk *) * count);
+    qsort(out_visible, count, sizeof(Chunk *), compare_chunk_columns);
+
+    float max_dist_sq = max_distance * max_distance;
+    int visible = 0;
+    int start = 0;
+    while (start < count) {
+        Chunk *first = out_visible[start];
+        int end = start + 1;
+        int min_y = first->chunk_y;
+        int max_y = first->chunk_y;
+        while (end < count && out_visible[end]->chunk_x == first->chunk_x && out_visible[end]->chunk_z == first->chunk_z) {
+            min_y = out_visible[end]->chunk_y < min_y ? out_visible[end]->chunk_y : min_y;
+            max_y = out_visible[end]->chunk_y > max_y ? out_visible[end]->chunk_y : max_y;
+            end++;
+        }
+        local.columns_total++;
+
+        float min_x = first->chunk_x * CHUNK_WIDTH - camera_offset.x;
+        float min_z = first->chunk_z * CHUNK_DEPTH - camera_offset.z;
+        Vector3 column_min = {min_x, min_y * CHUNK_HEIGHT - camera_offset.y, min_z};
+        Vector3 column_max = {min_x + CHUNK_WIDTH, (max_y + 1) * CHUNK_HEIGHT - camera_offset.y, min_z + CHUNK_DEPTH};
+        if (!chunk_frustum_test_aabb(frustum, column_min, column_max)) {
+            local.columns_culled++;
+            local.chunks_column_culled += end - start;
+            start = end;
+            continue;
+        }
+
+        for (int i = start; i < end; i++) {
+            Chunk *chunk = out_visible[i];
+            Vector3 box_min = {min_x, chunk->chunk_y * CHUNK_HEIGHT - camera_offset.y, min_z};
+            Vector3 box_max = {box_min.x + CHUNK_WIDTH, box_min.y + CHUNK_HEIGHT, box_min.z + CHUNK_DEPTH};
+
+            // Distance to the closest point of the chunk, so partially near chunks still count
+            if (chunk_cull_nearest_dist_sq(box_min, box_max, camera_position) > max_dist_sq) {
+                local.chunks_distance_culled++;
+                continue;
+            }
+            if (!chunk_frustum_test_aabb(frustum, box_min, box_max)) {
+                local.chunks_frustum_culled++;
+                continue;
+            }
+            out_visible[visible++] = chunk; // visible <= i, never overwrites an unread entry
+        }
+        start = end;
+    }
+
+    local.chunks_visible = visible;
+    if (stats) {
+        *stats = local;
+    }
+    return visible;
+}
+
+typedef struct {
+    int cell;
+    int8_t entry_face; // Face the walk came in through, -1 for the camera's chunk
+    uint8_t directions; // Face directions taken so far, bit per face
+} ChunkCullStep;
+
+static const int chunk_cull_face_step[6][3] = {
+    {1, 0, 0}, {-1, 0, 0}, {0, 1, 0}, {0, -1, 0}, {0, 0, 1}, {0, 0, -1}};
+
+static int chunk_cull_floor_div(float value, int size) {
+    return (int)floorf(value / (float)size);
+}
+
+int chunk_cull_occlusion(const ChunkFrustum *frustum, Chunk *const *chunks, int count, Vector3 camera_offset,
+                         Vector3 camera_position, Chunk **visible, int visible_count, FrameArena *arena,
+                         ChunkCullStats *stats) {
+    if (count <= 0 || visible_count <= 0) {
+        return visible_count;
+    }
+
+    // Dense grid over the loaded chunks, so neighbours are found by index
+    int min_x = chunks[0]->chunk_x, max_x = chunks[0]->chunk_x;
+    int min_y = chunks[0]->chunk_y, max_y = chunks[0]->chunk_y;
+    int min_z = chunks[0]->chunk_z, max_z = chunks[0]->chunk_z;
+    for (int i = 1; i < count; i++) {
+        min_x = chunks[i]->chunk_x < min_x ? chunks[i]->chunk_x : min_x;
+        max_x = chunks[i]->chunk_x > max_x ? chunks[i]->chunk_x : max_x;
+        min_y = chunks[i]->chunk_y < min_y ? chunks[i]->chunk_y : min_y;
+        max_y = chunks[i]->chunk_y > max_y ? chunks[i]->chunk_y : max_y;
+        min_z = chunks[i]->chunk_z < min_z ? chunks[i]->chunk_z : min_z;
+        max_z = chunks[i]->chunk_z > max_z ? chunks[i]->chunk_z : max_z;
+    }
+    int size_x = max_x - min_x + 1;
+    int size_y = max_y - min_y + 1;
+    int size_z = max_z - min_z + 1;
+    long long cells = (long long)size_x * size_y * size_z;
+    if (cells > CHUNK_CULL_MAX_GRID_CELLS) {
+        return visible_count;
+    }
+
+    int camera_x = chunk_cull_floor_div(camera_position.x + camera_offset.x, CHUNK_WIDTH) - min_x;
+    int camera_y = chunk_cull_floor_div(camera_position.y + camera_offset.y, CHUNK_HEIGHT) - min_y;
+    int camera_z = chunk_cull_floor_div(camera_position.z + camera_offset.z, CHUNK_DEPTH) - min_z;
+    if (camera_x < 0 || camera_x >= size_x || camera_y < 0 || camera_y >= size_y || camera_z < 0 || camera_z >= size_z) {
+        return visible_count; // Camera outside the loaded area: nothing to walk from
+    }
+
+    Chunk **grid = (Chunk **)frame_arena_alloc(arena, sizeof(Chunk *) * cells);
+    uint8_t *reached = (uint8_t *)frame_arena_alloc(arena, (size_t)cells);
+    ChunkCullStep *queue = (ChunkCullStep *)frame_arena_alloc(arena, sizeof(ChunkCullStep) * cells);
+    if (!grid || !reached || !queue) {
+        return visible_count;
+    }
+    memset(grid, 0, sizeof(Chunk *) * cells);
+    memset(reached, 0, (size_t)cells);
+    for (int i = 0; i < count; i++) {
+        int cell = ((chunks[i]->chunk_y - min_y) * size_z + (chunks[i]->chunk_z - min_z)) * size_x + (chunks[i]->chunk_x - min_x);
+        grid[cell] = chunks[i];
+    }
+
+    // Breadth-first, so each chunk is claimed by its shortest path from the camera
+    int head = 0;
+    int tail = 0;
+    int camera_cell = (camera_y * size_z + camera_z) * size_x + camera_x;
+    queue[tail++] = (ChunkCullStep){camera_cell, -1, 0};
+    reached[camera_cell] = 1;
+    while (head < tail) {
+        ChunkCullStep step = queue[head++];
+        int x = step.cell % size_x;
+        int z = (step.cell / size_x) % size_z;
+        int y = step.cell / (size_x * size_z);
+        Chunk *chunk = grid[step.cell];
+        // Gaps in the loaded set (not generated yet, outside the world) count as open air
+        uint16_t visibility = chunk ? __atomic_load_n(&chunk->visibility, __ATOMIC_RELAXED) : CHUNK_VISIBILITY_ALL;
+
+        for (int face = 0; face < 6; face++) {
+            if (step.directions & (1 << (face ^ 1))) {
+                continue; // Would step back against a direction already taken
+            }
+            if (step.entry_face >= 0 && !chunk_visibility_connected(visibility, step.entry_face, face)) {
+                continue;
+            }
+            int nx = x + chunk_cull_face_step[face][0];
+            int ny = y + chunk_cull_face_step[face][1];
+            int nz = z + chunk_cull_face_step[face][2];
+            if (nx < 0 || nx >= size_x || ny < 0 || ny >= size_y || nz < 0 || nz >= size_z) {
+                continue;
+            }
+            int next = (ny * size_z + nz) * size_x + nx;
+            if (reached[next]) {
+                continue;
+            }
+            Vector3 box_min = {
+                (nx + min_x) * CHUNK_WIDTH - camera_offset.x,
+                (ny + min_y) * CHUNK_HEIGHT - camera_offset.y,
+                (nz + min_z) * CHUNK_DEPTH - camera_offset.z};
+            Vector3 box_max = {box_min.x + CHUNK_WIDTH, box_min.y + CHUNK_HEIGHT, box_min.z + CHUNK_DEPTH};
+            if (!chunk_frustum_test_aabb(frustum, box_min, box_max)) {
+                continue;
+            }
+            reached[next] = 1;
+            // Entered through the face opposite the one we left by
+            queue[tail++] = (ChunkCullStep){next, (int8_t)(face ^ 1), (uint8_t)(step.directions | (1 << face))};
+        }
+    }
+
+    int kept = 0;
+    for (int i = 0; i < visible_count; i++) {
+        Chunk *chunk = visible[i];
+        int cell = ((chunk->chunk_y - min_y) * size_z + (chunk->chunk_z - min_z)) * size_x + (chunk->chunk_x - min_x);
+        if (reached[cell]) {
+            visible[kept++] = chunk;
+        }
+    }
+    if (stats) {
+        stats->chunks_occlusion_culled = visible_count - kept;
+        stats->chunks_visible = kept;
+    }
+    return kept;
+}
+
+// ============================================================================
+// LEVEL OF DETAIL SELECTION
+// ============================================================================
+// Each detail level takes over past a share of the render distance, but never
+// closer than a fixed distance so short render distances keep full detail
+// around the camera. Level 1 starts where the fog does. Over the last
+// CHUNK_LOD_FADE_BAND of a level's range it is cross-faded into the next one.
+
+static const float chunk_lod_start_share[CHUNK_LOD_LEVELS] = {0.0f, 0.6f, 0.75f, 0.9f};
+static const float chunk_lod_start_min[CHUNK_LOD_LEVELS] = {0.0f, 24.0f, 48.0f, 96.0f};
+
+// Share of the render distance over which two levels cross-fade
+#define CHUNK_LOD_FADE_BAND 0.05f
+
+int chunk_lod_select(const Chunk *chunk, Vector3 camera_offset, Vector3 camera_position, float render_distance,
+                     ChunkLodDraw out[2]) {
+    Vector3 box_min = {chunk->chunk_x * CHUNK_WIDTH - camera_offset.x, chunk->chunk_y * CHUNK_HEIGHT - camera_offset.y,
+                       chunk->chunk_z * CHUNK_DEPTH - camera_offset.z};
+    Vector3 box_max = {box_min.x + CHUNK_WIDTH, box_min.y + CHUNK_HEIGHT, box_min.z + CHUNK_DEPTH};
+    float dist = sqrtf(chunk_cull_nearest_dist_sq(box_min, box_max, camera_position));
+    float band = render_distance * CHUNK_LOD_FADE_BAND;
+
+    int level = 0;
+    float fade = 0.0f;
+    for (int l = 1; l < CHUNK_LOD_LEVELS; l++) {
+        float start = fmaxf(render_distance * chunk_lod_start_share[l], chunk_lod_start_min[l]);
+        if (dist >= start) {
+            level = l;
+            fade = 0.0f;
+        } else {
+            if (dist > start - band) {
+                fade = (dist - (start - band)) / band;
+            }
+            break;
+        }
+    }
+
+    // Pixels below the fade threshold go to the coarser level, the rest stay on this one
+    out[0] = (ChunkLodDraw){level, fade, 1.0f};
+    if (fade <= 0.0f) {
+        return 1;
+    }
+    out[1] = (ChunkLodDraw){level + 1, 0.0f, fade};
+    return 2;
+}
@@ -0,0 +1,436 @@
+#include <math.h>
+#include <stddef.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "raylib.h"
+#include "raymath.h"
+#include "rlgl.h"
+#include "../../include/chunk_gpu.h"
+#include "../../include/rendering.h"
+
+// ============================================================================
+// RETAINED CHUNK VERTEX BUFFERS
+// ============================================================================
+// Workers bake each merged mesh into a packed vertex list (chunk_vertices.c).
+// The render thread uploads it to a VBO/VAO the first time it sees a new
+// mesh_version and then draws the chunk straight from GPU memory, at the
+// detail level the caller picks. With the block atlas and chunk shader each
+// pass (opaque, transparent) is a single draw call and two levels can be
+// cross-faded with complementary dither patterns; otherwise it falls back to
+// one draw call per texture layer with the default raylib shader and no
+// cross-fade. Entries are indexed
+// by pool slot and stamped with the chunk generation, so a slot reused by
+// another chunk is detected and its buffers are replaced.
+//
+// Face shading is baked into the vertex colors and the chunk shader fogs each
+// fragment from its own distance to the camera, so drawing a chunk costs no
+// per-block or per-vertex work on the CPU. Only the fallback path and the
+// wireframe overlay, which have no fog shader, fog a whole chunk at once.
+
+// Fog amount (0-1) of a whole chunk, from the distance to its center
+static float chunk_gpu_chunk_fog(const ChunkGpuCache *cache, Vector3 chunk_min) {
+    float dx = chunk_min.x + CHUNK_WIDTH * 0.5f - cache->camera_position.x;
+    float dy = chunk_min.y + CHUNK_HEIGHT * 0.5f - cache->camera_position.y;
+    float dz = chunk_min.z + CHUNK_DEPTH * 0.5f - cache->camera_position.z;
+    float dist = sqrtf(dx * dx + dy * dy + dz * dz);
+    if (dist <= cache->fog_start || cache->fog_end <= cache->fog_start) {
+        return 0.0f;
+    }
+    float fog_factor = (dist - cache->fog_start) / (cache->fog_end - cache->fog_start);
+    return fog_factor > 1.0f ? 1.0f : fog_factor;
+}
+
+static Color chunk_gpu_fog(Color color, float fog_factor) {
+    if (fog_factor > 0.0f) {
+        color.r = (unsigned char)(color.r * (1.0f - fog_factor) + SKYBLUE.r * fog_factor);
+        color.g = (unsigned char)(color.g * (1.0f - fog_factor) + SKYBLUE.g * fog_factor);
+        color.b = (unsigned char)(color.b * (1.0f - fog_factor) + SKYBLUE.b * fog_factor);
+    }
+    return color;
+}
+
+// Point the shader position, texcoord, color and layer inputs at ChunkVertex fields. raylib binds
+// the first three to the same locations in every shader, so one layout serves both shaders.
+static void chunk_gpu_bind_attributes(const ChunkGpuCache *cache) {
+    int *locs = rlGetShaderLocsDefault();
+    rlSetVertexAttribute(locs[SHADER_LOC_VERTEX_POSITION], 3, RL_UNSIGNED_BYTE, false, sizeof(ChunkVertex), offsetof(ChunkVertex, x));
+    rlEnableVertexAttribute(locs[SHADER_LOC_VERTEX_POSITION]);
+    rlSetVertexAttribute(locs[SHADER_LOC_VERTEX_TEXCOORD01], 2, RL_UNSIGNED_BYTE, false, sizeof(ChunkVertex), offsetof(ChunkVertex, u));
+    rlEnableVertexAttribute(locs[SHADER_LOC_VERTEX_TEXCOORD01]);
+    rlSetVertexAttribute(locs[SHADER_LOC_VERTEX_COLOR], 4, RL_UNSIGNED_BYTE, true, sizeof(ChunkVertex), offsetof(ChunkVertex, color));
+    rlEnableVertexAttribute(locs[SHADER_LOC_VERTEX_COLOR]);
+    if (cache->layer_loc >= 0) {
+        rlSetVertexAttribute(cache->layer_loc, 1, RL_UNSIGNED_BYTE, false, sizeof(ChunkVertex), offsetof(ChunkVertex, layer));
+        rlEnableVertexAttribute(cache->layer_loc);
+    }
+}
+
+static void chunk_gpu_release(ChunkGpuMesh *mesh) {
+    free(mesh->glass_vertices);
+    free(mesh->glass_keys);
+    if (mesh->vao_id != 0) {
+        rlUnloadVertexArray(mesh->vao_id);
+    }
+    if (mesh->vbo_id != 0) {
+        rlUnloadVertexBuffer(mesh->vbo_id);
+    }
+    memset(mesh, 0, sizeof(*mesh));
+}
+
+void chunk_gpu_init(ChunkGpuCache *cache) {
+    cache->meshes = NULL;
+    cache->capacity = 0;
+    cache->atlas_shader = (Shader){0};
+    cache->layer_loc = -1;
+    cache->tables_atlas_id = 0;
+
+    // Atlas shader, layerRects/layerColors are sized for CHUNK_MESH_LAYER_COUNT layers.
+    // Without it every layer is drawn separately with the default shader.
+    Shader shader = load_asset_shader("chunk");
+    if (shader.id == 0) {
+        TraceLog(LOG_WARNING, "No chunk shader, drawing chunks per texture");
+        return;
+    }
+    cache->layer_loc = GetShaderLocationAttrib(shader, "vertexLayer");
+    cache->layer_rects_loc = GetShaderLocation(shader, "layerRects");
+    cache->layer_colors_loc = GetShaderLocation(shader, "layerColors");
+    cache->fog_color_loc = GetShaderLocation(shader, "fogColor");
+    cache->fog_range_loc = GetShaderLocation(shader, "fogRange");
+    cache->view_offset_loc = GetShaderLocation(shader, "viewOffset");
+    cache->dither_range_loc = GetShaderLocation(shader, "ditherRange");
+    if (cache->layer_loc < 0) {
+        UnloadShader(shader);
+        return;
+    }
+    cache->atlas_shader = shader;
+}
+
+void chunk_gpu_begin_frame(ChunkGpuCache *cache, Vector3 camera_position, float fog_start, float fog_end) {
+    cache->camera_position = camera_position;
+    cache->fog_start = fog_start;
+    cache->fog_end = fog_end;
+}
+
+void chunk_gpu_shutdown(ChunkGpuCache *cache) {
+    for (int i = 0; i < cache->capacity; i++) {
+        chunk_gpu_release(&cache->meshes[i]);
+    }
+    free(cache->meshes);
+    cache->meshes = NULL;
+    cache->capacity = 0;
+    if (cache->atlas_shader.id != 0) {
+        UnloadShader(cache->atlas_shader);
+        cache->atlas_shader = (Shader){0};
+    }
+    cache->layer_loc = -1;
+    cache->tables_atlas_id = 0;
+}
+
+ChunkGpuMesh *chunk_gpu_get(ChunkGpuCache *cache, const Chunk *chunk) {
+    if ((int)chunk->pool_index >= cache->capacity) {
+        return NULL;
+    }
+    ChunkGpuMesh *mesh = &cache->meshes[chunk->pool_index];
+    if (mesh->generation != chunk->generation || mesh->vertex_count == 0) {
+        return NULL;
+    }
+    return mesh;
+}
+
+ChunkGpuMesh *chunk_gpu_sync(ChunkGpuCache *cache, Chunk *chunk) {
+    if ((int)chunk->pool_index >= cache->capacity) {
+        int new_capacity = cache->capacity > 0 ? cache->capacity : CHUNK_SLAB_SIZE;
+        while (new_capacity <= (int)chunk->pool_index) {
+            new_capacity *= 2;
+        }
+        ChunkGpuMesh *meshes = (ChunkGpuMesh *)realloc(cache->meshes, sizeof(ChunkGpuMesh) * new_capacity);
+        if (!meshes) {
+            return NULL;
+        }
+        memset(&meshes[cache->capacity], 0, sizeof(ChunkGpuMesh) * (new_capacity - cache->capacity));
+        cache->meshes = meshes;
+        cache->capacity = new_capacity;
+    }
+
+    ChunkGpuMesh *mesh = &cache->meshes[chunk->pool_index];
+    if (mesh->generation != chunk->generation) {
+        // Slot was reused by another chunk since the last upload
+        chunk_gpu_release(mesh);
+        mesh->generation = chunk->generation;
+    }
+
+    // Steady state: the uploaded mesh is current, so no lock and no copy
+    if (mesh->mesh_version != __atomic_load_n(&chunk->mesh_version, __ATOMIC_ACQUIRE)) {
+        pthread_mutex_lock(&chunk->mesh_swap_mutex);
+        int active = __atomic_load_n(&chunk->active_merged_mesh, __ATOMIC_ACQUIRE);
+        const MergedMesh *merged = chunk->merged_mesh[active];
+
+        uint32_t generation = mesh->generation;
+        chunk_gpu_release(mesh);
+        mesh->generation = generation;
+        mesh->mesh_version = chunk->mesh_version;
+
+        if (merged && merged->vertex_count > 0) {
+            // Transparent ranges (full resolution only) are one span, re-sorted on the CPU as the camera moves
+            int glass_first = -1;
+            int glass_count = 0;
+            for (int i = merged->lod_ranges[0]; i < merged->lod_ranges[1]; i++) {
+                if (merged->ranges[i].transparent) {
+                    glass_first = glass_first < 0 ? merged->ranges[i].first_vertex : glass_first;
+                    glass_count += merged->ranges[i].vertex_count;
+                }
+            }
+
+            mesh->vao_id = rlLoadVertexArray();
+            rlEnableVertexArray(mesh->vao_id);
+            mesh->vbo_id = rlLoadVertexBuffer(merged->vertices, (int)(merged->vertex_count * sizeof(ChunkVertex)), glass_count > 0);
+            chunk_gpu_bind_attributes(cache);
+            rlDisableVertexArray();
+
+            if (mesh->vbo_id != 0 && glass_count > 0) {
+                mesh->has_transparent = true;
+                // Meshed order first, sorted copy second, so sorting never needs to copy back
+                mesh->glass_vertices = (ChunkVertex *)malloc(sizeof(ChunkVertex) * glass_count * 2);
+                mesh->glass_keys = (ChunkGlassKey *)malloc(sizeof(ChunkGlassKey) * (glass_count / 6));
+                if (mesh->glass_vertices && mesh->glass_keys) {
+                    memcpy(mesh->glass_vertices, &merged->vertices[glass_first], sizeof(ChunkVertex) * glass_count);
+                    mesh->glass_first = glass_first;
+                    mesh->glass_count = glass_count;
+                } else {
+                    // OOM: glass is drawn in meshed order
+                    free(mesh->glass_vertices);
+                    free(mesh->glass_keys);
+                    mesh->glass_vertices = NULL;
+                    mesh->glass_keys = NULL;
+                }
+            }
+
+            if (mesh->vbo_id != 0) {
+                mesh->vertex_count = merged->vertex_count;
+                memcpy(mesh->ranges, merged->ranges, sizeof(ChunkMeshRange) * merged->range_count);
+                mesh->range_count = merged->range_count;
+                memcpy(mesh->lod_ranges, merged->lod_ranges, sizeof(mesh->lod_ranges));
+            }
+        }
+        pthread_mutex_unlock(&chunk->mesh_swap_mutex);
+    }
+
+    return mesh->vertex_count > 0 ? mesh : NULL;
+}
+
+void chunk_gpu_collect(ChunkGpuCache *cache, ChunkCache *chunks) {
+    for (int i = 0; i < cache->capacity; i++) {
+        ChunkGpuMesh *mesh = &cache->meshes[i];
+        if (mesh->generation == 0) {
+            continue;
+        }
+        ChunkHandle handle = {(uint32_t)i, mesh->generation};
+        if (!chunk_pool_resolve(chunks, handle)) {
+            chunk_gpu_release(mesh);
+        }
+    }
+}
+
+// Upload the per-layer atlas rectangles and flat colors, once per atlas texture
+static void chunk_gpu_upload_layer_tables(ChunkGpuCache *cache, World *world) {
+    if (cache->tables_atlas_id == world->textures.atlas_texture.id) {
+        return;
+    }
+    float colors[CHUNK_MESH_LAYER_COUNT][4];
+    for (int layer = 0; layer < CHUNK_MESH_LAYER_COUNT; layer++) {
+        BlockType type = (BlockType)(layer / 3);
+        Color color = world_get_block_color(type);
+        colors[layer][0] = color.r / 255.0f;
+        colors[layer][1] = color.g / 255.0f;
+        colors[layer][2] = color.b / 255.0f;
+        colors[layer][3] = block_is_transparent(type) ? 0.0f : color.a / 255.0f;
+    }
+    rlSetUniform(cache->layer_rects_loc, world->textures.atlas.layer_rects, RL_SHADER_UNIFORM_VEC4, CHUNK_MESH_LAYER_COUNT);
+    rlSetUniform(cache->layer_colors_loc, colors, RL_SHADER_UNIFORM_VEC4, CHUNK_MESH_LAYER_COUNT);
+    cache->tables_atlas_id = world->textures.atlas_texture.id;
+}
+
+static int compare_glass_keys(const void *a, const void *b) {
+    const ChunkGlassKey *ka = (const ChunkGlassKey *)a;
+    const ChunkGlassKey *kb = (const ChunkGlassKey *)b;
+    if (ka->dist_sq < kb->dist_sq) {
+        return 1;
+    }
+    if (ka->dist_sq > kb->dist_sq) {
+        return -1;
+    }
+    return ka->quad - kb->quad; // Stable for equal distances, so ties don't flicker
+}
+
+// Sort the glass quads of [first, first + count) (relative to glass_first) farthest first,
+// from the meshed copy into the sorted copy
+static void chunk_gpu_sort_glass_span(ChunkGpuMesh *mesh, Vector3 camera_local, int first, int count) {
+    const ChunkVertex *source = &mesh->glass_vertices[first];
+    ChunkVertex *sorted = &mesh->glass_vertices[mesh->glass_count + first];
+    int quad_count = count / 6;
+    for (int q = 0; q < quad_count; q++) {
+        // Two triangles (0, 1, 2) and (0, 2, 3): averaging their six corners gives the quad center
+        const ChunkVertex *v = &source[q * 6];
+        float cx = (v[0].x + v[1].x + v[2].x + v[3].x + v[4].x + v[5].x) / 6.0f - camera_local.x;
+        float cy = (v[0].y + v[1].y + v[2].y + v[3].y + v[4].y + v[5].y) / 6.0f - camera_local.y;
+        float cz = (v[0].z + v[1].z + v[2].z + v[3].z + v[4].z + v[5].z) / 6.0f - camera_local.z;
+        mesh->glass_keys[q] = (ChunkGlassKey){cx * cx + cy * cy + cz * cz, q};
+    }
+    qsort(mesh->glass_keys, quad_count, sizeof(ChunkGlassKey), compare_glass_keys);
+    for (int q = 0; q < quad_count; q++) {
+        memcpy(&sorted[q * 6], &source[mesh->glass_keys[q].quad * 6], sizeof(ChunkVertex) * 6);
+    }
+}
+
+// Re-sort the chunk's glass back to front when the camera has moved to another block since
+// the last sort. With the atlas the whole span is one draw call and is sorted as one;
+// otherwise each texture range is drawn on its own and sorted within itself.
+static void chunk_gpu_sort_glass(ChunkGpuMesh *mesh, Vector3 camera_local, bool whole_span) {
+    int cell[3] = {(int)floorf(camera_local.x), (int)floorf(camera_local.y), (int)floorf(camera_local.z)};
+    if (!mesh->glass_vertices || (mesh->glass_sorted && mesh->glass_sorted_whole == whole_span &&
+                                  memcmp(cell, mesh->glass_sort_cell, sizeof(cell)) == 0)) {
+        return;
+    }
+
+    if (whole_span) {
+        chunk_gpu_sort_glass_span(mesh, camera_local, 0, mesh->glass_count);
+    } else {
+        for (int i = mesh->lod_ranges[0]; i < mesh->lod_ranges[1]; i++) {
+            const ChunkMeshRange *range = &mesh->ranges[i];
+            if (range->transparent) {
+                chunk_gpu_sort_glass_span(mesh, camera_local, range->first_vertex - mesh->glass_first, range->vertex_count);
+            }
+        }
+    }
+    rlUpdateVertexBuffer(mesh->vbo_id, &mesh->glass_vertices[mesh->glass_count],
+                         (int)(sizeof(ChunkVertex) * mesh->glass_count), (int)(sizeof(ChunkVertex) * mesh->glass_first));
+    memcpy(mesh->glass_sort_cell, cell, sizeof(cell));
+    mesh->glass_sorted = true;
+    mesh->glass_sorted_whole = whole_span;
+}
+
+void chunk_gpu_begin_transparent(void) {
+    rlSetBlendMode(RL_BLEND_ALPHA);
+    rlEnableColorBlend();
+    rlDisableDepthMask();
+}
+
+void chunk_gpu_end_transparent(void) {
+    rlEnableDepthMask();
+}
+
+int chunk_gpu_draw(ChunkGpuCache *cache, ChunkGpuMesh *mesh, const Chunk *chunk, World *world,
+                   Vector3 camera_offset, ChunkLodDraw lod, bool transparent, bool show_wireframe) {
+    if (transparent && !mesh->has_transparent) {
+        return 0;
+    }
+    bool use_atlas = cache->atlas_shader.id != 0 && world->textures.atlas_texture.id > 0;
+    if (!use_atlas && lod.dither_max - lod.dither_min < 0.5f) {
+        return 0; // No shader to cross-fade with: the level covering most pixels is drawn alone
+    }
+
+    // Within a level ranges are sorted opaque first, so each pass is one contiguous span of vertices
+    int first_range = mesh->lod_ranges[lod.level];
+    int last_range = mesh->lod_ranges[lod.level + 1];
+    int first_vertex = -1;
+    int vertex_count = 0;
+    for (int i = first_range; i < last_range; i++) {
+        if (mesh->ranges[i].transparent == transparent) {
+            first_vertex = first_vertex < 0 ? mesh->ranges[i].first_vertex : first_vertex;
+            vertex_count += mesh->ranges[i].vertex_count;
+        }
+    }
+    if (vertex_count == 0) {
+        return 0;
+    }
+
+    // Flush immediate-mode geometry queued so far, it must not end up drawn over this chunk
+    rlDrawRenderBatchActive();
+
+    Vector3 chunk_min = {chunk->chunk_x * CHUNK_WIDTH - camera_offset.x, chunk->chunk_y * CHUNK_HEIGHT - camera_offset.y,
+                         chunk->chunk_z * CHUNK_DEPTH - camera_offset.z};
+    Matrix model = MatrixTranslate(chunk_min.x, chunk_min.y, chunk_min.z);
+    Matrix mvp = MatrixMultiply(MatrixMultiply(model, rlGetMatrixModelview()), rlGetMatrixProjection());
+
+    if (!rlEnableVertexArray(mesh->vao_id)) {
+        rlEnableVertexBuffer(mesh->vbo_id);
+        chunk_gpu_bind_attributes(cache);
+    }
+    rlActiveTextureSlot(0);
+    // Backface culling stays off for terrain to avoid transient holes near block plane edges
+    rlDisableBackfaceCulling();
+    if (transparent) {
+        Vector3 camera_local = {cache->camera_position.x - chunk_min.x, cache->camera_position.y - chunk_min.y,
+                                cache->camera_position.z - chunk_min.z};
+        chunk_gpu_sort_glass(mesh, camera_local, use_atlas);
+    }
+
+    int *locs = rlGetShaderLocsDefault();
+    if (use_atlas) {
+        // Whole pass in one draw call: the shader picks each layer's tile from the atlas
+        rlEnableShader(cache->atlas_shader.id);
+        chunk_gpu_upload_layer_tables(cache, world);
+        rlSetUniformMatrix(cache->atlas_shader.locs[SHADER_LOC_MATRIX_MVP], mvp);
+        float fog_color[4] = {SKYBLUE.r / 255.0f, SKYBLUE.g / 255.0f, SKYBLUE.b / 255.0f, 1.0f};
+        rlSetUniform(cache->fog_color_loc, fog_color, RL_SHADER_UNIFORM_VEC4, 1);
+        float fog_range[2] = {cache->fog_start, cache->fog_end};
+        rlSetUniform(cache->fog_range_loc, fog_range, RL_SHADER_UNIFORM_VEC2, 1);
+        float view_offset[3] = {chunk_min.x - cache->camera_position.x, chunk_min.y - cache->camera_position.y,
+                                chunk_min.z - cache->camera_position.z};
+        rlSetUniform(cache->view_offset_loc, view_offset, RL_SHADER_UNIFORM_VEC3, 1);
+        float dither_range[2] = {lod.dither_min, lod.dither_max};
+        rlSetUniform(cache->dither_range_loc, dither_range, RL_SHADER_UNIFORM_VEC2, 1);
+        rlEnableTexture(world->textures.atlas_texture.id);
+        rlDrawVertexArray(first_vertex, vertex_count);
+    } else {
+        // No atlas or shader: one draw call per layer with its own texture
+        float fog_factor = chunk_gpu_chunk_fog(cache, chunk_min);
+        rlEnableShader(rlGetShaderIdDefault());
+        rlSetUniformMatrix(locs[SHADER_LOC_MATRIX_MVP], mvp);
+        for (int i = first_range; i < last_range; i++) {
+            const ChunkMeshRange *range = &mesh->ranges[i];
+            if (range->transparent != transparent) {
+                continue;
+            }
+
+            BlockType type = (BlockType)(range->layer / 3);
+            Texture2D texture = world_get_block_face_texture(world, type, (BlockFace)(range->layer % 3));
+            Color tint = WHITE;
+            if (texture.id > 0) {
+                rlEnableTexture(texture.id);
+            } else {
+                // No texture: flat block color, faded into the fog
+                rlEnableTexture(rlGetTextureIdDefault());
+                tint = chunk_gpu_fog(world_get_block_color(type), fog_factor);
+                if (range->transparent) {
+                    tint.a = 0;
+                }
+            }
+            float diffuse[4] = {tint.r / 255.0f, tint.g / 255.0f, tint.b / 255.0f, tint.a / 255.0f};
+            rlSetUniform(locs[SHADER_LOC_COLOR_DIFFUSE], diffuse, RL_SHADER_UNIFORM_VEC4, 1);
+            rlDrawVertexArray(range->first_vertex, range->vertex_count);
+        }
+    }
+
+    if (show_wireframe) {
+        float fog_factor = chunk_gpu_chunk_fog(cache, chunk_min);
+        Color wire_color = chunk_gpu_fog(MAGENTA, fog_factor);
+        wire_color.a = (unsigned char)(255 * (1.0f - fog_factor));
+        float diffuse[4] = {wire_color.r / 255.0f, wire_color.g / 255.0f, wire_color.b / 255.0f, wire_color.a / 255.0f};
+        rlEnableShader(rlGetShaderIdDefault());
+        rlSetUniformMatrix(locs[SHADER_LOC_MATRIX_MVP], mvp);
+        rlEnableTexture(rlGetTextureIdDefault());
+        rlSetUniform(locs[SHADER_LOC_COLOR_DIFFUSE], diffuse, RL_SHADER_UNIFORM_VEC4, 1);
+        rlEnableWireMode();
+        rlDrawVertexArray(first_vertex, vertex_count);
+        rlDisableWireMode();
+    }
+
+    rlEnableBackfaceCulling();
+    rlDisableTexture();
+    rlDisableVertexArray();
+    rlDisableVertexBuffer();
+    rlDisableShader();
+    return vertex_count;
+}
@@ -19,16 +19,15 @@
 #include "../../include/world.h"
 // #include "../../include/clouds.h"
 #include "../../include/aux.h"
+#include "../../include/chunk_cull.h"
+#include "../../include/chunk_gpu.h"
 #include "../../include/console.h"
 #include "../../include/game_server.h"
 
 typedef struct {
     float dist_sq;
-    Vector3 world_pos;
-    int world_x;
-    int world_y;
-    int world_z;
-    uint8_t exposed_faces;
+    ChunkLodDraw lod;
+    Chunk *chunk;
 } GlassRenderEntry;
 
 static int compare_glass_entries(const void *a, const void *b) {
@@ -114,24 +113,12 @@ static int recv_line_nonblocking(int sock, char *buffer, size_t buffer_size, siz
 // clamped to max_distance. This is what keeps the camera from clipping
 // through walls when the player backs up against something.
 static float third_person_camera_clearance(World *world, Vector3 from, Vector3 dir, float max_distance) {
-    const float step = 0.05f;
     const float margin = 0.15f; // keep the camera slightly off the wall surface
 
-    float traveled = 0.0f;
-    while (traveled < max_distance) {
-        float next = traveled + step;
-        Vector3 sample = vec3_add(from, vec3_scale(dir, next));
-
-        int block_x = (int)floorf(sample.x);
-        int block_y = (int)floorf(sample.y);
-        int block_z = (int)floorf(sample.z);
-
-        if (world_get_block(world, block_x, block_y, block_z) != BLOCK_AIR) {
-            float safe = traveled - margin;
-            return safe > 0.0f ? safe : 0.0f;
-        }
-
-        traveled = next;
+    WorldRayHit hit;
+    if (world_raycast(world, from, dir, max_distance, &hit)) {
+        float safe = hit.distance - margin;
+        return safe > 0.0f ? safe : 0.0f;
     }
 
     return max_distance;
@@ -156,6 +143,12 @@ static void draw_player_model(Vector3 position) {
 
 static Shader sdf_shader = {0};
 
+// Retained GPU vertex buffers of the current world's chunks
+static ChunkGpuCache chunk_gpu_cache = {0};
+
+// Scratch memory for one rendered frame (chunk snapshot, glass list), reset every frame
+static FrameArena frame_arena = {0};
+
 // graphics and player constants
 #define WINDOW_WIDTH 1200
 #define WINDOW_HEIGHT 800
@@ -163,6 +156,7 @@ static Shader sdf_shader = {0};
 #define RENDER_DISTANCE 50.0f
 #define FOG_START 30.0f
 #define CULLING_FOV 110.0f
+#define CULLING_NEAR_DIST 0.01f // Matches raylib's projection near plane
 
 int b3dv_main(int argc, char **argv) {
 
@@ -177,27 +171,7 @@ int b3dv_main(int argc, char **argv) {
     InitWindow(WINDOW_WIDTH, WINDOW_HEIGHT, "b3dv 0.0.25-beta");
 
     // Load SDF shader from project assets (avoid external/ references)
-    sdf_shader = (Shader){0};
-    int try_versions[] = {330, 120, 100};
-    for (int i = 0; i < 3; i++) {
-        int ver = try_versions[i];
-        if (ver == 0) {
-            continue;
-        }
-        char vsPath[256];
-        char fsPath[256];
-        snprintf(vsPath, sizeof(vsPath), "assets/shaders/glsl%d/sdf.vs", ver);
-        snprintf(fsPath, sizeof(fsPath), "assets/shaders/glsl%d/sdf.fs", ver);
-        if (FileExists(vsPath) && FileExists(fsPath)) {
-            sdf_shader = LoadShader(vsPath, fsPath);
-            if (sdf_shader.id != 0) {
-                TraceLog(LOG_INFO, "Loaded SDF shader from %s and %s", vsPath, fsPath);
-                break;
-            } else {
-                TraceLog(LOG_WARNING, "Failed to load shader files %s / %s", vsPath, fsPath);
-            }
-        }
-    }
+    sdf_shader = load_asset_shader("sdf");
 
     // Disable default ESC key behavior (we handle it manually for pause menu)
     SetExitKey(KEY_NULL);
@@ -387,6 +361,7 @@ int b3dv_main(int argc, char **argv) {
             // Initialize game with selected world
             if (!world) {
                 world = world_create();
+                chunk_gpu_init(&chunk_gpu_cache);
                 world->compress_chunk_files = menu->create_world_compress;
 
                 if (menu->multiplayer_client && menu->server_socket >= 0) {
@@ -995,9 +970,9 @@ int b3dv_main(int argc, char **argv) {
                             }
                         } else {
                             BlockType broken_block = world_get_block(world, hit_x, hit_y, hit_z);
-                            if (broken_block != BLOCK_BEDROCK && broken_block != BLOCK_AIR) {
+                            if (broken_block != BLOCK_BEDROCK && broken_block != BLOCK_AIR &&
+                                world_set_block(world, hit_x, hit_y, hit_z, BLOCK_AIR)) {
                                 inventory_add_block(player, broken_block);
-                                world_set_block(world, hit_x, hit_y, hit_z, BLOCK_AIR);
                             }
                         }
                     }
@@ -1045,8 +1020,9 @@ int b3dv_main(int argc, char **argv) {
                                     }
                                 } else {
                                     BlockType block_to_place = inventory_get_selected_block(player);
-                                    if (block_to_place != BLOCK_AIR && inventory_remove_block(player, block_to_place)) {
-                                        world_set_block(world, adj_x, adj_y, adj_z, block_to_place);
+                                    if (block_to_place != BLOCK_AIR && inventory_remove_block(player, block_to_place) &&
+                                        !world_set_block(world, adj_x, adj_y, adj_z, block_to_place)) {
+                                        inventory_add_block(player, block_to_place); // Chunk not in yet, keep the block
                                     }
                                 }
                             }
@@ -1080,6 +1056,7 @@ int b3dv_main(int argc, char **argv) {
         // Update physics and world always (unless game is paused), even if chat is active
         if (!paused) {
             if (menu->multiplayer_client && menu->server_socket >= 0) {
+                worker_set_interest(world, player->position, camera_forward);
                 world_update_chunks(world, player->position, camera_forward, menu->render_distance);
             } else {
                 game_server_set_interest(&game_server, player->position, camera_forward, menu->render_distance);
@@ -1143,28 +1120,53 @@ int b3dv_main(int argc, char **argv) {
         // Use shifted camera position for visibility checks
         Vector3 shifted_cam_pos = camera.position;
 
-        int blocks_rendered = 0; // Declared here so it's accessible after the if block
+        int quads_rendered = 0; // Declared here so it's accessible after the if block
+        ChunkCullStats cull_stats = {0};
 
         BeginMode3D(camera);
+        // Last frame's scratch allocations are done with; this frame reuses the same memory
+        frame_arena_reset(&frame_arena);
+
         // Use the actual camera orientation for rendering/frustum culling
         // CRITICAL: Take a snapshot of chunk pointers while holding cache_mutex
         // This prevents chunks from being unloaded during rendering
         pthread_mutex_lock(&world->cache_mutex);
         int chunk_count_snapshot = world->chunk_cache.chunk_count;
-        // Allocate temporary array for chunk pointers
-        Chunk **chunks_snapshot = (Chunk **)malloc(chunk_count_snapshot * sizeof(Chunk *));
-        for (int i = 0; i < chunk_count_snapshot; i++) {
-            chunks_snapshot[i] = &world->chunk_cache.chunks[i];
+        Chunk **chunks_snapshot = (Chunk **)frame_arena_alloc(&frame_arena, chunk_count_snapshot * sizeof(Chunk *));
+        if (chunks_snapshot) {
+            memcpy(chunks_snapshot, world->chunk_cache.live, chunk_count_snapshot * sizeof(Chunk *));
+        } else {
+            chunk_count_snapshot = 0; // OOM: skip drawing chunks this frame
         }
+        // Drop GPU buffers of chunks unloaded since the last frame
+        chunk_gpu_collect(&chunk_gpu_cache, &world->chunk_cache);
         pthread_mutex_unlock(&world->cache_mutex);
 
-        // draw all chunks and their blocks with frustum culling and face culling
-        GlassRenderEntry *glass_entries = NULL;
+        // Frustum and column culling: only chunks that can be on screen reach the draw loop
+        ChunkFrustum frustum;
+        chunk_frustum_from_camera(&frustum, shifted_cam_pos, camera_forward, camera.up,
+                                  fov_half_vert_tan, fov_half_horiz_tan, CULLING_NEAR_DIST, menu->render_distance);
+        Chunk **visible_chunks = (Chunk **)frame_arena_alloc(&frame_arena, chunk_count_snapshot * sizeof(Chunk *));
+        int visible_chunk_count = 0;
+        if (visible_chunks) {
+            visible_chunk_count = chunk_cull(&frustum, chunks_snapshot, chunk_count_snapshot, camera_offset,
+                                             shifted_cam_pos, menu->render_distance, visible_chunks, &cull_stats);
+            // Cave culling: drop chunks no air path from the camera's chunk leads to
+            visible_chunk_count = chunk_cull_occlusion(&frustum, chunks_snapshot, chunk_count_snapshot, camera_offset,
+                                                       shifted_cam_pos, visible_chunks, visible_chunk_count,
+                                                       &frame_arena, &cull_stats);
+        }
+
+        // Fog starts at 60% of render distance; the chunk shader applies it per pixel
+        chunk_gpu_begin_frame(&chunk_gpu_cache, shifted_cam_pos, menu->render_distance * 0.6f, menu->render_distance);
+
+        // draw the visible chunks with face culling
+        // At most one glass entry per chunk, so the list never has to grow
+        GlassRenderEntry *glass_entries = (GlassRenderEntry *)frame_arena_alloc(&frame_arena, visible_chunk_count * sizeof(GlassRenderEntry));
         int glass_count = 0;
-        int glass_capacity = 0;
 
-        for (int c = 0; c < chunk_count_snapshot; c++) {
-            Chunk *chunk = chunks_snapshot[c];
+        for (int c = 0; c < visible_chunk_count; c++) {
+            Chunk *chunk = visible_chunks[c];
 
             // Skip unloaded chunks
             if (!chunk->loaded) {
@@ -1176,170 +1178,53 @@ int b3dv_main(int argc, char **argv) {
                 continue;
             }
 
-            // OPTIMIZATION: Iterate only through cached visible blocks instead of all blocks
-            // This is the main performance win - avoids triple-nested loop of 2048 blocks per chunk
-            // Lock chunk while accessing visible_blocks to avoid race with worker thread
-            pthread_mutex_lock(&chunk->mesh_swap_mutex);
-
-            // Get active mesh buffer (updated by worker thread via double-buffer swap)
-            // Use atomic load with acquire semantics to ensure we see the latest update
-            int active = __atomic_load_n(&chunk->active_mesh, __ATOMIC_ACQUIRE);
-
-            // Safety checks after locking
-            // Render even if worker is updating - we see consistent data from active buffer
-            // to prevent use-after-free if worker thread updates the other buffer
-            int visible_count = chunk->visible_count[active];
-            CachedVisibleBlock *visible_blocks_copy = (CachedVisibleBlock *)malloc(visible_count * sizeof(CachedVisibleBlock));
-            if (!visible_blocks_copy) {
-                pthread_mutex_unlock(&chunk->mesh_swap_mutex);
-                continue;
-            }
-
-            // CRITICAL: Hold lock during memcpy to prevent another thread from updating
-            // chunk->visible_blocks[active] or visible_count[active] while we're copying
-            // This prevents reading beyond buffer bounds or using freed memory
-            if (chunk->visible_blocks[active] != NULL && visible_count > 0) {
-                memcpy(visible_blocks_copy, chunk->visible_blocks[active], visible_count * sizeof(CachedVisibleBlock));
-            } else {
-                // Buffer not ready yet, skip rendering this chunk
-                free(visible_blocks_copy);
-                pthread_mutex_unlock(&chunk->mesh_swap_mutex);
-                continue;
+            // OPTIMIZATION: Draw the chunk from its retained GPU vertex buffer
+            // Vertices are baked once per remesh by the worker; a new mesh is uploaded here
+            // the first time we see it (under mesh_swap_mutex), otherwise the mesh is used
+            // in place with no lock and nothing is sent to the GPU but the draw calls
+            ChunkGpuMesh *gpu_mesh = chunk_gpu_sync(&chunk_gpu_cache, chunk);
+            if (!gpu_mesh) {
+                continue; // Mesh not ready yet (or chunk is all air/fully buried), nothing to draw
             }
 
-            pthread_mutex_unlock(&chunk->mesh_swap_mutex);
-
-            // Render blocks with the copied data (no lock held)
-            // Pre-compute render distance thresholds for LOD
-            float aggressive_lod_dist = menu->render_distance * 0.75f;
-            float aggressive_lod_dist_sq = aggressive_lod_dist * aggressive_lod_dist;
-            float render_dist_sq = menu->render_distance * menu->render_distance;
-
-            for (int i = 0; i < visible_count; i++) {
-                int x = visible_blocks_copy[i].x;
-                int y = visible_blocks_copy[i].y;
-                int z = visible_blocks_copy[i].z;
-                BlockType block = world_chunk_get_block(chunk, x, y, z);
-
-                // Calculate world coordinates
-                int world_x = chunk->chunk_x * CHUNK_WIDTH + x;
-                int world_y = chunk->chunk_y * CHUNK_HEIGHT + y;
-                int world_z = chunk->chunk_z * CHUNK_DEPTH + z;
-
-                Vector3 world_pos = (Vector3){
-                    world_x + 0.5f - camera_offset.x,
-                    world_y + 0.5f - camera_offset.y,
-                    world_z + 0.5f - camera_offset.z};
-                // distance-based LOD: use squared distance to avoid sqrt
-                Vector3 to_block = vec3_sub(world_pos, shifted_cam_pos);
-                float dist_sq = to_block.x * to_block.x + to_block.y * to_block.y + to_block.z * to_block.z;
-
-                // hard render distance limit
-                if (dist_sq > render_dist_sq) {
-                    continue;
-                }
+            // LOD: far chunks are drawn from coarser meshes, dithered into each other at level changes
+            ChunkLodDraw lods[2];
+            int lod_count = chunk_lod_select(chunk, camera_offset, shifted_cam_pos, menu->render_distance, lods);
 
-                // AGGRESSIVE LOD: Skip blocks beyond 75% of render distance
-                // This culls ~60% of blocks while maintaining visual quality
-                // Blocks at render_distance are mostly fog-shrouded anyway
-                if (dist_sq > aggressive_lod_dist_sq) {
-                    continue;
-                }
-
-                // OPTIMIZATION: Skip is_block_visible_fast() - chunk frustum culling is sufficient
-                // OPTIMIZATION: Skip is_block_occluded() - visible_blocks cache already filters these
-
-                float dist = sqrtf(dist_sq); // Only calc sqrt if we're actually rendering
-                Color color = world_get_block_color(block);
-
-                // apply fog effect: fade color towards sky blue based on distance
-                float fog_factor = 0.0f;
-                float fog_start = menu->render_distance * 0.6f; // Fog starts at 60% of render distance
-                if (dist > fog_start) {
-                    fog_factor = (dist - fog_start) / (menu->render_distance - fog_start);
-                    fog_factor = fog_factor > 1.0f ? 1.0f : fog_factor; // Clamp to 0-1
-
-                    // blend color towards sky blue
-                    color.r = (unsigned char)(color.r * (1.0f - fog_factor) + SKYBLUE.r * fog_factor);
-                    color.g = (unsigned char)(color.g * (1.0f - fog_factor) + SKYBLUE.g * fog_factor);
-                    color.b = (unsigned char)(color.b * (1.0f - fog_factor) + SKYBLUE.b * fog_factor);
-                }
-
-                // apply fog to wireframe too
-                Color wire_color = MAGENTA;
-                if (fog_factor > 0.0f) {
-                    wire_color.r = (unsigned char)(wire_color.r * (1.0f - fog_factor) + SKYBLUE.r * fog_factor);
-                    wire_color.g = (unsigned char)(wire_color.g * (1.0f - fog_factor) + SKYBLUE.g * fog_factor);
-                    wire_color.b = (unsigned char)(wire_color.b * (1.0f - fog_factor) + SKYBLUE.b * fog_factor);
-                    wire_color.a = (unsigned char)(255 * (1.0f - fog_factor)); // Fade out alpha too
-                }
-                if (block != BLOCK_GLASS) {
-                    // draw opaque blocks first
-                    draw_cube_faces(world_pos, 1.0f, color, camera.position, wire_color, world, world_x, world_y, world_z, block, visible_blocks_copy[i].exposed_faces, show_wireframe);
-                    blocks_rendered++;
-                }
+            // draw opaque layers now, transparent ones after every chunk's opaque geometry
+            for (int l = 0; l < lod_count; l++) {
+                int vertices = chunk_gpu_draw(&chunk_gpu_cache, gpu_mesh, chunk, world, camera_offset, lods[l], false,
+                                              show_wireframe);
+                quads_rendered += vertices / 6;
             }
 
-            for (int i = 0; i < visible_count; i++) {
-                int x = visible_blocks_copy[i].x;
-                int y = visible_blocks_copy[i].y;
-                int z = visible_blocks_copy[i].z;
-                BlockType block = world_chunk_get_block(chunk, x, y, z);
-                if (block != BLOCK_GLASS) {
-                    continue;
-                }
-
-                int world_x = chunk->chunk_x * CHUNK_WIDTH + x;
-                int world_y = chunk->chunk_y * CHUNK_HEIGHT + y;
-                int world_z = chunk->chunk_z * CHUNK_DEPTH + z;
-
-                Vector3 world_pos = (Vector3){
-                    world_x + 0.5f - camera_offset.x,
-                    world_y + 0.5f - camera_offset.y,
-                    world_z + 0.5f - camera_offset.z};
-
-                Vector3 to_block = vec3_sub(world_pos, shifted_cam_pos);
-                float dist_sq = to_block.x * to_block.x + to_block.y * to_block.y + to_block.z * to_block.z;
-
-                if (glass_count >= glass_capacity) {
-                    glass_capacity = glass_capacity > 0 ? glass_capacity * 2 : 64;
-                    GlassRenderEntry *new_entries = (GlassRenderEntry *)realloc(glass_entries, sizeof(GlassRenderEntry) * glass_capacity);
-                    if (new_entries == NULL) {
-                        // OOM: keep existing entries and skip adding this glass block
-                        break;
-                    }
-                    glass_entries = new_entries;
-                }
-
-                glass_entries[glass_count].dist_sq = dist_sq;
-                glass_entries[glass_count].world_pos = world_pos;
-                glass_entries[glass_count].world_x = world_x;
-                glass_entries[glass_count].world_y = world_y;
-                glass_entries[glass_count].world_z = world_z;
-                glass_entries[glass_count].exposed_faces = visible_blocks_copy[i].exposed_faces;
+            // Only the full resolution level keeps glass
+            if (gpu_mesh->has_transparent && lods[0].level == 0 && glass_entries) {
+                Vector3 center = {chunk->chunk_x * CHUNK_WIDTH + CHUNK_WIDTH * 0.5f - camera_offset.x,
+                                  chunk->chunk_y * CHUNK_HEIGHT + CHUNK_HEIGHT * 0.5f - camera_offset.y,
+                                  chunk->chunk_z * CHUNK_DEPTH + CHUNK_DEPTH * 0.5f - camera_offset.z};
+                Vector3 to_center = vec3_sub(center, shifted_cam_pos);
+                glass_entries[glass_count].dist_sq = to_center.x * to_center.x + to_center.y * to_center.y + to_center.z * to_center.z;
+                glass_entries[glass_count].lod = lods[0];
+                glass_entries[glass_count].chunk = chunk;
                 glass_count++;
             }
-
-            // Free the temporary copy
-            free(visible_blocks_copy);
         }
 
-        // Draw transparent glass blocks after opaque blocks so blending is correct
+        // Draw transparent glass after opaque geometry so blending is correct, farthest chunk first,
+        // in one blend state; each chunk keeps its own glass sorted back to front
         if (glass_count > 0) {
             qsort(glass_entries, glass_count, sizeof(GlassRenderEntry), compare_glass_entries);
+            chunk_gpu_begin_transparent();
             for (int i = 0; i < glass_count; i++) {
-                GlassRenderEntry *entry = &glass_entries[i];
-                Color color = world_get_block_color(BLOCK_GLASS);
-                Color wire_color = MAGENTA;
-                draw_cube_faces(entry->world_pos, 1.0f, color, camera.position, wire_color,
-                                world, entry->world_x, entry->world_y, entry->world_z,
-                                BLOCK_GLASS, entry->exposed_faces, show_wireframe);
-                blocks_rendered++;
+                Chunk *chunk = glass_entries[i].chunk;
+                ChunkGpuMesh *gpu_mesh = chunk_gpu_get(&chunk_gpu_cache, chunk);
+                if (gpu_mesh) {
+                    chunk_gpu_draw(&chunk_gpu_cache, gpu_mesh, chunk, world, camera_offset, glass_entries[i].lod, true,
+                                   show_wireframe);
+                }
             }
-            free(glass_entries);
-            glass_entries = NULL;
-            glass_count = 0;
-            glass_capacity = 0;
+            chunk_gpu_end_transparent();
         }
 
         // Draw highlighting box around the block being looked at
@@ -1417,9 +1302,6 @@ int b3dv_main(int argc, char **argv) {
 #endif
         EndMode3D();
 
-        // Free the chunk snapshot
-        free(chunks_snapshot);
-
         // Restore original camera position
         camera.position = original_camera_pos;
         camera.target.x += camera_offset.x;
@@ -1787,21 +1669,30 @@ int b3dv_main(int argc, char **argv) {
             snprintf(fps_text, sizeof(fps_text), "%s %d", menu->game_text.fps_label, GetFPS());
             DrawTextExCustom(custom_font, fps_text, (Vector2){10, 90}, 32, 1, BLACK);
 
-            char blocks_text[64];
-            snprintf(blocks_text, sizeof(blocks_text), "Blocks Rendered: %d", blocks_rendered);
-            DrawTextExCustom(custom_font, blocks_text, (Vector2){10, 130}, 32, 1, BLACK);
+            char quads_text[64];
+            snprintf(quads_text, sizeof(quads_text), "Quads Rendered: %d", quads_rendered);
+            DrawTextExCustom(custom_font, quads_text, (Vector2){10, 130}, 32, 1, BLACK);
+
+            char cull_text[128];
+            float cull_rate = cull_stats.chunks_total > 0
+                                  ? 100.0f * (cull_stats.chunks_total - cull_stats.chunks_visible) / cull_stats.chunks_total
+                                  : 0.0f;
+            snprintf(cull_text, sizeof(cull_text), "Chunks: %d/%d (%.0f%% culled, %d/%d columns, %d caves)",
+                     cull_stats.chunks_visible, cull_stats.chunks_total, cull_rate,
+                     cull_stats.columns_culled, cull_stats.columns_total, cull_stats.chunks_occlusion_culled);
+            DrawTextExCustom(custom_font, cull_text, (Vector2){10, 170}, 32, 1, BLACK);
 
             int memory_mb = get_process_memory_mb();
             char memory_text[64];
             snprintf(memory_text, sizeof(memory_text), "Memory Usage: %d MB", memory_mb);
-            DrawTextExCustom(custom_font, memory_text, (Vector2){10, 170}, 32, 1, BLACK);
+            DrawTextExCustom(custom_font, memory_text, (Vector2){10, 210}, 32, 1, BLACK);
 
             char pos_text[64];
             snprintf(pos_text, sizeof(pos_text), "Pos: (%.1f, %.1f, %.1f)",
                      player->position.x, player->position.y, player->position.z);
-            DrawTextExCustom(custom_font, pos_text, (Vector2){10, 210}, 32, 1, BLACK);
+            DrawTextExCustom(custom_font, pos_text, (Vector2){10, 250}, 32, 1, BLACK);
 
-            DrawTextExCustom(custom_font, "b3dv 0.0.25-beta", (Vector2){10, 250}, 32, 1, DARKGRAY);
+            DrawTextExCustom(custom_font, "b3dv 0.0.25-beta", (Vector2){10, 290}, 32, 1, DARKGRAY);
         } else if (hud_visible && hud_mode == 2) {
             // player stats HUD
             DrawTextExCustom(custom_font, "=== PLAYER STATS ===", (Vector2){10, 10}, 32, 1, BLACK);
@@ -2221,6 +2112,8 @@ int b3dv_main(int argc, char **argv) {
                         // Reset menu state to main
                         menu->current_state = MENU_STATE_MAIN;
                         // Free world and player
+                        chunk_gpu_shutdown(&chunk_gpu_cache);
+                        frame_arena_free(&frame_arena);
                         world_unload_textures(world);
                         world_free(world);
                         player_free(player);
@@ -2295,9 +2188,11 @@ int b3dv_main(int argc, char **argv) {
     }
     // if (clouds) clouds_free(clouds);
     if (world) {
-        world_unload_textures(world); // Unload textures before closing
+        chunk_gpu_shutdown(&chunk_gpu_cache); // Release chunk vertex buffers while the GL context exists
+        world_unload_textures(world);         // Unload textures before closing
         world_free(world);
     }
+    frame_arena_free(&frame_arena);
     if (sdf_shader.id != 0) {
         UnloadShader(sdf_shader);
     }
@@ -477,43 +477,9 @@ void menu_load_settings(MenuSystem *menu) {
     char font_variant[256] = {0};
 
     char line[256];
-    while (fgets(line, sizeof(line), file)) {
-        // Remove newline
-        line[strcspn(line, "\n")] = '\0';
-
-        // Skip empty lines and pure comment lines
-        if (line[0] == '\0' || line[0] == '#') {
-            continue;
-        }
-
-        // Strip inline comments (anything after #)
-        char *hash = strchr(line, '#');
-        if (hash) {
-            *hash = '\0';
-        }
-
-        // Trim trailing whitespace from the value part
-        int len = strlen(line);
-        while (len > 0 && isspace(line[len - 1])) {
-            line[len - 1] = '\0';
-            len--;
-        }
-
-        // Parse key=value format
-        char *equals = strchr(line, '=');
-        if (!equals) {
-            continue;
-        }
-
-        *equals = '\0';
-        char *key = line;
-        char *value = equals + 1;
-
-        // Trim leading whitespace from value
-        while (*value && isspace(*value)) {
-            value++;
-        }
-
+    char *key = NULL;
+    char *value = NULL;
+    while (options_read_line(file, line, sizeof(line), &key, &value)) {
         if (strcmp(key, "render_distance") == 0) {
             menu->render_distance = atof(value);
             // Clamp to valid range
@@ -597,6 +563,10 @@ void menu_load_settings(MenuSystem *menu) {
 }
 
 void menu_save_settings(MenuSystem *menu) {
+    // The engine settings have no menu controls; carry them over from the old file
+    WorldConfig engine_config;
+    world_config_load(&engine_config);
+
     FILE *file = fopen("./options.conf", "w");
     if (!file) {
         fprintf(stderr, "Failed to save options.conf\n");
@@ -611,6 +581,7 @@ void menu_save_settings(MenuSystem *menu) {
     fprintf(file, "compass_enabled=%s\n", menu->compass_enabled ? "true" : "false");
     // fprintf(file, "clouds_render_distance=%.1f\n", menu->clouds_render_distance);
     fprintf(file, "language=%s\n", menu->current_language);
+    world_config_write(file, &engine_config);
     fprintf(file, "\n"); // fprintf(file, "# do not change fonts manually i made a nice little interface for that :c\n");
     fprintf(file, "font_family=%s\n", menu->font_families[menu->current_font_family_index]);
     fprintf(file, "font_variant=%s\n", menu->font_variants[menu->current_font_variant_index]);
@@ -0,0 +1,106 @@
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "../../include/world.h"
+
+// ============================================================================
+// BLOCK TEXTURE ATLAS
+// ============================================================================
+// Packs every block face texture into one grid of equal square tiles so a
+// chunk can be drawn with a single bound texture. Each texture layer (block
+// type * 3 + face group, see chunk_mesh_layer) gets a normalized rectangle in
+// layer_rects; the chunk shader wraps the greedy-mesh UVs with fract() inside
+// that rectangle. Every tile sits in a cell with a BLOCK_ATLAS_GUTTER texel
+// border copied from the opposite edge of the same tile, so samples that land
+// just outside the rectangle (filtering, fract() rounding at a seam) read
+// the texel the wrap would have picked instead of the neighbouring tile. Pure
+// CPU work on pixel arrays, no GL context needed; the caller uploads
+// atlas->pixels and then releases them.
+
+#define BLOCK_ATLAS_GUTTER 1
+
+// Sample `image` into a tile_size x tile_size square at (tile_x, tile_y), nearest
+// neighbour, and fill the gutter around it with the tile's wrapped-around edges
+static void block_atlas_blit(BlockAtlas *atlas, const BlockAtlasImage *image, int tile_x, int tile_y) {
+    int size = atlas->tile_size;
+    for (int y = -BLOCK_ATLAS_GUTTER; y < size + BLOCK_ATLAS_GUTTER; y++) {
+        int src_y = ((y + size) % size) * image->height / size;
+        Color *dst = &atlas->pixels[(size_t)(tile_y + y) * atlas->width + tile_x];
+        for (int x = -BLOCK_ATLAS_GUTTER; x < size + BLOCK_ATLAS_GUTTER; x++) {
+            int src_x = ((x + size) % size) * image->width / size;
+            dst[x] = image->pixels[(size_t)src_y * image->width + src_x];
+        }
+    }
+}
+
+// Build the atlas from one image per texture layer (NULL = untextured). Layers
+// pointing at the same image share a tile. Returns false on allocation failure
+// or when no layer has an image, leaving the atlas empty.
+bool block_atlas_build(BlockAtlas *atlas, const BlockAtlasImage *layer_images[CHUNK_MESH_LAYER_COUNT]) {
+    memset(atlas, 0, sizeof(*atlas));
+
+    // Distinct images in first-use order, and the largest edge among them
+    const BlockAtlasImage *tiles[CHUNK_MESH_LAYER_COUNT];
+    int layer_tile[CHUNK_MESH_LAYER_COUNT];
+    int tile_count = 0;
+    int tile_size = 0;
+    for (int layer = 0; layer < CHUNK_MESH_LAYER_COUNT; layer++) {
+        const BlockAtlasImage *image = layer_images[layer];
+        layer_tile[layer] = -1;
+        if (!image || !image->pixels || image->width <= 0 || image->height <= 0) {
+            continue;
+        }
+        for (int t = 0; t < tile_count; t++) {
+            if (tiles[t] == image) {
+                layer_tile[layer] = t;
+                break;
+            }
+        }
+        if (layer_tile[layer] < 0) {
+            layer_tile[layer] = tile_count;
+            tiles[tile_count++] = image;
+            tile_size = image->width > tile_size ? image->width : tile_size;
+            tile_size = image->height > tile_size ? image->height : tile_size;
+        }
+    }
+    if (tile_count == 0) {
+        return false;
+    }
+
+    int columns = (int)ceil(sqrt((double)tile_count));
+    int rows = (tile_count + columns - 1) / columns;
+    atlas->tile_size = tile_size;
+    atlas->tile_count = tile_count;
+    int cell_size = tile_size + 2 * BLOCK_ATLAS_GUTTER;
+    atlas->width = columns * cell_size;
+    atlas->height = rows * cell_size;
+    atlas->pixels = (Color *)calloc((size_t)atlas->width * atlas->height, sizeof(Color));
+    if (!atlas->pixels) {
+        memset(atlas, 0, sizeof(*atlas));
+        return false;
+    }
+
+    for (int t = 0; t < tile_count; t++) {
+        block_atlas_blit(atlas, tiles[t], (t % columns) * cell_size + BLOCK_ATLAS_GUTTER,
+                         (t / columns) * cell_size + BLOCK_ATLAS_GUTTER);
+    }
+
+    for (int layer = 0; layer < CHUNK_MESH_LAYER_COUNT; layer++) {
+        int t = layer_tile[layer];
+        if (t < 0) {
+            continue; // Stays {0, 0, 0, 0}: untextured
+        }
+        atlas->layer_rects[layer][0] = (float)((t % columns) * cell_size + BLOCK_ATLAS_GUTTER) / atlas->width;
+        atlas->layer_rects[layer][1] = (float)((t / columns) * cell_size + BLOCK_ATLAS_GUTTER) / atlas->height;
+        atlas->layer_rects[layer][2] = (float)tile_size / atlas->width;
+        atlas->layer_rects[layer][3] = (float)tile_size / atlas->height;
+    }
+    return true;
+}
+
+// Free the CPU pixels once uploaded; layer_rects stay valid
+void block_atlas_free_pixels(BlockAtlas *atlas) {
+    free(atlas->pixels);
+    atlas->pixels = NULL;
+}
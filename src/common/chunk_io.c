@@ -0,0 +1,578 @@
+#include <pthread.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#if defined(__linux__) && defined(__has_include)
+#if __has_include(<linux/io_uring.h>)
+#include <errno.h>
+#include <linux/io_uring.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#if defined(__NR_io_uring_setup) && defined(__NR_io_uring_enter) && defined(__NR_io_uring_register)
+#define CHUNK_IO_HAVE_URING 1
+#endif
+#endif
+#endif
+#include "../../include/world.h"
+
+// ============================================================================
+// CHUNK READ ENGINE
+// ============================================================================
+// world_update_chunks no longer reads chunks it has not seen yet on the main
+// thread. It creates them pending (hidden, like chunks waiting for a worker to
+// generate them) and queues them here. Once a chunk's record has been read,
+// worker_publish_chunk_record decodes it and shows the chunk, queueing its mesh
+// job; a chunk with no record is handed to the workers to generate instead.
+//
+// Two backends, picked by chunk_io in options.conf:
+//   io_uring  (Linux) One thread takes up to CHUNK_IO_BATCH_MAX queued chunks,
+//             looks each record up, and submits every read in one io_uring_enter.
+//             Chunks are finished as their completions arrive. Short or failed
+//             reads are completed with pread. Talks to the kernel through the raw
+//             system calls, so there is no liburing dependency.
+//   threads   A few threads, each reading one chunk at a time through the region
+//             mapping (region_map_chunk). Used wherever io_uring is not available.
+// "auto" tries io_uring and falls back to threads; "sync" keeps the old
+// behaviour of reading on the main thread.
+//
+// Queued reads are kept in a min-heap ordered like the worker queue: nearest the
+// interest point first, chunks behind the view last (worker_chunk_priority). When
+// the player moves, the heap is re-ordered against the new point on the next take.
+//
+// A queued chunk may be unloaded before its read starts; its handle then fails
+// to resolve and the request is dropped. Once a read has started the chunk is
+// held in use, which keeps world_update_chunks from unloading it.
+//
+// Chunk writes keep going through the save thread (save_queue.c), which already
+// batches them per region file and leaves the main thread out of it.
+
+#define CHUNK_IO_BATCH_MAX 64 // Chunks taken off the queue (and reads submitted) at once
+
+static const char *const chunk_io_backend_names[] = {"auto", "io_uring", "threads", "sync"};
+
+// Resolve a queued chunk and hold it in use for the read, NULL if it was unloaded since
+static Chunk *chunk_io_claim(World *world, ChunkHandle handle) {
+    pthread_mutex_lock(&world->cache_mutex);
+    Chunk *chunk = chunk_pool_resolve(&world->chunk_cache, handle);
+    if (chunk) {
+        __atomic_add_fetch(&chunk->in_use_count, 1, __ATOMIC_ACQ_REL);
+    }
+    pthread_mutex_unlock(&world->cache_mutex);
+    return chunk;
+}
+
+// Publish a chunk from the record read for it, or have a worker generate it when it has
+// no readable record (as the main thread used to once a load had failed). Drops the
+// in-use reference the read held.
+static void chunk_io_finish(World *world, Chunk *chunk, const uint8_t *record, size_t size) {
+    if (!record || !worker_publish_chunk_record(world, chunk, record, size)) {
+        worker_queue_chunk_generate(world, chunk);
+    }
+    __atomic_sub_fetch(&chunk->in_use_count, 1, __ATOMIC_ACQ_REL);
+}
+
+// Read one chunk with a blocking read through the region mapping
+static void chunk_io_read_blocking(World *world, Chunk *chunk) {
+    RegionChunkView view;
+    bool stored = region_map_chunk(world->world_name, chunk->chunk_x, chunk->chunk_y, chunk->chunk_z, &view);
+    chunk_io_finish(world, chunk, stored ? view.data : NULL, view.size);
+    region_unmap_chunk(&view);
+}
+
+// Mark `count` requests finished and wake chunk_io_flush once nothing is left
+static void chunk_io_done(ChunkIo *io, int count) {
+    pthread_mutex_lock(&io->mutex);
+    io->in_progress -= count;
+    if (io->count == 0 && io->in_progress == 0) {
+        pthread_cond_broadcast(&io->idle_cond);
+    }
+    pthread_mutex_unlock(&io->mutex);
+}
+
+static bool chunk_io_request_before(const ChunkIoRequest *a, const ChunkIoRequest *b) {
+    if (a->priority != b->priority) {
+        return a->priority < b->priority;
+    }
+    return (int32_t)(a->sequence - b->sequence) < 0;
+}
+
+static void chunk_io_sift_up(ChunkIo *io, int index) {
+    ChunkIoRequest request = io->pending[index];
+    while (index > 0) {
+        int parent = (index - 1) / 2;
+        if (!chunk_io_request_before(&request, &io->pending[parent])) {
+            break;
+        }
+        io->pending[index] = io->pending[parent];
+        index = parent;
+    }
+    io->pending[index] = request;
+}
+
+static void chunk_io_sift_down(ChunkIo *io, int index) {
+    ChunkIoRequest request = io->pending[index];
+    while (true) {
+        int child = index * 2 + 1;
+        if (child >= io->count) {
+            break;
+        }
+        if (child + 1 < io->count && chunk_io_request_before(&io->pending[child + 1], &io->pending[child])) {
+            child++;
+        }
+        if (!chunk_io_request_before(&io->pending[child], &request)) {
+            break;
+        }
+        io->pending[index] = io->pending[child];
+        index = child;
+    }
+    io->pending[index] = request;
+}
+
+// Re-order the queue if the worker interest point moved since it was built.
+// Caller holds io->mutex; worker.c never calls back in here, so taking the
+// worker queue mutex inside it is safe.
+static void chunk_io_reprioritize(World *world, ChunkIo *io) {
+    Vector3 position, forward;
+    uint32_t epoch = worker_get_interest(world, &position, &forward);
+    if (epoch == io->epoch) {
+        return;
+    }
+    for (int i = 0; i < io->count; i++) {
+        ChunkIoRequest *request = &io->pending[i];
+        request->priority = worker_chunk_priority(request->chunk_x, request->chunk_y, request->chunk_z, position, forward);
+    }
+    for (int i = io->count / 2 - 1; i >= 0; i--) {
+        chunk_io_sift_down(io, i);
+    }
+    io->epoch = epoch;
+}
+
+// Wait for requests and take up to `max` of them, most urgent first. Returns 0 on shutdown.
+static int chunk_io_take(World *world, ChunkHandle *out, int max) {
+    ChunkIo *io = &world->chunk_io;
+    pthread_mutex_lock(&io->mutex);
+    while (io->count == 0 && !io->shutdown) {
+        pthread_cond_wait(&io->cond, &io->mutex);
+    }
+    if (io->shutdown) {
+        pthread_mutex_unlock(&io->mutex);
+        return 0; // Queued chunks stay pending; the world is going away or being reloaded
+    }
+
+    chunk_io_reprioritize(world, io);
+    int count = io->count < max ? io->count : max;
+    for (int i = 0; i < count; i++) {
+        out[i] = io->pending[0].handle;
+        io->count--;
+        if (io->count > 0) {
+            io->pending[0] = io->pending[io->count];
+            chunk_io_sift_down(io, 0);
+        }
+    }
+    io->in_progress += count;
+    pthread_mutex_unlock(&io->mutex);
+    return count;
+}
+
+// ============================================================================
+// THREAD BACKEND
+// ============================================================================
+
+static void *chunk_io_thread_main(void *arg) {
+    World *world = (World *)arg;
+    ChunkIo *io = &world->chunk_io;
+    ChunkHandle handle;
+
+    while (chunk_io_take(world, &handle, 1) > 0) {
+        Chunk *chunk = chunk_io_claim(world, handle);
+        if (chunk) {
+            chunk_io_read_blocking(world, chunk);
+        }
+        chunk_io_done(io, 1);
+    }
+    return NULL;
+}
+
+// ============================================================================
+// IO_URING BACKEND
+// ============================================================================
+
+#ifdef CHUNK_IO_HAVE_URING
+struct ChunkIoRing {
+    int fd;
+    // Submission queue; only the engine thread touches it
+    unsigned *sq_tail;
+    unsigned *sq_array;
+    unsigned sq_mask;
+    struct io_uring_sqe *sqes;
+    // Completion queue
+    unsigned *cq_head;
+    unsigned *cq_tail;
+    unsigned cq_mask;
+    struct io_uring_cqe *cqes;
+    void *ring_map; // Both queues (IORING_FEAT_SINGLE_MMAP)
+    size_t ring_size;
+    void *sqe_map;
+    size_t sqe_size;
+    bool failed; // io_uring_enter stopped working; every read goes through pread
+};
+
+static void chunk_io_ring_close(ChunkIoRing *ring) {
+    if (ring->sqe_map) {
+        munmap(ring->sqe_map, ring->sqe_size);
+    }
+    if (ring->ring_map) {
+        munmap(ring->ring_map, ring->ring_size);
+    }
+    if (ring->fd >= 0) {
+        close(ring->fd);
+    }
+    free(ring);
+}
+
+// Set up a ring for CHUNK_IO_BATCH_MAX reads. NULL if the kernel has no io_uring, has it
+// disabled (e.g. by seccomp in a container), or is too old for IORING_OP_READ (5.6).
+static ChunkIoRing *chunk_io_ring_open(void) {
+    ChunkIoRing *ring = (ChunkIoRing *)calloc(1, sizeof(ChunkIoRing));
+    if (!ring) {
+        return NULL;
+    }
+
+    struct io_uring_params params;
+    memset(&params, 0, sizeof(params));
+    ring->fd = (int)syscall(__NR_io_uring_setup, CHUNK_IO_BATCH_MAX, &params);
+    if (ring->fd < 0 || !(params.features & IORING_FEAT_SINGLE_MMAP)) {
+        chunk_io_ring_close(ring);
+        return NULL;
+    }
+
+    size_t sq_size = params.sq_off.array + params.sq_entries * sizeof(unsigned);
+    size_t cq_size = params.cq_off.cqes + params.cq_entries * sizeof(struct io_uring_cqe);
+    ring->ring_size = sq_size > cq_size ? sq_size : cq_size;
+    ring->sqe_size = params.sq_entries * sizeof(struct io_uring_sqe);
+    void *ring_map = mmap(NULL, ring->ring_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, ring->fd, IORING_OFF_SQ_RING);
+    void *sqe_map = mmap(NULL, ring->sqe_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, ring->fd, IORING_OFF_SQES);
+    ring->ring_map = ring_map == MAP_FAILED ? NULL : ring_map;
+    ring->sqe_map = sqe_map == MAP_FAILED ? NULL : sqe_map;
+    if (!ring->ring_map || !ring->sqe_map) {
+        chunk_io_ring_close(ring);
+        return NULL;
+    }
+
+    uint8_t *base = (uint8_t *)ring->ring_map;
+    ring->sq_tail = (unsigned *)(base + params.sq_off.tail);
+    ring->sq_array = (unsigned *)(base + params.sq_off.array);
+    ring->sq_mask = *(unsigned *)(base + params.sq_off.ring_mask);
+    ring->sqes = (struct io_uring_sqe *)ring->sqe_map;
+    ring->cq_head = (unsigned *)(base + params.cq_off.head);
+    ring->cq_tail = (unsigned *)(base + params.cq_off.tail);
+    ring->cq_mask = *(unsigned *)(base + params.cq_off.ring_mask);
+    ring->cqes = (struct io_uring_cqe *)(base + params.cq_off.cqes);
+
+    // Ask the kernel whether it can do plain reads rather than guess from its version
+    size_t probe_size = sizeof(struct io_uring_probe) + 256 * sizeof(struct io_uring_probe_op);
+    struct io_uring_probe *probe = (struct io_uring_probe *)calloc(1, probe_size);
+    bool can_read = probe && syscall(__NR_io_uring_register, ring->fd, IORING_REGISTER_PROBE, probe, 256) == 0 &&
+                    probe->last_op >= IORING_OP_READ && (probe->ops[IORING_OP_READ].flags & IO_URING_OP_SUPPORTED);
+    free(probe);
+    if (!can_read) {
+        chunk_io_ring_close(ring);
+        return NULL;
+    }
+    return ring;
+}
+
+// Blocking read of (the rest of) a record
+static bool chunk_io_pread(int fd, uint8_t *data, size_t size, uint64_t offset) {
+    size_t done = 0;
+    while (done < size) {
+        ssize_t n = pread(fd, data + done, size - done, (off_t)(offset + done));
+        if (n < 0 && errno == EINTR) {
+            continue;
+        }
+        if (n <= 0) {
+            return false;
+        }
+        done += (size_t)n;
+    }
+    return true;
+}
+
+// Finish a chunk whose read returned `result` (bytes read, or -errno). A short or failed
+// read is completed with pread before giving up on the record.
+static void chunk_io_ring_complete(World *world, Chunk *chunk, RegionChunkRef *ref, uint8_t *data, int result) {
+    size_t done = result > 0 ? (size_t)result : 0;
+    if (done > ref->size) {
+        done = ref->size;
+    }
+    bool ok = chunk_io_pread(ref->fd, data + done, ref->size - done, ref->offset + done);
+    if (!ok) {
+        printf("[chunk_io] Failed to read chunk %d,%d,%d\n", chunk->chunk_x, chunk->chunk_y, chunk->chunk_z);
+    }
+    chunk_io_finish(world, chunk, ok ? data : NULL, ref->size);
+    region_unref_chunk(ref);
+    free(data);
+}
+
+// Read one batch: look every record up, submit all the reads with one io_uring_enter,
+// and finish each chunk as its completion comes in
+static void chunk_io_ring_read(World *world, ChunkIoRing *ring, const ChunkHandle *handles, int count) {
+    Chunk *chunks[CHUNK_IO_BATCH_MAX];
+    RegionChunkRef refs[CHUNK_IO_BATCH_MAX];
+    uint8_t *data[CHUNK_IO_BATCH_MAX];
+    bool done[CHUNK_IO_BATCH_MAX];
+    unsigned tail = *ring->sq_tail;
+    int queued = 0;
+
+    for (int i = 0; i < count; i++) {
+        done[i] = true;
+        chunks[i] = chunk_io_claim(world, handles[i]);
+        if (!chunks[i]) {
+            continue;
+        }
+        Chunk *chunk = chunks[i];
+        if (!region_ref_chunk(world->world_name, chunk->chunk_x, chunk->chunk_y, chunk->chunk_z, &refs[i])) {
+            chunk_io_finish(world, chunk, NULL, 0); // Not stored: generate it
+            continue;
+        }
+        data[i] = (uint8_t *)malloc(refs[i].size);
+        if (!data[i]) {
+            region_unref_chunk(&refs[i]);
+            chunk_io_read_blocking(world, chunk);
+            continue;
+        }
+        done[i] = false;
+        if (ring->failed) {
+            continue; // Read with pread below
+        }
+
+        unsigned index = tail & ring->sq_mask;
+        struct io_uring_sqe *sqe = &ring->sqes[index];
+        memset(sqe, 0, sizeof(*sqe));
+        sqe->opcode = IORING_OP_READ;
+        sqe->fd = refs[i].fd;
+        sqe->addr = (uint64_t)(uintptr_t)data[i];
+        sqe->len = (uint32_t)refs[i].size;
+        sqe->off = refs[i].offset;
+        sqe->user_data = (uint64_t)i;
+        ring->sq_array[index] = index;
+        tail++;
+        queued++;
+    }
+    __atomic_store_n(ring->sq_tail, tail, __ATOMIC_RELEASE);
+
+    int unsubmitted = queued;
+    int completed = 0;
+    while (completed < queued) {
+        int ret = (int)syscall(__NR_io_uring_enter, ring->fd, (unsigned)unsubmitted, 1u, IORING_ENTER_GETEVENTS, NULL, 0);
+        if (ret < 0) {
+            if (errno == EINTR || errno == EAGAIN || errno == EBUSY) {
+                continue;
+            }
+            printf("[chunk_io] io_uring_enter failed (%s), reading with pread from now on\n", strerror(errno));
+            ring->failed = true;
+            break;
+        }
+        unsubmitted -= ret;
+
+        unsigned head = *ring->cq_head;
+        unsigned cq_tail = __atomic_load_n(ring->cq_tail, __ATOMIC_ACQUIRE);
+        while (head != cq_tail) {
+            struct io_uring_cqe *cqe = &ring->cqes[head & ring->cq_mask];
+            int i = (int)cqe->user_data;
+            chunk_io_ring_complete(world, chunks[i], &refs[i], data[i], cqe->res);
+            done[i] = true;
+            head++;
+            completed++;
+        }
+        __atomic_store_n(ring->cq_head, head, __ATOMIC_RELEASE);
+    }
+
+    for (int i = 0; i < count; i++) {
+        if (done[i]) {
+            continue;
+        }
+        if (queued > 0) {
+            // The ring broke with this read possibly still in flight: leave its buffer to the
+            // kernel and read into a new one
+            data[i] = (uint8_t *)malloc(refs[i].size);
+            if (!data[i]) {
+                region_unref_chunk(&refs[i]);
+                chunk_io_read_blocking(world, chunks[i]);
+                continue;
+            }
+        }
+        chunk_io_ring_complete(world, chunks[i], &refs[i], data[i], 0);
+    }
+}
+
+static void *chunk_io_ring_thread_main(void *arg) {
+    World *world = (World *)arg;
+    ChunkIo *io = &world->chunk_io;
+    ChunkHandle batch[CHUNK_IO_BATCH_MAX];
+
+    int count;
+    while ((count = chunk_io_take(world, batch, CHUNK_IO_BATCH_MAX)) > 0) {
+        chunk_io_ring_read(world, io->ring, batch, count);
+        chunk_io_done(io, count);
+    }
+    return NULL;
+}
+#endif
+
+// ============================================================================
+// SETUP / REQUESTS
+// ============================================================================
+
+// Start the backend chosen in options.conf
+void chunk_io_init(World *world, const ChunkIoConfig *config) {
+    if (!world || !config) {
+        return;
+    }
+
+    ChunkIo *io = &world->chunk_io;
+    io->config = *config;
+    io->pending = NULL;
+    io->count = 0;
+    io->capacity = 0;
+    io->next_sequence = 0;
+    io->epoch = 0;
+    io->in_progress = 0;
+    io->shutdown = false;
+    io->running = false;
+    io->ring = NULL;
+    io->thread_count = 0;
+    io->backend = CHUNK_IO_SYNC;
+    pthread_mutex_init(&io->mutex, NULL);
+    pthread_cond_init(&io->cond, NULL);
+    pthread_cond_init(&io->idle_cond, NULL);
+
+    ChunkIoBackend wanted = io->config.backend;
+    if (wanted == CHUNK_IO_SYNC) {
+        printf("[chunk_io] Reading chunks on the main thread\n");
+        return;
+    }
+
+    void *(*thread_main)(void *) = chunk_io_thread_main;
+    int thread_count = io->config.thread_count;
+#ifdef CHUNK_IO_HAVE_URING
+    if (wanted == CHUNK_IO_AUTO || wanted == CHUNK_IO_URING) {
+        io->ring = chunk_io_ring_open();
+    }
+    if (io->ring) {
+        thread_main = chunk_io_ring_thread_main;
+        thread_count = 1; // One thread keeps a whole batch in flight
+    }
+#endif
+    if (!io->ring && wanted == CHUNK_IO_URING) {
+        printf("[chunk_io] io_uring is not available, using reader threads\n");
+    }
+    io->backend = io->ring ? CHUNK_IO_URING : CHUNK_IO_THREADS;
+
+    for (int i = 0; i < thread_count; i++) {
+        if (pthread_create(&io->threads[io->thread_count], NULL, thread_main, world) == 0) {
+            io->thread_count++;
+        }
+    }
+    io->running = io->thread_count > 0;
+    if (!io->running) {
+        io->backend = CHUNK_IO_SYNC;
+    }
+
+    printf("[chunk_io] Reading chunks with %s (%d thread(s))\n", chunk_io_backend_names[io->backend], io->thread_count);
+}
+
+// Stop the threads. Reads in progress finish; chunks still queued stay pending.
+void chunk_io_shutdown(World *world) {
+    if (!world) {
+        return;
+    }
+
+    ChunkIo *io = &world->chunk_io;
+    if (io->running) {
+        pthread_mutex_lock(&io->mutex);
+        io->shutdown = true;
+        pthread_cond_broadcast(&io->cond);
+        pthread_mutex_unlock(&io->mutex);
+        for (int i = 0; i < io->thread_count; i++) {
+            pthread_join(io->threads[i], NULL);
+        }
+        io->running = false;
+    }
+    io->thread_count = 0;
+
+#ifdef CHUNK_IO_HAVE_URING
+    if (io->ring) {
+        chunk_io_ring_close(io->ring);
+    }
+#endif
+    io->ring = NULL;
+
+    free(io->pending);
+    io->pending = NULL;
+    io->count = 0;
+    io->capacity = 0;
+    pthread_mutex_destroy(&io->mutex);
+    pthread_cond_destroy(&io->cond);
+    pthread_cond_destroy(&io->idle_cond);
+}
+
+// Queue a pending chunk to be read. Without a running engine, or room to queue it,
+// it is read here instead so the chunk never stays pending with nothing to finish it.
+void chunk_io_request(World *world, Chunk *chunk) {
+    if (!world || !chunk) {
+        return;
+    }
+
+    ChunkIo *io = &world->chunk_io;
+    if (io->running) {
+        pthread_mutex_lock(&io->mutex);
+        if (io->count == io->capacity) {
+            int capacity = io->capacity ? io->capacity * 2 : 256;
+            ChunkIoRequest *pending = (ChunkIoRequest *)realloc(io->pending, sizeof(ChunkIoRequest) * capacity);
+            if (pending) {
+                io->pending = pending;
+                io->capacity = capacity;
+            }
+        }
+        if (io->count < io->capacity) {
+            // Bring the queue up to the current interest point, then price the
+            // new read against that same point
+            chunk_io_reprioritize(world, io);
+            Vector3 position, forward;
+            worker_get_interest(world, &position, &forward);
+            ChunkIoRequest *request = &io->pending[io->count];
+            request->handle = chunk_pool_handle(chunk);
+            request->chunk_x = chunk->chunk_x;
+            request->chunk_y = chunk->chunk_y;
+            request->chunk_z = chunk->chunk_z;
+            request->priority = worker_chunk_priority(chunk->chunk_x, chunk->chunk_y, chunk->chunk_z, position, forward);
+            request->sequence = io->next_sequence++;
+            io->count++;
+            chunk_io_sift_up(io, io->count - 1);
+            pthread_cond_signal(&io->cond);
+            pthread_mutex_unlock(&io->mutex);
+            return;
+        }
+        pthread_mutex_unlock(&io->mutex);
+    }
+
+    __atomic_add_fetch(&chunk->in_use_count, 1, __ATOMIC_ACQ_REL);
+    chunk_io_read_blocking(world, chunk);
+}
+
+// Block until every queued read has finished (and queued its mesh or generate job)
+void chunk_io_flush(World *world) {
+    if (!world || !world->chunk_io.running) {
+        return;
+    }
+
+    ChunkIo *io = &world->chunk_io;
+    pthread_mutex_lock(&io->mutex);
+    while (io->count > 0 || io->in_progress > 0) {
+        pthread_cond_wait(&io->idle_cond, &io->mutex);
+    }
+    pthread_mutex_unlock(&io->mutex);
+}
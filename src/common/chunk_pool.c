@@ -0,0 +1,432 @@
+#include <stddef.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
+
+#include "../../include/world.h"
+
+// ============================================================================
+// CHUNK SLAB POOL
+// ============================================================================
+// Chunks live in slabs of CHUNK_SLAB_SIZE slots that are mapped straight from
+// the OS. A slab never moves, so a Chunk pointer stays valid for as long as the
+// chunk is in the cache, and freeing a chunk never copies another one over it.
+// Each slab keeps a stack of its free slots; ChunkCache.live is a dense list of
+// live chunks for iteration, and each chunk remembers its position in it so
+// removal is a single swap of pointers.
+//
+// New chunks go to the lowest slab with a free slot, which keeps high slabs
+// draining when the loaded area shrinks. A slab that empties out is unmapped,
+// except for one spare kept to absorb load/unload churn at the boundary. Inside
+// a slab that stays mapped, a page whose slots are all free is handed back with
+// MADV_DONTNEED, so a shrinking world returns memory before whole slabs empty.
+// Those slots read as zeroes afterwards (generation 0, so stale handles still
+// resolve to NULL); their mutexes are destroyed first and set up again when the
+// slot is next claimed. Windows has no discard that guarantees zeroes, so pages
+// stay committed there until the slab is unmapped.
+//
+// All functions here must be called with world->cache_mutex held (or before
+// the workers start / after they stop), except chunk_read_begin/end.
+//
+// world_get_block looks chunks up without the cache mutex, so an unloaded chunk
+// can still be in use by a reader after it leaves the hash table. Unloads
+// therefore retire the chunk instead of freeing it. Readers announce themselves
+// by bumping a counter for the parity of the current read epoch; the epoch only
+// advances once every reader that entered under the previous epoch has left.
+// Anything retired at epoch E was unreachable before the epoch moved past E, so
+// once it reaches E + 2 no reader can still hold it.
+
+_Static_assert(CHUNK_SLAB_SIZE <= 64, "slab slot masks are 64-bit");
+
+static ChunkSlab *chunk_slab_map(void) {
+#ifdef _WIN32
+    ChunkSlab *slab = (ChunkSlab *)VirtualAlloc(NULL, sizeof(ChunkSlab), MEM_RESERVE | MEM_COMMIT, PAGE_READWRITE);
+    if (!slab) {
+        return NULL;
+    }
+#else
+    void *mem = mmap(NULL, sizeof(ChunkSlab), PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (mem == MAP_FAILED) {
+        return NULL;
+    }
+    ChunkSlab *slab = (ChunkSlab *)mem;
+#endif
+    // Mapped memory is zeroed; only the free stack and the mutexes need setup.
+    // Mutexes are initialized once per slot and live until the slab is unmapped.
+    for (int i = 0; i < CHUNK_SLAB_SIZE; i++) {
+        slab->free_slots[i] = (uint16_t)(CHUNK_SLAB_SIZE - 1 - i); // Slot 0 is popped first
+        pthread_mutex_init(&slab->chunks[i].mesh_swap_mutex, NULL);
+        pthread_mutex_init(&slab->chunks[i].mutex, NULL);
+    }
+    slab->free_count = CHUNK_SLAB_SIZE;
+    slab->free_mask = ~0ull >> (64 - CHUNK_SLAB_SIZE);
+    return slab;
+}
+
+static void chunk_slab_unmap(ChunkSlab *slab) {
+    for (int i = 0; i < CHUNK_SLAB_SIZE; i++) {
+        if (slab->purged_slots & (1ull << i)) {
+            continue;
+        }
+        pthread_mutex_destroy(&slab->chunks[i].mesh_swap_mutex);
+        pthread_mutex_destroy(&slab->chunks[i].mutex);
+    }
+#ifdef _WIN32
+    VirtualFree(slab, 0, MEM_RELEASE);
+#else
+    munmap(slab, sizeof(ChunkSlab));
+#endif
+}
+
+static size_t chunk_pool_page_size(void) {
+#ifdef _WIN32
+    return 4096;
+#else
+    static size_t page_size = 0;
+    if (page_size == 0) {
+        long size = sysconf(_SC_PAGESIZE);
+        page_size = size > 0 ? (size_t)size : 4096;
+    }
+    return page_size;
+#endif
+}
+
+// Range of pages (from the slab start) that slot `slot` overlaps
+static void chunk_slot_pages(int slot, size_t page_size, size_t *first, size_t *last) {
+    size_t start = offsetof(ChunkSlab, chunks) + (size_t)slot * sizeof(Chunk);
+    *first = start / page_size;
+    *last = (start + sizeof(Chunk) - 1) / page_size;
+}
+
+// Hand back every page around a just-freed slot that holds only free slots.
+// Pages that reach past the slot array (into the free stack) are kept; the
+// array starts the slab, so no page reaches before it.
+static void chunk_slab_purge_around(ChunkSlab *slab, int slot) {
+#ifndef _WIN32
+    size_t page_size = chunk_pool_page_size();
+    size_t first = 0;
+    size_t last = 0;
+    chunk_slot_pages(slot, page_size, &first, &last);
+    for (size_t page = first; page <= last; page++) {
+        size_t page_start = page * page_size;
+        size_t page_end = page_start + page_size;
+        if ((slab->purged_pages & (1ull << page)) || page_end > offsetof(ChunkSlab, chunks) + sizeof(slab->chunks)) {
+            continue;
+        }
+        int first_slot = (int)((page_start - offsetof(ChunkSlab, chunks)) / sizeof(Chunk));
+        int last_slot = (int)((page_end - 1 - offsetof(ChunkSlab, chunks)) / sizeof(Chunk));
+        uint64_t slots = (~0ull >> (63 - last_slot)) & (~0ull << first_slot);
+        if ((slab->free_mask & slots) != slots) {
+            continue;
+        }
+        for (int i = first_slot; i <= last_slot; i++) {
+            if (!(slab->purged_slots & (1ull << i))) {
+                pthread_mutex_destroy(&slab->chunks[i].mesh_swap_mutex);
+                pthread_mutex_destroy(&slab->chunks[i].mutex);
+                slab->purged_slots |= 1ull << i;
+            }
+        }
+        if (madvise((char *)slab + page_start, page_size, MADV_DONTNEED) == 0) {
+            slab->purged_pages |= 1ull << page;
+        }
+    }
+#else
+    (void)slab;
+    (void)slot;
+#endif
+}
+
+static void chunk_pool_release_slab(ChunkCache *cache, int slab_index) {
+    chunk_slab_unmap(cache->slabs[slab_index]);
+    cache->slabs[slab_index] = NULL;
+    while (cache->slab_count > 0 && !cache->slabs[cache->slab_count - 1]) {
+        cache->slab_count--;
+    }
+}
+
+// Map a new slab into the first unused entry. Returns its index, or -1 on failure.
+static int chunk_pool_add_slab(ChunkCache *cache) {
+    int slab_index = 0;
+    while (slab_index < cache->slab_count && cache->slabs[slab_index]) {
+        slab_index++;
+    }
+
+    if (slab_index == cache->slab_count) {
+        ChunkSlab **slabs = (ChunkSlab **)realloc(cache->slabs, sizeof(ChunkSlab *) * (cache->slab_count + 1));
+        if (!slabs) {
+            return -1;
+        }
+        cache->slabs = slabs;
+        cache->slabs[cache->slab_count] = NULL;
+    }
+
+    ChunkSlab *slab = chunk_slab_map();
+    if (!slab) {
+        return -1;
+    }
+    cache->slabs[slab_index] = slab;
+    if (slab_index == cache->slab_count) {
+        cache->slab_count++;
+    }
+    return slab_index;
+}
+
+void chunk_pool_init(ChunkCache *cache) {
+    cache->slabs = NULL;
+    cache->slab_count = 0;
+    cache->spare_slab = -1;
+    cache->live = NULL;
+    cache->chunk_count = 0;
+    cache->live_capacity = 0;
+    cache->next_generation = 1;
+    cache->read_epoch = 0;
+    memset(cache->readers, 0, sizeof(cache->readers));
+    cache->retired = NULL;
+    cache->deferred = NULL;
+    cache->deferred_count = 0;
+    cache->deferred_capacity = 0;
+}
+
+// Claim a chunk slot. The caller initializes every field except the mutexes and
+// the pool bookkeeping, and inserts it into the hash table.
+Chunk *chunk_pool_alloc(ChunkCache *cache) {
+    if (cache->chunk_count >= cache->live_capacity) {
+        int new_capacity = cache->live_capacity > 0 ? cache->live_capacity * 2 : CHUNK_SLAB_SIZE;
+        Chunk **live = (Chunk **)realloc(cache->live, sizeof(Chunk *) * new_capacity);
+        if (!live) {
+            fprintf(stderr, "[ERROR] Failed to grow chunk list to %d entries\n", new_capacity);
+            return NULL;
+        }
+        cache->live = live;
+        cache->live_capacity = new_capacity;
+    }
+
+    int slab_index = -1;
+    for (int s = 0; s < cache->slab_count; s++) {
+        if (cache->slabs[s] && cache->slabs[s]->free_count > 0) {
+            slab_index = s;
+            break;
+        }
+    }
+    if (slab_index < 0) {
+        slab_index = chunk_pool_add_slab(cache);
+        if (slab_index < 0) {
+            fprintf(stderr, "[ERROR] Failed to map chunk slab (%d chunks live)\n", cache->chunk_count);
+            return NULL;
+        }
+    }
+    if (slab_index == cache->spare_slab) {
+        cache->spare_slab = -1;
+    }
+
+    ChunkSlab *slab = cache->slabs[slab_index];
+    int slot = slab->free_slots[--slab->free_count];
+    Chunk *chunk = &slab->chunks[slot];
+    slab->free_mask &= ~(1ull << slot);
+    if (slab->purged_slots & (1ull << slot)) {
+        // Its pages come back zeroed on first touch; only the mutexes need setup
+        pthread_mutex_init(&chunk->mesh_swap_mutex, NULL);
+        pthread_mutex_init(&chunk->mutex, NULL);
+        slab->purged_slots &= ~(1ull << slot);
+        size_t first = 0;
+        size_t last = 0;
+        chunk_slot_pages(slot, chunk_pool_page_size(), &first, &last);
+        for (size_t page = first; page <= last; page++) {
+            slab->purged_pages &= ~(1ull << page);
+        }
+    }
+
+    chunk->pool_index = ((uint32_t)slab_index << CHUNK_SLAB_SHIFT) | (uint32_t)slot;
+    chunk->generation = cache->next_generation;
+    cache->next_generation += 2; // Stays odd, so it never wraps onto the freed value 0
+    chunk->live_index = cache->chunk_count;
+    cache->live[cache->chunk_count++] = chunk;
+    return chunk;
+}
+
+// Drop a chunk from the live list and invalidate its handles
+static void chunk_pool_unlink(ChunkCache *cache, Chunk *chunk) {
+    // Keep the live list dense: move the last entry into the hole
+    int live_index = chunk->live_index;
+    Chunk *last = cache->live[cache->chunk_count - 1];
+    cache->live[live_index] = last;
+    last->live_index = live_index;
+    cache->chunk_count--;
+
+    chunk->generation = 0; // Invalidates outstanding handles
+    chunk->live_index = -1;
+}
+
+// Push an unlinked chunk's slot back on its slab's free stack
+static void chunk_pool_release_slot(ChunkCache *cache, Chunk *chunk) {
+    int slab_index = (int)(chunk->pool_index >> CHUNK_SLAB_SHIFT);
+    ChunkSlab *slab = cache->slabs[slab_index];
+    int slot = (int)(chunk->pool_index & (CHUNK_SLAB_SIZE - 1));
+    slab->free_slots[slab->free_count++] = (uint16_t)slot;
+    slab->free_mask |= 1ull << slot;
+    chunk_slab_purge_around(slab, slot);
+
+    if (slab->free_count < CHUNK_SLAB_SIZE) {
+        return;
+    }
+
+    // Slab is empty: keep the lower of it and the current spare, unmap the other
+    if (cache->spare_slab < 0) {
+        cache->spare_slab = slab_index;
+    } else if (slab_index < cache->spare_slab) {
+        int released = cache->spare_slab;
+        cache->spare_slab = slab_index;
+        chunk_pool_release_slab(cache, released);
+    } else {
+        chunk_pool_release_slab(cache, slab_index);
+    }
+}
+
+// Retire a chunk that has just been removed from the hash table. It leaves the
+// live list now; its block storage and slot are released by chunk_pool_reclaim
+// once no lock-free reader can still be looking at it.
+void chunk_pool_retire(ChunkCache *cache, Chunk *chunk) {
+    chunk_pool_unlink(cache, chunk);
+    chunk->retired_epoch = __atomic_load_n(&cache->read_epoch, __ATOMIC_SEQ_CST);
+    chunk->retired_next = cache->retired;
+    cache->retired = chunk;
+}
+
+// free() a block that lock-free readers may still be using
+void chunk_pool_defer_free(ChunkCache *cache, void *ptr) {
+    if (cache->deferred_count >= cache->deferred_capacity) {
+        int new_capacity = cache->deferred_capacity > 0 ? cache->deferred_capacity * 2 : 8;
+        ChunkDeferredFree *deferred = (ChunkDeferredFree *)realloc(cache->deferred, sizeof(ChunkDeferredFree) * new_capacity);
+        if (!deferred) {
+            fprintf(stderr, "[ERROR] Failed to defer free of %p, leaking it\n", ptr);
+            return;
+        }
+        cache->deferred = deferred;
+        cache->deferred_capacity = new_capacity;
+    }
+    cache->deferred[cache->deferred_count].ptr = ptr;
+    cache->deferred[cache->deferred_count].epoch = __atomic_load_n(&cache->read_epoch, __ATOMIC_SEQ_CST);
+    cache->deferred_count++;
+}
+
+// Advance the read epoch if the readers of the previous one have all left,
+// then release everything retired at least two epochs ago. Cheap when there is
+// nothing to do; called once per chunk update.
+void chunk_pool_reclaim(ChunkCache *cache) {
+    if (!cache->retired && cache->deferred_count == 0) {
+        return;
+    }
+
+    uint32_t epoch = __atomic_load_n(&cache->read_epoch, __ATOMIC_SEQ_CST);
+    int previous = (int)((epoch + 1) & 1);
+    int active = 0;
+    for (int i = 0; i < CHUNK_READER_SLOTS; i++) {
+        active += __atomic_load_n(&cache->readers[i].count[previous], __ATOMIC_SEQ_CST);
+    }
+    if (active == 0) {
+        epoch++;
+        __atomic_store_n(&cache->read_epoch, epoch, __ATOMIC_SEQ_CST);
+    }
+
+    Chunk **link = &cache->retired;
+    while (*link) {
+        Chunk *chunk = *link;
+        if (epoch - chunk->retired_epoch >= 2) {
+            *link = chunk->retired_next;
+            chunk->retired_next = NULL;
+            chunk_storage_release(chunk);
+            chunk_pool_release_slot(cache, chunk);
+        } else {
+            link = &chunk->retired_next;
+        }
+    }
+
+    int kept = 0;
+    for (int i = 0; i < cache->deferred_count; i++) {
+        if (epoch - cache->deferred[i].epoch >= 2) {
+            free(cache->deferred[i].ptr);
+        } else {
+            cache->deferred[kept++] = cache->deferred[i];
+        }
+    }
+    cache->deferred_count = kept;
+}
+
+// Each thread sticks to one reader slot, picked round-robin on first use
+static _Thread_local int chunk_reader_slot = -1;
+static int chunk_reader_next_slot = 0;
+
+int chunk_read_begin(ChunkCache *cache) {
+    if (chunk_reader_slot < 0) {
+        chunk_reader_slot = __atomic_fetch_add(&chunk_reader_next_slot, 1, __ATOMIC_RELAXED) % CHUNK_READER_SLOTS;
+    }
+    int parity = (int)(__atomic_load_n(&cache->read_epoch, __ATOMIC_SEQ_CST) & 1);
+    __atomic_add_fetch(&cache->readers[chunk_reader_slot].count[parity], 1, __ATOMIC_SEQ_CST);
+    return chunk_reader_slot * 2 + parity;
+}
+
+void chunk_read_end(ChunkCache *cache, int token) {
+    __atomic_sub_fetch(&cache->readers[token / 2].count[token & 1], 1, __ATOMIC_RELEASE);
+}
+
+// Unmap every slab. Live chunks must have had their mesh and storage released;
+// no readers may be left.
+void chunk_pool_destroy(ChunkCache *cache) {
+    for (Chunk *chunk = cache->retired; chunk; chunk = chunk->retired_next) {
+        chunk_storage_release(chunk);
+    }
+    for (int i = 0; i < cache->deferred_count; i++) {
+        free(cache->deferred[i].ptr);
+    }
+    free(cache->deferred);
+    for (int s = 0; s < cache->slab_count; s++) {
+        if (cache->slabs[s]) {
+            chunk_slab_unmap(cache->slabs[s]);
+        }
+    }
+    free(cache->slabs);
+    free(cache->live);
+    chunk_pool_init(cache);
+}
+
+ChunkHandle chunk_pool_handle(const Chunk *chunk) {
+    ChunkHandle handle = {0, 0};
+    if (chunk) {
+        handle.index = chunk->pool_index;
+        handle.generation = chunk->generation;
+    }
+    return handle;
+}
+
+Chunk *chunk_pool_resolve(ChunkCache *cache, ChunkHandle handle) {
+    if (handle.generation == 0) {
+        return NULL;
+    }
+    int slab_index = (int)(handle.index >> CHUNK_SLAB_SHIFT);
+    if (slab_index >= cache->slab_count || !cache->slabs[slab_index]) {
+        return NULL;
+    }
+    Chunk *chunk = &cache->slabs[slab_index]->chunks[handle.index & (CHUNK_SLAB_SIZE - 1)];
+    return chunk->generation == handle.generation ? chunk : NULL;
+}
+
+size_t chunk_pool_reserved_bytes(const ChunkCache *cache) {
+    size_t total = 0;
+    for (int s = 0; s < cache->slab_count; s++) {
+        if (!cache->slabs[s]) {
+            continue;
+        }
+        total += sizeof(ChunkSlab);
+        for (uint64_t pages = cache->slabs[s]->purged_pages; pages; pages &= pages - 1) {
+            total -= chunk_pool_page_size();
+        }
+    }
+    return total;
+}
@@ -0,0 +1,391 @@
+#include <stdlib.h>
+#include <string.h>
+
+#include "../../include/world.h"
+
+// ============================================================================
+// PALETTE-COMPRESSED CHUNK STORAGE
+// ============================================================================
+// Each chunk is split into CHUNK_SECTION_COUNT sections of 32x16x32 blocks.
+// A section is either a single value (all air, all stone, ...) with no heap
+// storage, or a palette of block types plus one bit-packed palette index per
+// block. Index widths are 1, 2, 4 or 8 bits so an index never straddles two
+// 64-bit words.
+//
+// Readers (meshing, saving, world_get_block) read sections without taking the
+// chunk mutex. To keep that safe, packed data is never resized in place: when
+// a section outgrows its index width a new buffer is built and published, and
+// the old one is parked on the section's retired list. Retired buffers are
+// freed in chunk_storage_release, which only runs once the chunk has left the
+// cache and no worker holds it.
+
+#define SECTION_WORDS(bits) ((CHUNK_SECTION_VOLUME * (bits)) / 64)
+
+static inline int section_block_index(int x, int y, int z) {
+    return ((y & (CHUNK_SECTION_HEIGHT - 1)) * CHUNK_DEPTH + z) * CHUNK_WIDTH + x;
+}
+
+static inline uint32_t section_data_get_index(const ChunkSectionData *data, int index) {
+    int bit = index * data->bits;
+    uint64_t word = __atomic_load_n(&data->words[bit >> 6], __ATOMIC_RELAXED);
+    return (uint32_t)(word >> (bit & 63)) & ((1u << data->bits) - 1u);
+}
+
+static inline void section_data_set_index(ChunkSectionData *data, int index, uint32_t palette_index) {
+    int bit = index * data->bits;
+    uint64_t mask = (((uint64_t)1 << data->bits) - 1u) << (bit & 63);
+    uint64_t *word = &data->words[bit >> 6];
+    uint64_t value = (*word & ~mask) | ((uint64_t)palette_index << (bit & 63));
+    __atomic_store_n(word, value, __ATOMIC_RELEASE);
+}
+
+static ChunkSectionData *section_data_alloc(int bits) {
+    size_t size = sizeof(ChunkSectionData) + sizeof(uint64_t) * SECTION_WORDS(bits);
+    ChunkSectionData *data = (ChunkSectionData *)calloc(1, size);
+    if (data) {
+        data->bits = (uint8_t)bits;
+    }
+    return data;
+}
+
+// Smallest supported index width that can address `palette_count` entries
+static int section_bits_for(int palette_count) {
+    int bits = 1;
+    while ((1 << bits) < palette_count) {
+        bits *= 2;
+    }
+    return bits;
+}
+
+static void section_retire(ChunkSection *section, ChunkSectionData *old_data) {
+    if (old_data) {
+        old_data->retired_next = section->retired;
+        section->retired = old_data;
+    }
+}
+
+static void section_publish(ChunkSection *section, ChunkSectionData *data) {
+    ChunkSectionData *old_data = section->data;
+    __atomic_store_n(&section->data, data, __ATOMIC_RELEASE);
+    section_retire(section, old_data);
+}
+
+// Copy `old_data` (or a single value when NULL) into a wider buffer. Returns NULL on allocation failure.
+static ChunkSectionData *section_widen(const ChunkSection *section, const ChunkSectionData *old_data, int bits) {
+    ChunkSectionData *data = section_data_alloc(bits);
+    if (!data) {
+        return NULL;
+    }
+
+    if (!old_data) {
+        // Every index stays 0, pointing at the old single value
+        data->palette[0] = section->single_value;
+        data->palette_count = 1;
+        return data;
+    }
+
+    memcpy(data->palette, old_data->palette, old_data->palette_count);
+    data->palette_count = old_data->palette_count;
+    for (int i = 0; i < CHUNK_SECTION_VOLUME; i++) {
+        section_data_set_index(data, i, section_data_get_index(old_data, i));
+    }
+    return data;
+}
+
+static void section_set(ChunkSection *section, int index, BlockType type) {
+    ChunkSectionData *data = section->data;
+
+    if (!data) {
+        if (section->single_value == (uint8_t)type) {
+            return; // Fast path: writing the value the whole section already holds
+        }
+        data = section_widen(section, NULL, 1);
+        if (!data) {
+            return;
+        }
+        data->palette[1] = (uint8_t)type;
+        data->palette_count = 2;
+        section_data_set_index(data, index, 1);
+        section_publish(section, data);
+        return;
+    }
+
+    int palette_index = -1;
+    for (int i = 0; i < data->palette_count; i++) {
+        if (data->palette[i] == (uint8_t)type) {
+            palette_index = i;
+            break;
+        }
+    }
+
+    if (palette_index < 0) {
+        if (data->palette_count < (1 << data->bits)) {
+            // Room left at the current width; the entry is written before any index refers to it
+            data->palette[data->palette_count] = (uint8_t)type;
+            palette_index = data->palette_count;
+            __atomic_store_n(&data->palette_count, (uint16_t)(data->palette_count + 1), __ATOMIC_RELEASE);
+        } else {
+            ChunkSectionData *wider = section_widen(section, data, data->bits * 2);
+            if (!wider) {
+                return;
+            }
+            wider->palette[wider->palette_count] = (uint8_t)type;
+            palette_index = wider->palette_count;
+            wider->palette_count++;
+            section_data_set_index(wider, index, (uint32_t)palette_index);
+            section_publish(section, wider);
+            return;
+        }
+    }
+
+    section_data_set_index(data, index, (uint32_t)palette_index);
+}
+
+// Reset a chunk's storage to all air without freeing anything. Used on freshly
+// claimed chunk slots whose previous contents were moved or released already.
+void chunk_storage_init(Chunk *chunk) {
+    for (int s = 0; s < CHUNK_SECTION_COUNT; s++) {
+        chunk->sections[s].data = NULL;
+        chunk->sections[s].retired = NULL;
+        chunk->sections[s].single_value = BLOCK_AIR;
+    }
+    // All air: every face sees every other one
+    chunk->visibility = CHUNK_VISIBILITY_ALL;
+    chunk->visibility_dirty = false;
+}
+
+// Free all packed and retired buffers and reset the chunk to all air
+void chunk_storage_release(Chunk *chunk) {
+    for (int s = 0; s < CHUNK_SECTION_COUNT; s++) {
+        ChunkSection *section = &chunk->sections[s];
+        free(section->data);
+        ChunkSectionData *retired = section->retired;
+        while (retired) {
+            ChunkSectionData *next = retired->retired_next;
+            free(retired);
+            retired = next;
+        }
+    }
+    chunk_storage_init(chunk);
+}
+
+// Replace a chunk's contents with a dense block array, choosing the smallest
+// encoding per section
+void chunk_storage_fill(Chunk *chunk, Block (*blocks)[CHUNK_DEPTH][CHUNK_WIDTH]) {
+    for (int s = 0; s < CHUNK_SECTION_COUNT; s++) {
+        ChunkSection *section = &chunk->sections[s];
+        int y0 = s * CHUNK_SECTION_HEIGHT;
+
+        // Build the palette for this section
+        int16_t lookup[256];
+        uint8_t palette[256];
+        int palette_count = 0;
+        memset(lookup, -1, sizeof(lookup));
+        for (int y = y0; y < y0 + CHUNK_SECTION_HEIGHT; y++) {
+            for (int z = 0; z < CHUNK_DEPTH; z++) {
+                for (int x = 0; x < CHUNK_WIDTH; x++) {
+                    uint8_t type = (uint8_t)blocks[y][z][x].type;
+                    if (lookup[type] < 0) {
+                        lookup[type] = (int16_t)palette_count;
+                        palette[palette_count++] = type;
+                    }
+                }
+            }
+        }
+
+        if (palette_count == 1) {
+            // Uniform section (all air, all stone, ...): no index storage at all
+            section->single_value = palette[0];
+            section_publish(section, NULL);
+            continue;
+        }
+
+        ChunkSectionData *data = section_data_alloc(section_bits_for(palette_count));
+        if (!data) {
+            continue;
+        }
+        memcpy(data->palette, palette, palette_count);
+        data->palette_count = (uint16_t)palette_count;
+        for (int y = y0; y < y0 + CHUNK_SECTION_HEIGHT; y++) {
+            for (int z = 0; z < CHUNK_DEPTH; z++) {
+                for (int x = 0; x < CHUNK_WIDTH; x++) {
+                    section_data_set_index(data, section_block_index(x, y, z), (uint32_t)lookup[(uint8_t)blocks[y][z][x].type]);
+                }
+            }
+        }
+        section_publish(section, data);
+    }
+    // New contents: the next mesh recomputes the visibility graph
+    __atomic_store_n(&chunk->visibility_dirty, true, __ATOMIC_RELEASE);
+}
+
+// Pack one palette index per byte of `span` into `words`, `bits` per index. Inlined with
+// a constant width so the inner loop unrolls.
+static inline void section_pack_span(uint64_t *words, const uint8_t *span, const uint8_t lookup[256], int bits) {
+    const int per_word = 64 / bits;
+    for (int w = 0; w < CHUNK_SECTION_VOLUME / per_word; w++) {
+        const uint8_t *src = span + w * per_word;
+        uint64_t word = 0;
+        for (int i = 0; i < per_word; i++) {
+            word |= (uint64_t)lookup[src[i]] << (i * bits);
+        }
+        words[w] = word;
+    }
+}
+
+// Replace a chunk's contents with one block type byte per block, y then z then x
+// (x fastest), the layout of saved chunks. Every section is one contiguous span of
+// `types`, so uniform sections are found with a single compare and the rest are
+// packed a whole word at a time before being published.
+void chunk_storage_fill_types(Chunk *chunk, const uint8_t *types) {
+    for (int s = 0; s < CHUNK_SECTION_COUNT; s++) {
+        ChunkSection *section = &chunk->sections[s];
+        const uint8_t *span = types + (size_t)s * CHUNK_SECTION_VOLUME;
+
+        // Every byte equals its successor: the whole section is one block type
+        if (memcmp(span, span + 1, CHUNK_SECTION_VOLUME - 1) == 0) {
+            section->single_value = span[0];
+            section_publish(section, NULL);
+            continue;
+        }
+
+        // Palette in block type order; marking without a branch per block keeps the scan cheap
+        uint8_t present[256] = {0};
+        for (int i = 0; i < CHUNK_SECTION_VOLUME; i++) {
+            present[span[i]] = 1;
+        }
+        uint8_t lookup[256];
+        uint8_t palette[256];
+        int palette_count = 0;
+        for (int type = 0; type < 256; type++) {
+            if (present[type]) {
+                lookup[type] = (uint8_t)palette_count;
+                palette[palette_count++] = (uint8_t)type;
+            }
+        }
+
+        int bits = section_bits_for(palette_count);
+        ChunkSectionData *data = section_data_alloc(bits);
+        if (!data) {
+            continue;
+        }
+        memcpy(data->palette, palette, palette_count);
+        data->palette_count = (uint16_t)palette_count;
+        // Not yet visible to readers: plain stores, published below with release order
+        switch (bits) {
+        case 1:
+            section_pack_span(data->words, span, lookup, 1);
+            break;
+        case 2:
+            section_pack_span(data->words, span, lookup, 2);
+            break;
+        case 4:
+            section_pack_span(data->words, span, lookup, 4);
+            break;
+        default:
+            section_pack_span(data->words, span, lookup, 8);
+            break;
+        }
+        section_publish(section, data);
+    }
+    __atomic_store_n(&chunk->visibility_dirty, true, __ATOMIC_RELEASE);
+}
+
+// Inverse of section_pack_span: palette entries of every index of `data`
+static inline void section_unpack_span(const ChunkSectionData *data, uint8_t *span, int bits) {
+    const int per_word = 64 / bits;
+    const uint64_t mask = ((uint64_t)1 << bits) - 1u;
+    uint8_t palette[256]; // Local copy: stores to `span` can't alias it, so it stays in cache lines the compiler trusts
+    memcpy(palette, data->palette, (size_t)1 << bits);
+    for (int w = 0; w < CHUNK_SECTION_VOLUME / per_word; w++) {
+        uint64_t word = __atomic_load_n(&data->words[w], __ATOMIC_RELAXED);
+        uint8_t *dst = span + w * per_word;
+        for (int i = 0; i < per_word; i++) {
+            dst[i] = palette[(word >> (i * bits)) & mask];
+        }
+    }
+}
+
+// Decode the whole chunk into one block type byte per block, y then z then x, the layout
+// chunk_storage_fill_types takes. Unpacks a word at a time instead of block by block.
+void chunk_storage_read_types(const Chunk *chunk, uint8_t *types) {
+    for (int s = 0; s < CHUNK_SECTION_COUNT; s++) {
+        const ChunkSection *section = &chunk->sections[s];
+        const ChunkSectionData *data = __atomic_load_n(&section->data, __ATOMIC_ACQUIRE);
+        uint8_t *span = types + (size_t)s * CHUNK_SECTION_VOLUME;
+        if (!data) {
+            memset(span, section->single_value, CHUNK_SECTION_VOLUME);
+            continue;
+        }
+        switch (data->bits) {
+        case 1:
+            section_unpack_span(data, span, 1);
+            break;
+        case 2:
+            section_unpack_span(data, span, 2);
+            break;
+        case 4:
+            section_unpack_span(data, span, 4);
+            break;
+        default:
+            section_unpack_span(data, span, 8);
+            break;
+        }
+    }
+}
+
+// Heap bytes held by a chunk's block storage (packed and retired buffers)
+size_t chunk_storage_bytes(const Chunk *chunk) {
+    size_t total = 0;
+    for (int s = 0; s < CHUNK_SECTION_COUNT; s++) {
+        const ChunkSection *section = &chunk->sections[s];
+        if (section->data) {
+            total += sizeof(ChunkSectionData) + sizeof(uint64_t) * SECTION_WORDS(section->data->bits);
+        }
+        for (const ChunkSectionData *retired = section->retired; retired; retired = retired->retired_next) {
+            total += sizeof(ChunkSectionData) + sizeof(uint64_t) * SECTION_WORDS(retired->bits);
+        }
+    }
+    return total;
+}
+
+// Decode one row of CHUNK_WIDTH blocks (fixed y and z) into block types.
+// Cheaper than CHUNK_WIDTH world_chunk_get_block calls: the section and its
+// buffer are resolved once, and uniform sections are a single memset.
+void chunk_storage_read_row(const Chunk *chunk, int y, int z, uint8_t out[CHUNK_WIDTH]) {
+    const ChunkSection *section = &chunk->sections[y / CHUNK_SECTION_HEIGHT];
+    const ChunkSectionData *data = __atomic_load_n(&section->data, __ATOMIC_ACQUIRE);
+    if (!data) {
+        memset(out, section->single_value, CHUNK_WIDTH);
+        return;
+    }
+    int base = section_block_index(0, y, z);
+    for (int x = 0; x < CHUNK_WIDTH; x++) {
+        out[x] = data->palette[section_data_get_index(data, base + x)];
+    }
+}
+
+// Set block within a chunk
+void world_chunk_set_block(Chunk *chunk, int x, int y, int z, BlockType type) {
+    if (x >= 0 && x < CHUNK_WIDTH &&
+        y >= 0 && y < CHUNK_HEIGHT &&
+        z >= 0 && z < CHUNK_DEPTH) {
+        section_set(&chunk->sections[y / CHUNK_SECTION_HEIGHT], section_block_index(x, y, z), type);
+        chunk->modified = true; // Mark chunk as modified when block changes
+    }
+}
+
+// Get block within a chunk
+BlockType world_chunk_get_block(Chunk *chunk, int x, int y, int z) {
+    if (x >= 0 && x < CHUNK_WIDTH &&
+        y >= 0 && y < CHUNK_HEIGHT &&
+        z >= 0 && z < CHUNK_DEPTH) {
+        const ChunkSection *section = &chunk->sections[y / CHUNK_SECTION_HEIGHT];
+        const ChunkSectionData *data = __atomic_load_n(&section->data, __ATOMIC_ACQUIRE);
+        if (!data) {
+            return (BlockType)section->single_value;
+        }
+        return (BlockType)data->palette[section_data_get_index(data, section_block_index(x, y, z))];
+    }
+    return BLOCK_AIR;
+}
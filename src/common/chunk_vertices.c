@@ -0,0 +1,186 @@
+#include <stdlib.h>
+
+#include "../../include/world.h"
+
+// ============================================================================
+// CHUNK VERTEX BAKING
+// ============================================================================
+// Turns a chunk's merged quads into one packed triangle list that the client
+// uploads to a GPU vertex buffer once per remesh, instead of rebuilding every
+// face on the CPU each frame. All detail levels share the buffer, one after
+// the other; within a level vertices are grouped by texture layer so each
+// layer is a single draw call, opaque layers first, transparent ones last.
+// Nothing here touches the GPU, so the server build and headless tools can
+// run it too.
+
+// Face shading: how bright each face appears based on orientation
+const float block_face_shading[6] = {
+    0.85f, // +X (right side) - medium
+    0.85f, // -X (left side) - medium
+    1.0f,  // +Y (top) - fully lit
+    0.6f,  // -Y (bottom) - dark
+    0.9f,  // +Z (front) - slightly brighter
+    0.8f   // -Z (back) - slightly darker
+};
+
+// Texture coordinates per face vertex, in the vertex order of chunk_quad_corners
+const Vector2 block_face_uv[6][4] = {
+    {{0, 1}, {0, 0}, {1, 0}, {1, 1}}, // +X
+    {{1, 1}, {1, 0}, {0, 0}, {0, 1}}, // -X
+    {{0, 0}, {1, 0}, {1, 1}, {0, 1}}, // +Y
+    {{1, 0}, {0, 0}, {0, 1}, {1, 1}}, // -Y
+    {{0, 1}, {1, 1}, {1, 0}, {0, 0}}, // +Z
+    {{1, 1}, {0, 1}, {0, 0}, {1, 0}}  // -Z
+};
+
+// The four corners of a quad's face, chunk-local, plus the texture repeat counts
+static void chunk_quad_corners(const MergedQuad *quad, int origin_x, int origin_y, int origin_z,
+                               int corners[4][3], int *u_scale, int *v_scale) {
+    // Box covered by the quad's blocks: w and h along the face's in-plane axes, one block thick
+    int size_x = 1, size_y = 1, size_z = 1;
+    switch (quad->face) {
+    case 0:
+    case 1: // X faces: w along z, h along y
+        size_z = quad->w;
+        size_y = quad->h;
+        *u_scale = size_z;
+        *v_scale = size_y;
+        break;
+    case 2:
+    case 3: // Y faces: w along x, h along z
+        size_x = quad->w;
+        size_z = quad->h;
+        *u_scale = size_x;
+        *v_scale = size_z;
+        break;
+    default: // Z faces: w along x, h along y
+        size_x = quad->w;
+        size_y = quad->h;
+        *u_scale = size_x;
+        *v_scale = size_y;
+        break;
+    }
+
+    int x0 = quad->x - origin_x;
+    int y0 = quad->y - origin_y;
+    int z0 = quad->z - origin_z;
+    int x1 = x0 + size_x;
+    int y1 = y0 + size_y;
+    int z1 = z0 + size_z;
+
+    const int face_corners[6][4][3] = {
+        {{x1, y0, z0}, {x1, y1, z0}, {x1, y1, z1}, {x1, y0, z1}}, // right (+X)
+        {{x0, y0, z1}, {x0, y1, z1}, {x0, y1, z0}, {x0, y0, z0}}, // left (-X)
+        {{x0, y1, z1}, {x1, y1, z1}, {x1, y1, z0}, {x0, y1, z0}}, // top (+Y)
+        {{x1, y0, z1}, {x0, y0, z1}, {x0, y0, z0}, {x1, y0, z0}}, // bottom (-Y)
+        {{x0, y0, z1}, {x1, y0, z1}, {x1, y1, z1}, {x0, y1, z1}}, // front (+Z)
+        {{x1, y0, z0}, {x0, y0, z0}, {x0, y1, z0}, {x1, y1, z0}}  // back (-Z)
+    };
+    for (int i = 0; i < 4; i++) {
+        corners[i][0] = face_corners[quad->face][i][0];
+        corners[i][1] = face_corners[quad->face][i][1];
+        corners[i][2] = face_corners[quad->face][i][2];
+    }
+}
+
+// Bake mesh->quads, then the quads of each coarser level in lods (CHUNK_LOD_LEVELS - 1
+// entries, NULL for an empty level; lods itself may be NULL), into mesh->vertices and
+// mesh->ranges, two triangles per quad. Returns false (leaving the mesh without vertices)
+// on allocation failure.
+bool chunk_mesh_build_vertices(MergedMesh *mesh, const Chunk *chunk, MergedMesh *const *lods) {
+    int origin_x = chunk->chunk_x * CHUNK_WIDTH;
+    int origin_y = chunk->chunk_y * CHUNK_HEIGHT;
+    int origin_z = chunk->chunk_z * CHUNK_DEPTH;
+
+    const MergedMesh *levels[CHUNK_LOD_LEVELS] = {mesh};
+    for (int lod = 1; lod < CHUNK_LOD_LEVELS; lod++) {
+        levels[lod] = lods ? lods[lod - 1] : NULL;
+    }
+
+    // Count quads per level and layer
+    int layer_quads[CHUNK_LOD_LEVELS][CHUNK_MESH_LAYER_COUNT] = {{0}};
+    int total_quads = 0;
+    for (int lod = 0; lod < CHUNK_LOD_LEVELS; lod++) {
+        for (int f = 0; levels[lod] && f < 6; f++) {
+            for (int i = 0; i < levels[lod]->quad_count[f]; i++) {
+                const MergedQuad *quad = &levels[lod]->quads[f][i];
+                layer_quads[lod][chunk_mesh_layer(quad->type, block_face_group(quad->face))]++;
+                total_quads++;
+            }
+        }
+    }
+
+    free(mesh->vertices);
+    mesh->vertices = NULL;
+    mesh->vertex_count = 0;
+    mesh->range_count = 0;
+    for (int lod = 0; lod <= CHUNK_LOD_LEVELS; lod++) {
+        mesh->lod_ranges[lod] = 0;
+    }
+    if (total_quads == 0) {
+        return true;
+    }
+
+    ChunkVertex *vertices = (ChunkVertex *)malloc(sizeof(ChunkVertex) * 6 * total_quads);
+    if (!vertices) {
+        return false;
+    }
+
+    // Lay out one range per used layer, level by level, opaque layers before transparent ones
+    int layer_next[CHUNK_LOD_LEVELS][CHUNK_MESH_LAYER_COUNT];
+    int next_vertex = 0;
+    for (int lod = 0; lod < CHUNK_LOD_LEVELS; lod++) {
+        mesh->lod_ranges[lod] = mesh->range_count;
+        for (int pass = 0; pass < 2; pass++) {
+            for (int layer = 0; layer < CHUNK_MESH_LAYER_COUNT; layer++) {
+                bool transparent = block_is_transparent((BlockType)(layer / 3));
+                if (layer_quads[lod][layer] == 0 || transparent != (pass == 1)) {
+                    continue;
+                }
+                ChunkMeshRange *range = &mesh->ranges[mesh->range_count++];
+                range->layer = (uint8_t)layer;
+                range->transparent = transparent;
+                range->first_vertex = next_vertex;
+                range->vertex_count = layer_quads[lod][layer] * 6;
+                layer_next[lod][layer] = next_vertex;
+                next_vertex += range->vertex_count;
+            }
+        }
+    }
+    mesh->lod_ranges[CHUNK_LOD_LEVELS] = mesh->range_count;
+
+    // Two triangles per quad: corners 0-1-2 and 0-2-3
+    static const int triangle_corners[6] = {0, 1, 2, 0, 2, 3};
+    for (int lod = 0; lod < CHUNK_LOD_LEVELS; lod++) {
+        for (int f = 0; levels[lod] && f < 6; f++) {
+            uint8_t shade = (uint8_t)(255.0f * block_face_shading[f]);
+            for (int i = 0; i < levels[lod]->quad_count[f]; i++) {
+                const MergedQuad *quad = &levels[lod]->quads[f][i];
+                uint8_t layer = chunk_mesh_layer(quad->type, block_face_group(f));
+
+                int corners[4][3];
+                int u_scale, v_scale;
+                chunk_quad_corners(quad, origin_x, origin_y, origin_z, corners, &u_scale, &v_scale);
+
+                ChunkVertex *out = &vertices[layer_next[lod][layer]];
+                layer_next[lod][layer] += 6;
+                for (int k = 0; k < 6; k++) {
+                    int c = triangle_corners[k];
+                    out[k] = (ChunkVertex){
+                        .x = (uint8_t)corners[c][0],
+                        .y = (uint8_t)corners[c][1],
+                        .z = (uint8_t)corners[c][2],
+                        .layer = layer,
+                        .u = (uint8_t)(block_face_uv[f][c].x * u_scale),
+                        .v = (uint8_t)(block_face_uv[f][c].y * v_scale),
+                        .color = {shade, shade, shade, 255},
+                    };
+                }
+            }
+        }
+    }
+
+    mesh->vertices = vertices;
+    mesh->vertex_count = next_vertex;
+    return true;
+}
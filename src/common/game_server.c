@@ -407,6 +407,7 @@ void game_server_set_interest(GameServer *srv, Vector3 position, Vector3 forward
     srv->interest_position = position;
     srv->interest_forward = forward;
     srv->render_distance_blocks = render_distance_blocks;
+    worker_set_interest(srv->world, position, forward);
 }
 
 void game_server_tick(GameServer *srv, float fixed_dt) {
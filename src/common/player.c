@@ -63,7 +63,7 @@ bool world_check_collision_box(World *world, Vector3 center_pos, float width, fl
     for (int y = min_y; y <= max_y; y++) {
         for (int z = min_z; z <= max_z; z++) {
             for (int x = min_x; x <= max_x; x++) {
-                BlockType block = world_get_block(world, x, y, z);
+                BlockType block = world_get_block_or_solid(world, x, y, z);
                 if (block != BLOCK_AIR) {
                     float block_min_x = (float)x;
                     float block_max_x = (float)(x + 1);
@@ -130,7 +130,7 @@ void player_update(Player *player, World *world, float dt, bool flight_enabled)
                 int bx = (int)floorf(foot_pos.x + dx);
                 int by = (int)floorf(foot_pos.y - 0.05f);
                 int bz = (int)floorf(foot_pos.z + dz);
-                if (world_get_block(world, bx, by, bz) != BLOCK_AIR) {
+                if (world_get_block_or_solid(world, bx, by, bz) != BLOCK_AIR) {
                     any_supported = true;
                     break;
                 }
@@ -0,0 +1,776 @@
+#include <dirent.h>
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#ifndef _WIN32
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
+
+#include "../../include/world.h"
+
+// ============================================================================
+// REGION FILES
+// ============================================================================
+// Chunks are stored REGION_WIDTH x REGION_HEIGHT x REGION_WIDTH to a file
+// (./worlds/<name>/chunks/region_X_Y_Z.b3dr) instead of one file each, so a
+// large world is a few dozen files and loading a chunk costs no open() or
+// directory lookup once its region is open.
+//
+// Layout, all integers little endian:
+//   bytes 0-3    magic "B3DR"
+//   bytes 4-7    format version
+//   bytes 8-15   reserved
+//   bytes 16-    one entry per chunk (x fastest, then z, then y): first sector
+//                (0 = chunk not stored) and record length in bytes
+// The header is padded to REGION_HEADER_SECTORS sectors of REGION_SECTOR_SIZE
+// bytes. Each record starts on a sector boundary and is exactly what a chunk
+// file used to contain, so old files migrate by plain copy.
+//
+// Records are never overwritten in place. A save goes to the first run of free
+// sectors large enough (sectors freed by earlier saves are reused) or to the end
+// of the file, and only once its data is written (and synced, if asked) does the
+// table entry switch over to it and the old sectors become free. A crash at any
+// point leaves each chunk's entry pointing at either its old or its new record,
+// both complete: the region file equivalent of writing a temp file and renaming.
+//
+// Open regions are kept in a small cache shared by all threads. Each region
+// has its own mutex, so the save thread writing one region never holds up
+// workers loading chunks of another.
+//
+// Loads read records in place through a read-only mapping of the file instead
+// of copying them out. The mapping is only entered under the region mutex to
+// look the record up; decoding happens unlocked. That is safe because a
+// record's sectors only change when the same chunk is saved, and a chunk is
+// never saved while it is being loaded (it keeps its cache slot until saved).
+// Mappings extend past the end of the file so appends rarely need a new one;
+// an outgrown mapping stays until the region closes, as views may point into it.
+// region_ref_chunk hands out the record's file offset instead, for readers that
+// issue their own reads (chunk_io.c); the same argument covers those.
+
+#define REGION_CHUNKS (REGION_WIDTH * REGION_WIDTH * REGION_HEIGHT)
+#define REGION_TABLE_OFFSET 16
+#define REGION_HEADER_SECTORS ((REGION_TABLE_OFFSET + REGION_CHUNKS * 8 + REGION_SECTOR_SIZE - 1) / REGION_SECTOR_SIZE)
+#define REGION_CACHE_SIZE 32 // Open region files kept at once
+#define REGION_MAX_SECTORS (1u << 20) // Sanity bound on entries read from disk (4 GiB)
+#define REGION_MAP_MIN_SIZE (1u << 22) // Smallest file mapping, grown by doubling
+
+static const char REGION_FILE_MAGIC[4] = {'B', '3', 'D', 'R'};
+static const uint32_t REGION_FILE_VERSION = 1;
+
+typedef struct RegionMapping {
+    uint8_t *base;
+    size_t size;
+    struct RegionMapping *next;
+} RegionMapping;
+
+struct RegionFile {
+    char path[512];
+    FILE *file;
+    uint32_t first_sector[REGION_CHUNKS]; // 0 when the chunk is not stored
+    uint32_t length[REGION_CHUNKS];       // Record length in bytes
+    uint8_t *sector_used;                 // One byte per sector of the file
+    uint32_t sector_count;                // File length in sectors
+    uint32_t sector_capacity;
+    RegionMapping *maps;   // Read-only mappings of the file, newest (largest) first
+    pthread_mutex_t mutex; // Guards everything above
+    int users;             // Threads between region_acquire and region_release, plus open views
+    uint64_t last_use;
+};
+
+static struct {
+    pthread_mutex_t mutex;
+    RegionFile **open;
+    int count;
+    int capacity;
+    uint64_t clock;
+} region_cache = {PTHREAD_MUTEX_INITIALIZER, NULL, 0, 0, 0};
+
+static int32_t region_floor_div(int32_t value, int32_t size) {
+    return value < 0 ? (value - size + 1) / size : value / size;
+}
+
+static void region_put_le32(uint8_t *dst, uint32_t value) {
+    dst[0] = (uint8_t)(value & 0xFF);
+    dst[1] = (uint8_t)((value >> 8) & 0xFF);
+    dst[2] = (uint8_t)((value >> 16) & 0xFF);
+    dst[3] = (uint8_t)((value >> 24) & 0xFF);
+}
+
+static uint32_t region_get_le32(const uint8_t *src) {
+    return (uint32_t)src[0] | ((uint32_t)src[1] << 8) | ((uint32_t)src[2] << 16) | ((uint32_t)src[3] << 24);
+}
+
+// Region file path and entry index of a chunk
+static int region_locate(const char *world_name, int32_t chunk_x, int32_t chunk_y, int32_t chunk_z,
+                         char *path, size_t path_size) {
+    int32_t region_x = region_floor_div(chunk_x, REGION_WIDTH);
+    int32_t region_y = region_floor_div(chunk_y, REGION_HEIGHT);
+    int32_t region_z = region_floor_div(chunk_z, REGION_WIDTH);
+    snprintf(path, path_size, "./worlds/%s/chunks/region_%d_%d_%d.b3dr", world_name, region_x, region_y, region_z);
+    int local_x = chunk_x - region_x * REGION_WIDTH;
+    int local_y = chunk_y - region_y * REGION_HEIGHT;
+    int local_z = chunk_z - region_z * REGION_WIDTH;
+    return (local_y * REGION_WIDTH + local_z) * REGION_WIDTH + local_x;
+}
+
+static bool region_reserve_sectors(RegionFile *region, uint32_t count) {
+    if (count <= region->sector_capacity) {
+        return true;
+    }
+    uint32_t capacity = region->sector_capacity ? region->sector_capacity : 256;
+    while (capacity < count) {
+        capacity *= 2;
+    }
+    uint8_t *used = (uint8_t *)realloc(region->sector_used, capacity);
+    if (!used) {
+        return false;
+    }
+    memset(used + region->sector_capacity, 0, capacity - region->sector_capacity);
+    region->sector_used = used;
+    region->sector_capacity = capacity;
+    return true;
+}
+
+static void region_mark_sectors(RegionFile *region, uint32_t first, uint32_t count, uint8_t used) {
+    for (uint32_t s = first; s < first + count && s < region->sector_capacity; s++) {
+        region->sector_used[s] = used;
+    }
+}
+
+static uint32_t region_sectors_for(uint32_t length) {
+    return (length + REGION_SECTOR_SIZE - 1) / REGION_SECTOR_SIZE;
+}
+
+// Read the header and rebuild the free sector map. Entries that point outside the
+// file or overlap an earlier entry are dropped, which loses only those chunks.
+static bool region_read_header(RegionFile *region) {
+    uint8_t header[REGION_HEADER_SECTORS * REGION_SECTOR_SIZE];
+    if (fseek(region->file, 0, SEEK_END) != 0) {
+        return false;
+    }
+    long file_size = ftell(region->file);
+    if (file_size < (long)sizeof(header) || fseek(region->file, 0, SEEK_SET) != 0 ||
+        fread(header, 1, sizeof(header), region->file) != sizeof(header)) {
+        printf("[region] %s: truncated header\n", region->path);
+        return false;
+    }
+    if (memcmp(header, REGION_FILE_MAGIC, sizeof(REGION_FILE_MAGIC)) != 0 ||
+        region_get_le32(header + 4) != REGION_FILE_VERSION) {
+        printf("[region] %s: not a region file (or unsupported version)\n", region->path);
+        return false;
+    }
+
+    region->sector_count = (uint32_t)(((uint64_t)file_size + REGION_SECTOR_SIZE - 1) / REGION_SECTOR_SIZE);
+    if (!region_reserve_sectors(region, region->sector_count)) {
+        return false;
+    }
+    region_mark_sectors(region, 0, REGION_HEADER_SECTORS, 1);
+
+    int dropped = 0;
+    for (int i = 0; i < REGION_CHUNKS; i++) {
+        uint32_t first = region_get_le32(header + REGION_TABLE_OFFSET + i * 8);
+        uint32_t length = region_get_le32(header + REGION_TABLE_OFFSET + i * 8 + 4);
+        region->first_sector[i] = 0;
+        region->length[i] = 0;
+        if (first == 0) {
+            continue;
+        }
+        uint32_t count = region_sectors_for(length);
+        bool valid = length > 0 && first >= REGION_HEADER_SECTORS && first < REGION_MAX_SECTORS &&
+                     count <= region->sector_count && first <= region->sector_count - count;
+        for (uint32_t s = first; valid && s < first + count; s++) {
+            valid = !region->sector_used[s];
+        }
+        if (!valid) {
+            dropped++;
+            continue;
+        }
+        region->first_sector[i] = first;
+        region->length[i] = length;
+        region_mark_sectors(region, first, count, 1);
+    }
+    if (dropped > 0) {
+        printf("[region] %s: dropped %d invalid chunk entries\n", region->path, dropped);
+    }
+    return true;
+}
+
+// Write an empty header to a new region file
+static bool region_init_file(RegionFile *region) {
+    uint8_t header[REGION_HEADER_SECTORS * REGION_SECTOR_SIZE];
+    memset(header, 0, sizeof(header));
+    memcpy(header, REGION_FILE_MAGIC, sizeof(REGION_FILE_MAGIC));
+    region_put_le32(header + 4, REGION_FILE_VERSION);
+    if (fwrite(header, 1, sizeof(header), region->file) != sizeof(header) || fflush(region->file) != 0) {
+        return false;
+    }
+    region->sector_count = REGION_HEADER_SECTORS;
+    if (!region_reserve_sectors(region, region->sector_count)) {
+        return false;
+    }
+    region_mark_sectors(region, 0, REGION_HEADER_SECTORS, 1);
+    return true;
+}
+
+static void region_close(RegionFile *region) {
+    while (region->maps) {
+        RegionMapping *next = region->maps->next;
+#ifndef _WIN32
+        munmap(region->maps->base, region->maps->size);
+#endif
+        free(region->maps);
+        region->maps = next;
+    }
+    if (region->file) {
+        fclose(region->file);
+    }
+    free(region->sector_used);
+    pthread_mutex_destroy(&region->mutex);
+    free(region);
+}
+
+// Open a region file, creating it when `create` is set. NULL if it doesn't exist (and
+// create is false) or can't be used.
+static RegionFile *region_open(const char *path, bool create) {
+    RegionFile *region = (RegionFile *)calloc(1, sizeof(RegionFile));
+    if (!region) {
+        return NULL;
+    }
+    snprintf(region->path, sizeof(region->path), "%s", path);
+    pthread_mutex_init(&region->mutex, NULL);
+
+    region->file = fopen(path, "r+b");
+    bool ok = false;
+    if (region->file) {
+        ok = region_read_header(region);
+    } else if (create) {
+        region->file = fopen(path, "w+b");
+        ok = region->file && region_init_file(region);
+    }
+    if (!ok) {
+        region_close(region);
+        return NULL;
+    }
+    return region;
+}
+
+// Find the region in the cache or open it, and lock it; pair with region_release. Past
+// REGION_CACHE_SIZE open regions the least recently used one nobody holds is closed; if
+// every one is held the cache grows instead, so a region is never open twice.
+static RegionFile *region_acquire(const char *path, bool create) {
+    pthread_mutex_lock(&region_cache.mutex);
+    RegionFile *region = NULL;
+    for (int i = 0; i < region_cache.count; i++) {
+        if (strcmp(region_cache.open[i]->path, path) == 0) {
+            region = region_cache.open[i];
+            break;
+        }
+    }
+
+    if (!region) {
+        if (region_cache.count >= REGION_CACHE_SIZE) {
+            int victim = -1;
+            for (int i = 0; i < region_cache.count; i++) {
+                RegionFile *candidate = region_cache.open[i];
+                if (candidate->users == 0 && (victim < 0 || candidate->last_use < region_cache.open[victim]->last_use)) {
+                    victim = i;
+                }
+            }
+            if (victim >= 0) {
+                region_close(region_cache.open[victim]);
+                region_cache.open[victim] = region_cache.open[--region_cache.count];
+            }
+        }
+        if (region_cache.count == region_cache.capacity) {
+            int capacity = region_cache.capacity ? region_cache.capacity * 2 : REGION_CACHE_SIZE;
+            RegionFile **open = (RegionFile **)realloc(region_cache.open, sizeof(RegionFile *) * capacity);
+            if (open) {
+                region_cache.open = open;
+                region_cache.capacity = capacity;
+            }
+        }
+        if (region_cache.count < region_cache.capacity) {
+            region = region_open(path, create);
+            if (region) {
+                region_cache.open[region_cache.count++] = region;
+            }
+        }
+    }
+
+    if (region) {
+        region->users++;
+        region->last_use = ++region_cache.clock;
+    }
+    pthread_mutex_unlock(&region_cache.mutex);
+
+    if (region) {
+        pthread_mutex_lock(&region->mutex);
+    }
+    return region;
+}
+
+// Let the cache close the region again (once nobody else holds it)
+static void region_unpin(RegionFile *region) {
+    pthread_mutex_lock(&region_cache.mutex);
+    region->users--;
+    pthread_mutex_unlock(&region_cache.mutex);
+}
+
+static void region_release(RegionFile *region) {
+    pthread_mutex_unlock(&region->mutex);
+    region_unpin(region);
+}
+
+// Base of a mapping covering at least the first `end` bytes of the file, NULL if the
+// file can't be mapped. Call with the region locked.
+static const uint8_t *region_map(RegionFile *region, size_t end) {
+#ifdef _WIN32
+    (void)region;
+    (void)end;
+    return NULL; // Records are copied out with fread instead
+#else
+    if (region->maps && region->maps->size >= end) {
+        return region->maps->base;
+    }
+    size_t size = REGION_MAP_MIN_SIZE;
+    while (size < end || size < (size_t)region->sector_count * REGION_SECTOR_SIZE) {
+        size *= 2;
+    }
+    RegionMapping *mapping = (RegionMapping *)malloc(sizeof(RegionMapping));
+    if (!mapping) {
+        return NULL;
+    }
+    void *base = mmap(NULL, size, PROT_READ, MAP_SHARED, fileno(region->file), 0);
+    if (base == MAP_FAILED) {
+        free(mapping);
+        return NULL;
+    }
+    mapping->base = (uint8_t *)base;
+    mapping->size = size;
+    mapping->next = region->maps;
+    region->maps = mapping;
+    return mapping->base;
+#endif
+}
+
+bool region_map_chunk(const char *world_name, int32_t chunk_x, int32_t chunk_y, int32_t chunk_z,
+                      RegionChunkView *view) {
+    memset(view, 0, sizeof(*view));
+    char path[512];
+    int index = region_locate(world_name, chunk_x, chunk_y, chunk_z, path, sizeof(path));
+    RegionFile *region = region_acquire(path, false);
+    if (!region) {
+        return false;
+    }
+
+    uint32_t first = region->first_sector[index];
+    uint32_t length = region->length[index];
+    if (first != 0) {
+        size_t offset = (size_t)first * REGION_SECTOR_SIZE;
+        const uint8_t *base = region_map(region, offset + length);
+        if (base) {
+            view->data = base + offset;
+            view->size = length;
+            view->region = region;
+        } else {
+            uint8_t *copy = (uint8_t *)malloc(length);
+            if (copy && fseek(region->file, (long)offset, SEEK_SET) == 0 &&
+                fread(copy, 1, length, region->file) == length) {
+                view->data = copy;
+                view->size = length;
+                view->copy = copy;
+            } else {
+                printf("[region] %s: failed to read chunk %d,%d,%d\n", path, chunk_x, chunk_y, chunk_z);
+                free(copy);
+            }
+        }
+    }
+
+    if (view->region) {
+        pthread_mutex_unlock(&region->mutex); // Still pinned open until region_unmap_chunk
+    } else {
+        region_release(region);
+    }
+    return view->data != NULL;
+}
+
+void region_unmap_chunk(RegionChunkView *view) {
+    free(view->copy);
+    if (view->region) {
+        region_unpin(view->region);
+    }
+    memset(view, 0, sizeof(*view));
+}
+
+bool region_ref_chunk(const char *world_name, int32_t chunk_x, int32_t chunk_y, int32_t chunk_z,
+                      RegionChunkRef *ref) {
+    memset(ref, 0, sizeof(*ref));
+    ref->fd = -1;
+    char path[512];
+    int index = region_locate(world_name, chunk_x, chunk_y, chunk_z, path, sizeof(path));
+    RegionFile *region = region_acquire(path, false);
+    if (!region) {
+        return false;
+    }
+
+    uint32_t first = region->first_sector[index];
+    if (first == 0) {
+        region_release(region);
+        return false;
+    }
+    // Writes always flush, so a read through the descriptor sees everything stdio wrote
+    ref->fd = fileno(region->file);
+    ref->offset = (uint64_t)first * REGION_SECTOR_SIZE;
+    ref->size = region->length[index];
+    ref->region = region;
+    pthread_mutex_unlock(&region->mutex); // Still pinned open until region_unref_chunk
+    return true;
+}
+
+void region_unref_chunk(RegionChunkRef *ref) {
+    if (ref->region) {
+        region_unpin(ref->region);
+    }
+    memset(ref, 0, sizeof(*ref));
+    ref->fd = -1;
+}
+
+// First run of `count` free sectors past the header, or the end of the file
+static uint32_t region_find_free_run(const RegionFile *region, uint32_t count) {
+    uint32_t run = 0;
+    for (uint32_t s = REGION_HEADER_SECTORS; s < region->sector_count; s++) {
+        run = region->sector_used[s] ? 0 : run + 1;
+        if (run == count) {
+            return s + 1 - count;
+        }
+    }
+    return region->sector_count - run; // A free tail is extended rather than skipped
+}
+
+// Flush buffered writes, then wait for them to reach the disk if `sync` is set
+static bool region_flush(RegionFile *region, bool sync) {
+    if (fflush(region->file) != 0) {
+        return false;
+    }
+#ifndef _WIN32
+    if (sync && fsync(fileno(region->file)) != 0) {
+        return false;
+    }
+#else
+    (void)sync;
+#endif
+    return true;
+}
+
+// Write records that all belong to `region`, `index` giving each one's table entry.
+// See the top of this file for the order of operations.
+static void region_write_group(RegionFile *region, RegionWrite **group, const int *index, int count, bool sync) {
+    static const uint8_t zeros[REGION_SECTOR_SIZE] = {0};
+    uint32_t *first = (uint32_t *)malloc(sizeof(uint32_t) * count);
+    if (!first) {
+        return;
+    }
+
+    // Every record into free sectors; the records they replace stay untouched
+    bool any = false;
+    for (int k = 0; k < count; k++) {
+        RegionWrite *write = group[k];
+        uint32_t needed = region_sectors_for((uint32_t)write->size);
+        first[k] = region_find_free_run(region, needed);
+        if (!region_reserve_sectors(region, first[k] + needed)) {
+            continue;
+        }
+        // Pad to whole sectors so the file always ends on a sector boundary
+        size_t padding = (size_t)needed * REGION_SECTOR_SIZE - write->size;
+        if (fseek(region->file, (long)first[k] * REGION_SECTOR_SIZE, SEEK_SET) == 0 &&
+            fwrite(write->data, 1, write->size, region->file) == write->size &&
+            fwrite(zeros, 1, padding, region->file) == padding) {
+            region_mark_sectors(region, first[k], needed, 1);
+            if (first[k] + needed > region->sector_count) {
+                region->sector_count = first[k] + needed;
+            }
+            write->written = true;
+            any = true;
+        }
+    }
+
+    // Then the table entries, once the data they point to is out
+    bool table_ok = any && region_flush(region, sync);
+    for (int k = 0; k < count && table_ok; k++) {
+        if (group[k]->written) {
+            uint8_t entry[8];
+            region_put_le32(entry, first[k]);
+            region_put_le32(entry + 4, (uint32_t)group[k]->size);
+            table_ok = fseek(region->file, REGION_TABLE_OFFSET + index[k] * 8, SEEK_SET) == 0 &&
+                       fwrite(entry, 1, sizeof(entry), region->file) == sizeof(entry);
+        }
+    }
+    table_ok = table_ok && region_flush(region, sync);
+
+    for (int k = 0; k < count; k++) {
+        RegionWrite *write = group[k];
+        if (!write->written) {
+            continue;
+        }
+        if (!table_ok) {
+            // The entry on disk may point at either record: keep both reserved until the
+            // region is reopened, and report the chunk as not saved
+            write->written = false;
+            continue;
+        }
+        uint32_t old_first = region->first_sector[index[k]];
+        if (old_first) {
+            region_mark_sectors(region, old_first, region_sectors_for(region->length[index[k]]), 0);
+        }
+        region->first_sector[index[k]] = first[k];
+        region->length[index[k]] = (uint32_t)write->size;
+    }
+    free(first);
+}
+
+int region_write_batch(const char *world_name, RegionWrite *writes, int count, bool sync) {
+    if (count <= 0) {
+        return 0;
+    }
+    char (*paths)[512] = malloc(sizeof(*paths) * count);
+    int *index = (int *)malloc(sizeof(int) * count * 2);
+    RegionWrite **group = (RegionWrite **)malloc(sizeof(RegionWrite *) * count);
+    if (!paths || !index || !group) {
+        free(paths);
+        free(index);
+        free(group);
+        return 0;
+    }
+    int *group_index = index + count;
+    for (int i = 0; i < count; i++) {
+        writes[i].written = false;
+        index[i] = region_locate(world_name, writes[i].chunk_x, writes[i].chunk_y, writes[i].chunk_z,
+                                 paths[i], sizeof(paths[i]));
+    }
+
+    // One region at a time, so all of its chunks share one lock, flush and fsync
+    int written = 0;
+    for (int i = 0; i < count; i++) {
+        if (index[i] < 0) {
+            continue; // Already part of an earlier group
+        }
+        int group_count = 0;
+        for (int j = i; j < count; j++) {
+            if (index[j] < 0 || strcmp(paths[j], paths[i]) != 0) {
+                continue;
+            }
+            // Largest possible chunk record is a few dozen sectors
+            if (writes[j].size > 0 && writes[j].size <= (size_t)REGION_SECTOR_SIZE * 255) {
+                group[group_count] = &writes[j];
+                group_index[group_count] = index[j];
+                group_count++;
+            }
+            index[j] = -1;
+        }
+        if (group_count == 0) {
+            continue;
+        }
+
+        RegionFile *region = region_acquire(paths[i], true);
+        if (region) {
+            region_write_group(region, group, group_index, group_count, sync);
+            region_release(region);
+        } else {
+            printf("[region] Failed to open %s for writing\n", paths[i]);
+        }
+        for (int k = 0; k < group_count; k++) {
+            if (group[k]->written) {
+                written++;
+            } else {
+                printf("[region] Failed to write chunk %d,%d,%d to %s\n", group[k]->chunk_x, group[k]->chunk_y,
+                       group[k]->chunk_z, paths[i]);
+            }
+        }
+    }
+    free(paths);
+    free(index);
+    free(group);
+    return written;
+}
+
+bool region_write_chunk(const char *world_name, int32_t chunk_x, int32_t chunk_y, int32_t chunk_z,
+                        const uint8_t *data, size_t size) {
+    RegionWrite write = {.chunk_x = chunk_x, .chunk_y = chunk_y, .chunk_z = chunk_z, .data = data, .size = size};
+    return region_write_batch(world_name, &write, 1, false) == 1;
+}
+
+// A per-chunk file found by region_migrate_chunk_files
+typedef struct {
+    int32_t chunk_x;
+    int32_t chunk_y;
+    int32_t chunk_z;
+    int32_t region[3];
+    char name[256];
+} RegionLegacyFile;
+
+// Orders legacy files by region, so each region's files are one run
+static int region_legacy_compare(const void *a, const void *b) {
+    const RegionLegacyFile *fa = (const RegionLegacyFile *)a;
+    const RegionLegacyFile *fb = (const RegionLegacyFile *)b;
+    for (int axis = 0; axis < 3; axis++) {
+        if (fa->region[axis] != fb->region[axis]) {
+            return fa->region[axis] < fb->region[axis] ? -1 : 1;
+        }
+    }
+    return 0;
+}
+
+// Whole contents of a file, NULL if it is empty or could not be read
+static uint8_t *region_read_file(const char *path, size_t *out_size) {
+    FILE *file = fopen(path, "rb");
+    if (!file) {
+        return NULL;
+    }
+    uint8_t *data = NULL;
+    long size = -1;
+    if (fseek(file, 0, SEEK_END) == 0) {
+        size = ftell(file);
+    }
+    if (size > 0 && fseek(file, 0, SEEK_SET) == 0) {
+        data = (uint8_t *)malloc((size_t)size);
+        if (data && fread(data, 1, (size_t)size, file) != (size_t)size) {
+            free(data);
+            data = NULL;
+        }
+    }
+    fclose(file);
+    *out_size = data ? (size_t)size : 0;
+    return data;
+}
+
+// Make file removals in a directory durable
+static void region_sync_dir(const char *dir_path) {
+#ifndef _WIN32
+    int fd = open(dir_path, O_RDONLY);
+    if (fd >= 0) {
+        fsync(fd);
+        close(fd);
+    }
+#else
+    (void)dir_path;
+#endif
+}
+
+int region_migrate_chunk_files(const char *world_name, int *out_failed) {
+    *out_failed = 0;
+    char dir_path[512];
+    snprintf(dir_path, sizeof(dir_path), "./worlds/%s/chunks", world_name);
+    DIR *dir = opendir(dir_path);
+    if (!dir) {
+        return 0;
+    }
+
+    RegionLegacyFile *files = NULL;
+    int count = 0;
+    int capacity = 0;
+    struct dirent *entry;
+    while ((entry = readdir(dir))) {
+        int32_t chunk_x, chunk_y, chunk_z;
+        int name_end = 0;
+        if (sscanf(entry->d_name, "chunk_%d_%d_%d.chunk%n", &chunk_x, &chunk_y, &chunk_z, &name_end) != 3 ||
+            entry->d_name[name_end] != '\0' || strlen(entry->d_name) >= sizeof(files[0].name)) {
+            continue;
+        }
+        if (count >= capacity) {
+            int new_capacity = capacity > 0 ? capacity * 2 : 64;
+            RegionLegacyFile *grown = (RegionLegacyFile *)realloc(files, sizeof(RegionLegacyFile) * new_capacity);
+            if (!grown) {
+                (*out_failed)++;
+                continue;
+            }
+            files = grown;
+            capacity = new_capacity;
+        }
+        RegionLegacyFile *file = &files[count++];
+        file->chunk_x = chunk_x;
+        file->chunk_y = chunk_y;
+        file->chunk_z = chunk_z;
+        file->region[0] = region_floor_div(chunk_x, REGION_WIDTH);
+        file->region[1] = region_floor_div(chunk_y, REGION_HEIGHT);
+        file->region[2] = region_floor_div(chunk_z, REGION_WIDTH);
+        strcpy(file->name, entry->d_name);
+    }
+    closedir(dir);
+    if (count == 0) {
+        free(files);
+        return 0;
+    }
+
+    qsort(files, (size_t)count, sizeof(RegionLegacyFile), region_legacy_compare);
+    RegionWrite *writes = (RegionWrite *)malloc(sizeof(RegionWrite) * count);
+    const RegionLegacyFile **sources = (const RegionLegacyFile **)malloc(sizeof(RegionLegacyFile *) * count);
+    if (!writes || !sources) {
+        free(writes);
+        free(sources);
+        free(files);
+        *out_failed += count;
+        return 0;
+    }
+
+    // One synced batch per region. The old files only go once region_write_batch
+    // reports their records written and fsynced, so a crash never leaves a chunk
+    // in neither place.
+    int migrated = 0;
+    char file_path[1024];
+    for (int start = 0, end = 0; start < count; start = end) {
+        end = start + 1;
+        while (end < count && region_legacy_compare(&files[start], &files[end]) == 0) {
+            end++;
+        }
+
+        int batch = 0;
+        for (int i = start; i < end; i++) {
+            snprintf(file_path, sizeof(file_path), "%s/%s", dir_path, files[i].name);
+            size_t size = 0;
+            uint8_t *data = region_read_file(file_path, &size);
+            if (!data) {
+                (*out_failed)++;
+                continue;
+            }
+            writes[batch] = (RegionWrite){.chunk_x = files[i].chunk_x, .chunk_y = files[i].chunk_y,
+                                          .chunk_z = files[i].chunk_z, .data = data, .size = size};
+            sources[batch] = &files[i];
+            batch++;
+        }
+
+        region_write_batch(world_name, writes, batch, true);
+        for (int k = 0; k < batch; k++) {
+            snprintf(file_path, sizeof(file_path), "%s/%s", dir_path, sources[k]->name);
+            if (writes[k].written && remove(file_path) == 0) {
+                migrated++;
+            } else {
+                (*out_failed)++;
+            }
+            free((uint8_t *)writes[k].data);
+        }
+    }
+
+    // A removal lost in a crash would bring back an old file that the next
+    // migration copies over whatever the chunk was saved as since
+    region_sync_dir(dir_path);
+    free(writes);
+    free(sources);
+    free(files);
+    return migrated;
+}
+
+void region_close_all(void) {
+    pthread_mutex_lock(&region_cache.mutex);
+    for (int i = 0; i < region_cache.count; i++) {
+        region_close(region_cache.open[i]);
+    }
+    free(region_cache.open);
+    region_cache.open = NULL;
+    region_cache.count = 0;
+    region_cache.capacity = 0;
+    pthread_mutex_unlock(&region_cache.mutex);
+}
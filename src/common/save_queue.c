@@ -0,0 +1,320 @@
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "../../include/world.h"
+
+// ============================================================================
+// SAVE QUEUE
+// ============================================================================
+// Chunk saves go through one dedicated thread instead of the worker pool, so
+// disk I/O never waits behind (or holds up) meshing and generation.
+//
+// Saving is write-behind: save_queue_chunk only marks the chunk pending_save
+// and returns. A chunk edited again before the thread gets to it is not queued
+// twice; the one write picks up every edit made until its snapshot is taken.
+//
+// The thread takes everything queued as one batch (up to SAVE_QUEUE_BATCH_MAX
+// chunks), snapshots and encodes each modified chunk, and hands all records to
+// region_write_batch, which writes each region file once with a single flush
+// and, depending on SaveConfig.fsync_mode, a single fsync.
+//
+// A queued chunk cannot be unloaded (world_update_chunks skips pending_save
+// chunks), so its handle stays valid until the thread has written it.
+
+#define SAVE_QUEUE_BATCH_MAX 64
+
+// Snapshot a chunk's blocks and encode them. Clears `modified` first, so edits
+// made from here on mark the chunk modified again. Returns NULL if there was
+// nothing to save (`out_failed` false) or the chunk could not be encoded
+// (`out_failed` true, the chunk stays modified).
+static uint8_t *save_queue_encode(World *world, Chunk *chunk, size_t *out_size, bool *out_failed) {
+    *out_failed = false;
+    uint8_t *types = (uint8_t *)malloc(CHUNK_WIDTH * CHUNK_HEIGHT * CHUNK_DEPTH);
+
+    // Edits happen under the chunk mutex, so the snapshot is never half of one
+    pthread_mutex_lock(&chunk->mutex);
+    bool dirty = chunk->modified && chunk->generated && !chunk->pending_generate && !chunk->read_only;
+    *out_failed = dirty && !types;
+    if (dirty && types) {
+        chunk->modified = false;
+        chunk_storage_read_types(chunk, types);
+    }
+    pthread_mutex_unlock(&chunk->mutex);
+
+    uint8_t *record = NULL;
+    if (dirty && types) {
+        record = chunk_encode_types(types, world->compress_chunk_files, out_size);
+        if (!record) {
+            pthread_mutex_lock(&chunk->mutex);
+            chunk->modified = true;
+            pthread_mutex_unlock(&chunk->mutex);
+            *out_failed = true;
+        }
+    }
+    free(types);
+    return record;
+}
+
+// Write one batch of queued chunks
+static void save_queue_write(World *world, const ChunkHandle *handles, int count) {
+    Chunk *chunks[SAVE_QUEUE_BATCH_MAX];
+    RegionWrite writes[SAVE_QUEUE_BATCH_MAX];
+    int write_of[SAVE_QUEUE_BATCH_MAX]; // Index into writes, -1 if the chunk had nothing to write
+    bool failed[SAVE_QUEUE_BATCH_MAX];
+    int write_count = 0;
+
+    for (int i = 0; i < count; i++) {
+        // Queued chunks are never unloaded, but resolve under the cache mutex like workers do
+        pthread_mutex_lock(&world->cache_mutex);
+        chunks[i] = chunk_pool_resolve(&world->chunk_cache, handles[i]);
+        if (chunks[i]) {
+            __atomic_add_fetch(&chunks[i]->in_use_count, 1, __ATOMIC_ACQ_REL);
+        }
+        pthread_mutex_unlock(&world->cache_mutex);
+
+        write_of[i] = -1;
+        failed[i] = false;
+        size_t size = 0;
+        uint8_t *record = chunks[i] ? save_queue_encode(world, chunks[i], &size, &failed[i]) : NULL;
+        if (record) {
+            writes[write_count] = (RegionWrite){.chunk_x = chunks[i]->chunk_x,
+                                                .chunk_y = chunks[i]->chunk_y,
+                                                .chunk_z = chunks[i]->chunk_z,
+                                                .data = record,
+                                                .size = size};
+            write_of[i] = write_count++;
+        }
+    }
+
+    SaveFsyncMode fsync_mode = world->save_queue.config.fsync_mode;
+    if (fsync_mode == SAVE_FSYNC_ALWAYS) {
+        for (int w = 0; w < write_count; w++) {
+            region_write_batch(world->world_name, &writes[w], 1, true);
+        }
+    } else if (write_count > 0) {
+        region_write_batch(world->world_name, writes, write_count, fsync_mode == SAVE_FSYNC_BATCH);
+    }
+
+    for (int i = 0; i < count; i++) {
+        Chunk *chunk = chunks[i];
+        if (!chunk) {
+            continue;
+        }
+        if (write_of[i] >= 0 && !writes[write_of[i]].written) {
+            failed[i] = true;
+        }
+        pthread_mutex_lock(&chunk->mutex);
+        if (failed[i]) {
+            chunk->modified = true; // Kept in memory; the next save or autosave tries again
+        }
+        chunk->pending_save = false;
+        pthread_mutex_unlock(&chunk->mutex);
+        // Edited while the batch was being written: queue it again for the newer blocks
+        if (!failed[i]) {
+            save_queue_chunk(world, chunk);
+        }
+        __atomic_sub_fetch(&chunk->in_use_count, 1, __ATOMIC_ACQ_REL);
+    }
+
+    for (int w = 0; w < write_count; w++) {
+        free((void *)writes[w].data);
+    }
+}
+
+static void *save_queue_thread_main(void *arg) {
+    World *world = (World *)arg;
+    SaveQueue *queue = &world->save_queue;
+    ChunkHandle batch[SAVE_QUEUE_BATCH_MAX];
+
+    pthread_mutex_lock(&queue->mutex);
+    while (true) {
+        while (queue->count == 0 && !queue->shutdown) {
+            pthread_cond_wait(&queue->cond, &queue->mutex);
+        }
+        if (queue->count == 0) {
+            break; // Shut down with nothing left to write
+        }
+
+        // Oldest first, in at most two pieces where the ring wraps
+        int count = queue->count < SAVE_QUEUE_BATCH_MAX ? queue->count : SAVE_QUEUE_BATCH_MAX;
+        int first = queue->capacity - queue->head < count ? queue->capacity - queue->head : count;
+        memcpy(batch, queue->pending + queue->head, sizeof(ChunkHandle) * first);
+        memcpy(batch + first, queue->pending, sizeof(ChunkHandle) * (count - first));
+        queue->head = (queue->head + count) & (queue->capacity - 1);
+        queue->count -= count;
+        queue->busy = true;
+        pthread_mutex_unlock(&queue->mutex);
+
+        save_queue_write(world, batch, count);
+        printf("[save] Wrote batch of %d chunk(s)\n", count);
+
+        pthread_mutex_lock(&queue->mutex);
+        queue->busy = false;
+        pthread_cond_broadcast(&queue->idle_cond);
+    }
+    pthread_mutex_unlock(&queue->mutex);
+    return NULL;
+}
+
+// Start the save thread
+void save_queue_init(World *world, const SaveConfig *config) {
+    if (!world || !config) {
+        return;
+    }
+
+    SaveQueue *queue = &world->save_queue;
+    queue->config = *config;
+    queue->pending = NULL;
+    queue->head = 0;
+    queue->count = 0;
+    queue->capacity = 0;
+    queue->busy = false;
+    queue->shutdown = false;
+    queue->next_autosave = time(NULL) + queue->config.autosave_interval;
+    pthread_mutex_init(&queue->mutex, NULL);
+    pthread_cond_init(&queue->cond, NULL);
+    pthread_cond_init(&queue->idle_cond, NULL);
+    queue->running = pthread_create(&queue->thread, NULL, save_queue_thread_main, world) == 0;
+
+    static const char *const fsync_names[] = {"never", "batch", "always"};
+    printf("[save] Save thread %s (fsync=%s, autosave every %ds)\n", queue->running ? "started" : "failed to start",
+           fsync_names[queue->config.fsync_mode], queue->config.autosave_interval);
+}
+
+// Write whatever is still queued, then stop the thread
+void save_queue_shutdown(World *world) {
+    if (!world) {
+        return;
+    }
+
+    SaveQueue *queue = &world->save_queue;
+    if (queue->running) {
+        pthread_mutex_lock(&queue->mutex);
+        queue->shutdown = true;
+        pthread_cond_signal(&queue->cond);
+        pthread_mutex_unlock(&queue->mutex);
+        pthread_join(queue->thread, NULL);
+        queue->running = false;
+    }
+
+    free(queue->pending);
+    queue->pending = NULL;
+    queue->head = 0;
+    queue->count = 0;
+    queue->capacity = 0;
+    pthread_mutex_destroy(&queue->mutex);
+    pthread_cond_destroy(&queue->cond);
+    pthread_cond_destroy(&queue->idle_cond);
+}
+
+// Queue a chunk to be saved if it is modified. Does nothing if it is already
+// queued or being written; the write in progress re-queues it if it was
+// modified meanwhile. Returns whether the chunk was queued (or written).
+bool save_queue_chunk(World *world, Chunk *chunk) {
+    if (!world || !chunk) {
+        return false;
+    }
+
+    SaveQueue *queue = &world->save_queue;
+    if (!queue->running) {
+        // No save thread: write it here rather than lose the edits
+        size_t size = 0;
+        bool failed = false;
+        uint8_t *record = save_queue_encode(world, chunk, &size, &failed);
+        if (!record) {
+            return false;
+        }
+        if (!region_write_chunk(world->world_name, chunk->chunk_x, chunk->chunk_y, chunk->chunk_z, record, size)) {
+            pthread_mutex_lock(&chunk->mutex);
+            chunk->modified = true;
+            pthread_mutex_unlock(&chunk->mutex);
+        }
+        free(record);
+        return true;
+    }
+
+    pthread_mutex_lock(&chunk->mutex);
+    // A read-only chunk's stored record must stay as it is, so it has nothing to
+    // save (and must not hold up its unload waiting for a save)
+    if (chunk->read_only) {
+        chunk->modified = false;
+    }
+    // Terrain still being generated would be written out as air
+    if (chunk->pending_save || !chunk->modified || !chunk->generated || chunk->pending_generate) {
+        pthread_mutex_unlock(&chunk->mutex);
+        return false;
+    }
+    chunk->pending_save = true;
+    pthread_mutex_unlock(&chunk->mutex);
+
+    pthread_mutex_lock(&queue->mutex);
+    if (queue->count == queue->capacity) {
+        int capacity = queue->capacity ? queue->capacity * 2 : 64;
+        ChunkHandle *pending = (ChunkHandle *)realloc(queue->pending, sizeof(ChunkHandle) * capacity);
+        if (!pending) {
+            pthread_mutex_unlock(&queue->mutex);
+            pthread_mutex_lock(&chunk->mutex);
+            chunk->pending_save = false; // Still modified, queued again later
+            pthread_mutex_unlock(&chunk->mutex);
+            return false;
+        }
+        // Entries that wrapped past the old end move up behind the rest, which
+        // the doubled buffer always has room for
+        int wrapped = queue->head + queue->count - queue->capacity;
+        if (wrapped > 0) {
+            memcpy(pending + queue->capacity, pending, sizeof(ChunkHandle) * wrapped);
+        }
+        queue->pending = pending;
+        queue->capacity = capacity;
+    }
+    queue->pending[(queue->head + queue->count) & (queue->capacity - 1)] = chunk_pool_handle(chunk);
+    queue->count++;
+    pthread_cond_signal(&queue->cond);
+    pthread_mutex_unlock(&queue->mutex);
+    return true;
+}
+
+// Block until the queue is empty and the thread idle, so every chunk queued
+// before the call (and any it re-queued) is on disk
+void save_queue_flush(World *world) {
+    if (!world || !world->save_queue.running) {
+        return;
+    }
+
+    SaveQueue *queue = &world->save_queue;
+    pthread_mutex_lock(&queue->mutex);
+    while (queue->count > 0 || queue->busy) {
+        pthread_cond_wait(&queue->idle_cond, &queue->mutex);
+    }
+    pthread_mutex_unlock(&queue->mutex);
+}
+
+// Queue every modified chunk once the autosave interval has passed. Only
+// queues: the writing happens on the save thread, so this never waits for I/O.
+void save_queue_autosave(World *world) {
+    if (!world || world->save_queue.config.autosave_interval <= 0) {
+        return;
+    }
+
+    SaveQueue *queue = &world->save_queue;
+    time_t now = time(NULL);
+    if (now < queue->next_autosave) {
+        return;
+    }
+    queue->next_autosave = now + queue->config.autosave_interval;
+
+    int queued = 0;
+    pthread_mutex_lock(&world->cache_mutex);
+    for (int i = 0; i < world->chunk_cache.chunk_count; i++) {
+        if (save_queue_chunk(world, world->chunk_cache.live[i])) {
+            queued++;
+        }
+    }
+    pthread_mutex_unlock(&world->cache_mutex);
+
+    if (queued > 0) {
+        printf("[save] Autosave queued %d chunk(s)\n", queued);
+    }
+}
@@ -309,3 +309,92 @@ void trim_string(char *str) {
         memmove(str, str + start, strlen(str + start) + 1);
     }
 }
+
+// ============================================================================
+// FRAME ARENA
+// ============================================================================
+
+#define FRAME_ARENA_ALIGN 16
+#define FRAME_ARENA_MIN_CAPACITY (64 * 1024)
+
+struct FrameArenaOverflow {
+    FrameArenaOverflow *next;
+};
+
+static size_t frame_arena_align(size_t size) {
+    return (size + FRAME_ARENA_ALIGN - 1) & ~(size_t)(FRAME_ARENA_ALIGN - 1);
+}
+
+// Returned memory is 16-byte aligned and valid until the next frame_arena_reset
+void *frame_arena_alloc(FrameArena *arena, size_t size) {
+    size = frame_arena_align(size > 0 ? size : 1);
+    if (arena->base && size <= arena->capacity - arena->used) {
+        void *ptr = arena->base + arena->used;
+        arena->used += size;
+        return ptr;
+    }
+
+    // Does not fit: serve this frame from the heap, the block grows at the next reset
+    size_t header = frame_arena_align(sizeof(FrameArenaOverflow));
+    FrameArenaOverflow *block = (FrameArenaOverflow *)malloc(header + size);
+    if (!block) {
+        return NULL;
+    }
+    block->next = arena->overflow;
+    arena->overflow = block;
+    arena->overflow_bytes += size;
+    return (unsigned char *)block + header;
+}
+
+// Release everything allocated since the last reset
+void frame_arena_reset(FrameArena *arena) {
+    if (arena->overflow) {
+        size_t needed = arena->used + arena->overflow_bytes;
+        while (arena->overflow) {
+            FrameArenaOverflow *next = arena->overflow->next;
+            free(arena->overflow);
+            arena->overflow = next;
+        }
+
+        // Double past the largest frame so slow growth does not reallocate every frame
+        size_t capacity = arena->capacity > 0 ? arena->capacity : FRAME_ARENA_MIN_CAPACITY;
+        while (capacity < needed) {
+            capacity *= 2;
+        }
+        free(arena->base);
+        arena->base = (unsigned char *)malloc(capacity);
+        arena->capacity = arena->base ? capacity : 0;
+    }
+    arena->used = 0;
+    arena->overflow_bytes = 0;
+}
+
+void frame_arena_free(FrameArena *arena) {
+    frame_arena_reset(arena);
+    free(arena->base);
+    arena->base = NULL;
+    arena->capacity = 0;
+}
+
+// Read lines of an options.conf-style file until one holds key=value. Blank lines,
+// comments (from # to the end of the line) and whitespace around the value are
+// dropped; `key` and `value` point into `line`. Returns false at end of file.
+bool options_read_line(FILE *file, char *line, size_t size, char **key, char **value) {
+    while (fgets(line, (int)size, file)) {
+        line[strcspn(line, "\n#")] = '\0';
+        trim_string(line);
+
+        char *equals = strchr(line, '=');
+        if (!equals) {
+            continue;
+        }
+        *equals = '\0';
+        *key = line;
+        *value = equals + 1;
+        while (**value == ' ' || **value == '\t') {
+            (*value)++;
+        }
+        return true;
+    }
+    return false;
+}
@@ -1,8 +1,10 @@
 #define _GNU_SOURCE
 #define _POSIX_C_SOURCE 200809L
+#include <math.h>
 #include <pthread.h>
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
 #include <time.h>
 #include <unistd.h>
 #ifdef __linux__
@@ -10,202 +12,525 @@
 #endif
 #include "../../include/world.h"
 
-// Worker thread main function - processes chunks for meshing
-static void *worker_thread_main(void *arg) {
-    World *world = (World *)arg;
-    WorkerQueue *queue = &world->worker_queue;
+// Re-prioritise queued jobs once the view turns by more than ~15 degrees
+// or the player moves half a chunk
+#define WORKER_REPRIORITIZE_COS 0.966f
+#define WORKER_REPRIORITIZE_DISTANCE 16.0f
+
+// ============================================================================
+// JOB PRIORITY
+// ============================================================================
+
+// Lower value runs first. Chunks are ordered by distance from the interest
+// point, scaled up to 3x for chunks directly behind the view direction. The
+// chunk read engine orders its queue the same way (see chunk_io.c).
+float worker_chunk_priority(int32_t chunk_x, int32_t chunk_y, int32_t chunk_z, Vector3 position, Vector3 forward) {
+    float dx = ((float)chunk_x + 0.5f) * CHUNK_WIDTH - position.x;
+    float dy = ((float)chunk_y + 0.5f) * CHUNK_HEIGHT - position.y;
+    float dz = ((float)chunk_z + 0.5f) * CHUNK_DEPTH - position.z;
+    float distance = sqrtf(dx * dx + dy * dy + dz * dz);
+    if (distance < 1.0f) {
+        return 0.0f;
+    }
 
-    while (true) {
-        WorkerJob job = {0};
-        bool has_job = false;
+    float cos_angle = (dx * forward.x + dy * forward.y + dz * forward.z) / distance;
+    return distance * (2.0f - cos_angle);
+}
 
-        // Wait for work or shutdown signal
-        pthread_mutex_lock(&queue->mutex);
-        while (queue->count == 0 && !queue->shutdown) {
-            pthread_cond_wait(&queue->cond, &queue->mutex);
+static float worker_job_priority(WorkerJob job, Vector3 position, Vector3 forward) {
+    return worker_chunk_priority(job.chunk_x, job.chunk_y, job.chunk_z, position, forward);
+}
+
+static bool worker_entry_before(const WorkerHeapEntry *a, const WorkerHeapEntry *b) {
+    if (a->priority != b->priority) {
+        return a->priority < b->priority;
+    }
+    return (int32_t)(a->sequence - b->sequence) < 0;
+}
+
+// ============================================================================
+// JOB PRIORITY HEAP
+// ============================================================================
+// One binary min-heap shared by every worker. It is only touched under
+// queue->mutex, so a job leaves the heap together with the waiting count and
+// every worker takes the most urgent job in the whole queue.
+
+static void worker_heap_init(WorkerHeap *heap, int capacity) {
+    heap->entries = (WorkerHeapEntry *)malloc(sizeof(WorkerHeapEntry) * capacity);
+    heap->count = 0;
+    heap->capacity = capacity;
+    heap->epoch = 0;
+}
+
+static void worker_heap_destroy(WorkerHeap *heap) {
+    free(heap->entries);
+    heap->entries = NULL;
+    heap->count = 0;
+    heap->capacity = 0;
+}
+
+static void worker_heap_sift_up(WorkerHeap *heap, int index) {
+    WorkerHeapEntry entry = heap->entries[index];
+    while (index > 0) {
+        int parent = (index - 1) / 2;
+        if (!worker_entry_before(&entry, &heap->entries[parent])) {
+            break;
         }
+        heap->entries[index] = heap->entries[parent];
+        index = parent;
+    }
+    heap->entries[index] = entry;
+}
 
-        if (queue->shutdown && queue->count == 0) {
-            pthread_mutex_unlock(&queue->mutex);
-            break; // Exit thread
+static void worker_heap_sift_down(WorkerHeap *heap, int index) {
+    WorkerHeapEntry entry = heap->entries[index];
+    while (true) {
+        int child = index * 2 + 1;
+        if (child >= heap->count) {
+            break;
+        }
+        if (child + 1 < heap->count && worker_entry_before(&heap->entries[child + 1], &heap->entries[child])) {
+            child++;
+        }
+        if (!worker_entry_before(&heap->entries[child], &entry)) {
+            break;
         }
+        heap->entries[index] = heap->entries[child];
+        index = child;
+    }
+    heap->entries[index] = entry;
+}
 
-        // Get first job from queue
-        if (queue->count > 0) {
-            job = queue->queue[0];
-            has_job = true;
-            // Shift queue
-            for (int i = 0; i < queue->count - 1; i++) {
-                queue->queue[i] = queue->queue[i + 1];
-            }
-            queue->count--;
+// Insert a job. Caller holds queue->mutex.
+static void worker_heap_push(WorkerHeap *heap, WorkerHeapEntry entry) {
+    if (heap->count >= heap->capacity) {
+        heap->capacity *= 2;
+        heap->entries = (WorkerHeapEntry *)realloc(heap->entries, sizeof(WorkerHeapEntry) * heap->capacity);
+    }
+    heap->entries[heap->count] = entry;
+    heap->count++;
+    worker_heap_sift_up(heap, heap->count - 1);
+}
+
+// Recompute every priority against a new interest point and rebuild the heap in O(n).
+// Caller holds queue->mutex.
+static void worker_heap_reprioritize(WorkerHeap *heap, Vector3 position, Vector3 forward, uint32_t epoch) {
+    for (int i = 0; i < heap->count; i++) {
+        heap->entries[i].priority = worker_job_priority(heap->entries[i].job, position, forward);
+    }
+    for (int i = heap->count / 2 - 1; i >= 0; i--) {
+        worker_heap_sift_down(heap, i);
+    }
+    heap->epoch = epoch;
+}
+
+// Remove the most urgent job, re-ordering the heap first if the interest point
+// moved since it was built. Caller holds queue->mutex.
+static bool worker_take_job(WorkerQueue *queue, WorkerJob *out_job) {
+    WorkerHeap *heap = &queue->heap;
+    if (heap->count == 0) {
+        return false;
+    }
+    if (heap->epoch != queue->interest_epoch) {
+        worker_heap_reprioritize(heap, queue->interest_position, queue->interest_forward, queue->interest_epoch);
+    }
+    *out_job = heap->entries[0].job;
+    heap->count--;
+    if (heap->count > 0) {
+        heap->entries[0] = heap->entries[heap->count];
+        worker_heap_sift_down(heap, 0);
+    }
+    return true;
+}
+
+// ============================================================================
+// QUEUED-JOB SET (DEDUP)
+// ============================================================================
+
+static uint32_t worker_job_hash(WorkerJob job) {
+    uint32_t h = (uint32_t)job.chunk_x * 73856093u;
+    h ^= (uint32_t)job.chunk_y * 19349663u;
+    h ^= (uint32_t)job.chunk_z * 83492791u;
+    h ^= (uint32_t)job.type * 2654435761u;
+    h ^= h >> 16;
+    h *= 0x7feb352du;
+    h ^= h >> 15;
+    return h;
+}
+
+static bool worker_job_equal(WorkerJob a, WorkerJob b) {
+    return a.chunk_x == b.chunk_x && a.chunk_y == b.chunk_y && a.chunk_z == b.chunk_z && a.type == b.type;
+}
+
+static void worker_job_set_init(WorkerJobSet *set, int capacity) {
+    set->slots = (WorkerJobSlot *)calloc(capacity, sizeof(WorkerJobSlot));
+    set->count = 0;
+    set->capacity = capacity;
+}
+
+static void worker_job_set_destroy(WorkerJobSet *set) {
+    free(set->slots);
+    set->slots = NULL;
+    set->count = 0;
+    set->capacity = 0;
+}
+
+static int worker_job_set_find(const WorkerJobSet *set, WorkerJob job) {
+    uint32_t mask = (uint32_t)set->capacity - 1;
+    for (uint32_t i = worker_job_hash(job) & mask; set->slots[i].occupied; i = (i + 1) & mask) {
+        if (worker_job_equal(set->slots[i].job, job)) {
+            return (int)i;
         }
-        pthread_mutex_unlock(&queue->mutex);
+    }
+    return -1;
+}
 
-        if (!has_job) {
-            continue;
+static void worker_job_set_insert_slot(WorkerJobSet *set, WorkerJob job) {
+    uint32_t mask = (uint32_t)set->capacity - 1;
+    uint32_t i = worker_job_hash(job) & mask;
+    while (set->slots[i].occupied) {
+        i = (i + 1) & mask;
+    }
+    set->slots[i].job = job;
+    set->slots[i].occupied = true;
+    set->count++;
+}
+
+// Add a job; returns false if it was already present. Caller holds queue->mutex.
+static bool worker_job_set_insert(WorkerJobSet *set, WorkerJob job) {
+    if (worker_job_set_find(set, job) >= 0) {
+        return false;
+    }
+
+    // Keep the load factor under 1/2 so probe runs stay short
+    if ((set->count + 1) * 2 > set->capacity) {
+        WorkerJobSlot *old_slots = set->slots;
+        int old_capacity = set->capacity;
+        worker_job_set_init(set, old_capacity * 2);
+        for (int i = 0; i < old_capacity; i++) {
+            if (old_slots[i].occupied) {
+                worker_job_set_insert_slot(set, old_slots[i].job);
+            }
         }
+        free(old_slots);
+    }
 
-        // Mark job as in-progress
-        pthread_mutex_lock(&queue->mutex);
-        queue->jobs_in_progress++;
-        pthread_mutex_unlock(&queue->mutex);
+    worker_job_set_insert_slot(set, job);
+    return true;
+}
 
-        // CRITICAL: Lock cache_mutex BEFORE looking up chunk to prevent it being unloaded
-        // This prevents the chunk from being removed from the cache while we process it
-        pthread_mutex_lock(&world->cache_mutex);
-        Chunk *chunk = world_get_chunk(world, job.chunk_x, job.chunk_y, job.chunk_z);
-        if (!chunk) {
-            // Chunk was unloaded, mark job complete
-            pthread_mutex_unlock(&world->cache_mutex);
-            pthread_mutex_lock(&queue->mutex);
-            queue->jobs_in_progress--;
-            pthread_mutex_unlock(&queue->mutex);
-            continue;
+// Remove a job using backward-shift deletion (no tombstones). Caller holds queue->mutex.
+static void worker_job_set_remove(WorkerJobSet *set, WorkerJob job) {
+    int index = worker_job_set_find(set, job);
+    if (index < 0) {
+        return;
+    }
+
+    uint32_t mask = (uint32_t)set->capacity - 1;
+    uint32_t hole = (uint32_t)index;
+    uint32_t next = (hole + 1) & mask;
+    while (set->slots[next].occupied) {
+        uint32_t home = worker_job_hash(set->slots[next].job) & mask;
+        // Move the entry back if the hole lies between its home slot and where it sits now
+        if (((next - home) & mask) >= ((next - hole) & mask)) {
+            set->slots[hole] = set->slots[next];
+            hole = next;
         }
+        next = (next + 1) & mask;
+    }
+    set->slots[hole].occupied = false;
+    set->count--;
+}
 
-        // Mark this chunk as in-use so it isn't unloaded while we're processing it
-        __atomic_add_fetch(&chunk->in_use_count, 1, __ATOMIC_ACQ_REL);
+// ============================================================================
+// JOB PROCESSING
+// ============================================================================
 
-        // Lock chunk for processing - protects this chunk's data
-        pthread_mutex_lock(&chunk->mutex);
+static void worker_queue_job(World *world, WorkerJob job);
 
-        // We can release cache_mutex now that we have chunk->mutex
-        pthread_mutex_unlock(&world->cache_mutex);
+// Flip a pending chunk's state flags together once its blocks are in. Caller holds chunk->mutex.
+static void worker_mark_published(Chunk *chunk) {
+    chunk->pending_generate = false;
+    chunk->pending_unload = false;
+    chunk->modified = false; // Freshly generated or loaded chunk is not modified
+    chunk->meshed = false;
+    chunk->loaded = true;
+    __atomic_store_n(&chunk->generated, true, __ATOMIC_RELEASE);
+}
 
-        // RE-VALIDATE chunk after locking - it might have been unloaded and replaced
-        // Check that coordinates still match what we queued
-        if (chunk->chunk_x != job.chunk_x || chunk->chunk_y != job.chunk_y || chunk->chunk_z != job.chunk_z) {
-            pthread_mutex_unlock(&chunk->mutex);
-            pthread_mutex_lock(&queue->mutex);
-            queue->jobs_in_progress--;
-            pthread_mutex_unlock(&queue->mutex);
-            __atomic_sub_fetch(&chunk->in_use_count, 1, __ATOMIC_ACQ_REL);
-            continue; // Different chunk now at this address, skip
-        }
+// Mesh a just-published chunk and rebuild the neighbours that were meshed while it
+// was pending, as they exposed faces against it
+static void worker_queue_published(World *world, int32_t chunk_x, int32_t chunk_y, int32_t chunk_z) {
+    WorkerJob mesh_job = {.chunk_x = chunk_x, .chunk_y = chunk_y, .chunk_z = chunk_z, .type = WORKER_JOB_MESH};
+    worker_queue_job(world, mesh_job);
 
-        // Validate chunk is still relevant (wasn't unloaded)
-        // For save jobs, we allow saving even if the chunk is marked unloaded.
-        if (!chunk->generated || (job.type != WORKER_JOB_SAVE_CHUNK && !chunk->loaded)) {
-            pthread_mutex_unlock(&chunk->mutex);
-            pthread_mutex_lock(&queue->mutex);
-            queue->jobs_in_progress--;
-            pthread_mutex_unlock(&queue->mutex);
-            __atomic_sub_fetch(&chunk->in_use_count, 1, __ATOMIC_ACQ_REL);
+    const int neighbor_offsets[6][3] = {
+        {1, 0, 0}, {-1, 0, 0}, {0, 1, 0}, {0, -1, 0}, {0, 0, 1}, {0, 0, -1}};
+    bool requeue[6] = {false};
+
+    pthread_mutex_lock(&world->cache_mutex);
+    for (int ni = 0; ni < 6; ni++) {
+        Chunk *neighbor = world_get_chunk(world, chunk_x + neighbor_offsets[ni][0], chunk_y + neighbor_offsets[ni][1], chunk_z + neighbor_offsets[ni][2]);
+        if (!neighbor || !neighbor->loaded || !neighbor->generated) {
             continue;
         }
+        pthread_mutex_lock(&neighbor->mutex);
+        requeue[ni] = neighbor->meshed;
+        neighbor->meshed = false;
+        pthread_mutex_unlock(&neighbor->mutex);
+    }
+    pthread_mutex_unlock(&world->cache_mutex);
+
+    for (int ni = 0; ni < 6; ni++) {
+        if (requeue[ni]) {
+            WorkerJob neighbor_job = {.chunk_x = chunk_x + neighbor_offsets[ni][0],
+                                      .chunk_y = chunk_y + neighbor_offsets[ni][1],
+                                      .chunk_z = chunk_z + neighbor_offsets[ni][2],
+                                      .type = WORKER_JOB_MESH};
+            worker_queue_job(world, neighbor_job);
+        }
+    }
+}
 
-        // Handle save job separately (async chunk saving)
-        if (job.type == WORKER_JOB_SAVE_CHUNK) {
-            // Save chunk to disk (same format as world_save_chunk)
-            if (chunk->modified) {
-                pthread_mutex_unlock(&chunk->mutex); // release while saving to avoid long lock hold
-                world_save_chunk(chunk, world->world_name, world->compress_chunk_files);
-                pthread_mutex_lock(&chunk->mutex);
-                chunk->modified = false;
-            }
+// Generate terrain for a pending chunk into a detached buffer, then publish it in one step.
+// The chunk stays hidden (loaded/generated false) until the publish, and the noise work
+// runs without holding any lock. Caller holds an in_use_count reference on the chunk.
+static void worker_generate_chunk(World *world, Chunk *chunk) {
+    int32_t chunk_x = chunk->chunk_x;
+    int32_t chunk_y = chunk->chunk_y;
+    int32_t chunk_z = chunk->chunk_z;
+
+    Block(*blocks)[CHUNK_DEPTH][CHUNK_WIDTH] = malloc(sizeof(Block) * CHUNK_HEIGHT * CHUNK_DEPTH * CHUNK_WIDTH);
+    if (!blocks) {
+        // Let world_update_chunks queue it again on a later update
+        pthread_mutex_lock(&chunk->mutex);
+        chunk->pending_generate = false;
+        pthread_mutex_unlock(&chunk->mutex);
+        return;
+    }
 
-            chunk->pending_save = false;
+    world_generate_chunk_blocks(blocks, chunk_x, chunk_y, chunk_z, world->seed);
 
-            // If this chunk was scheduled for unload, allow it to be removed next update
-            // (world_update_chunks checks pending_unload)
+    // Publish: pack the finished terrain in and flip the state flags together
+    pthread_mutex_lock(&chunk->mutex);
+    chunk_storage_fill(chunk, blocks);
+    worker_mark_published(chunk);
+    pthread_mutex_unlock(&chunk->mutex);
+    free(blocks);
 
-            pthread_mutex_unlock(&chunk->mutex);
-            pthread_mutex_lock(&queue->mutex);
-            queue->jobs_in_progress--;
-            pthread_mutex_unlock(&queue->mutex);
-            __atomic_sub_fetch(&chunk->in_use_count, 1, __ATOMIC_ACQ_REL);
-            continue;
+    worker_queue_published(world, chunk_x, chunk_y, chunk_z);
+}
+
+// Decode a stored record into a pending chunk and publish it like a generated one. Returns
+// false if the chunk is no longer pending or the record does not decode; the chunk then
+// stays pending for the caller to generate. Caller holds an in_use_count reference.
+bool worker_publish_chunk_record(World *world, Chunk *chunk, const uint8_t *record, size_t size) {
+    if (!world || !chunk || !record) {
+        return false;
+    }
+
+    const char *error = NULL;
+    pthread_mutex_lock(&chunk->mutex);
+    bool published = chunk->pending_generate && !chunk->generated && chunk_load_record(record, size, chunk, &error);
+    if (published) {
+        worker_mark_published(chunk);
+    }
+    pthread_mutex_unlock(&chunk->mutex);
+
+    if (!published) {
+        if (error && error[0] != '\0') {
+            printf("[chunk_load] Failed to parse chunk %d,%d,%d (%s)\n", chunk->chunk_x, chunk->chunk_y, chunk->chunk_z, error);
         }
+        return false;
+    }
+    worker_queue_published(world, chunk->chunk_x, chunk->chunk_y, chunk->chunk_z);
+    return true;
+}
 
-        // Skip if already processed and no updates required
-        if (chunk->meshed) {
-            pthread_mutex_unlock(&chunk->mutex);
-            pthread_mutex_lock(&queue->mutex);
-            queue->jobs_in_progress--;
-            pthread_mutex_unlock(&queue->mutex);
-            __atomic_sub_fetch(&chunk->in_use_count, 1, __ATOMIC_ACQ_REL);
-            continue;
+// Process a single mesh/generate job
+static void worker_run_job(World *world, WorkerJob job) {
+    // CRITICAL: Lock cache_mutex BEFORE looking up chunk to prevent it being unloaded
+    // This prevents the chunk from being removed from the cache while we process it
+    pthread_mutex_lock(&world->cache_mutex);
+    Chunk *chunk = world_get_chunk(world, job.chunk_x, job.chunk_y, job.chunk_z);
+    if (!chunk) {
+        // Chunk was unloaded, job is complete
+        pthread_mutex_unlock(&world->cache_mutex);
+        return;
+    }
+
+    // Mark this chunk as in-use so it isn't unloaded while we're processing it
+    __atomic_add_fetch(&chunk->in_use_count, 1, __ATOMIC_ACQ_REL);
+
+    // Lock chunk for processing - protects this chunk's data
+    pthread_mutex_lock(&chunk->mutex);
+
+    // We can release cache_mutex now that we have chunk->mutex
+    pthread_mutex_unlock(&world->cache_mutex);
+
+    // RE-VALIDATE chunk after locking - it might have been unloaded and replaced
+    // Check that coordinates still match what we queued
+    if (chunk->chunk_x != job.chunk_x || chunk->chunk_y != job.chunk_y || chunk->chunk_z != job.chunk_z) {
+        pthread_mutex_unlock(&chunk->mutex);
+        __atomic_sub_fetch(&chunk->in_use_count, 1, __ATOMIC_ACQ_REL);
+        return; // Different chunk now at this address, skip
+    }
+
+    // Handle generate job separately (the chunk has no terrain yet)
+    if (job.type == WORKER_JOB_GENERATE) {
+        bool needs_generate = chunk->pending_generate && !chunk->generated;
+        pthread_mutex_unlock(&chunk->mutex);
+        if (needs_generate) {
+            worker_generate_chunk(world, chunk);
         }
+        __atomic_sub_fetch(&chunk->in_use_count, 1, __ATOMIC_ACQ_REL);
+        return;
+    }
+
+    // Validate chunk is still relevant (wasn't unloaded)
+    if (!chunk->generated || !chunk->loaded) {
+        pthread_mutex_unlock(&chunk->mutex);
+        __atomic_sub_fetch(&chunk->in_use_count, 1, __ATOMIC_ACQ_REL);
+        return;
+    }
+
+    // Skip if already processed and no updates required
+    if (chunk->meshed) {
+        pthread_mutex_unlock(&chunk->mutex);
+        __atomic_sub_fetch(&chunk->in_use_count, 1, __ATOMIC_ACQ_REL);
+        return;
+    }
 
-        // NOTE: Do NOT invalidate visible_count before rebuilding!
-        // Zeroing it causes a flicker where the chunk disappears for 1+ frames.
-        // Instead, we render the old mesh while building the new one in chunk_cache_visible_blocks.
-        // The atomic swap at the end of chunk_cache_visible_blocks ensures thread safety.
+    // NOTE: Do NOT drop the old mesh before rebuilding!
+    // Freeing it causes a flicker where the chunk disappears for 1+ frames.
+    // Instead, we render the old mesh while building the new one in chunk_build_mesh.
+    // The atomic swap at the end of chunk_build_mesh ensures thread safety.
 
-        bool needs_meshing = !chunk->meshed && chunk->generated && chunk->loaded;
+    bool needs_meshing = !chunk->meshed && chunk->generated && chunk->loaded;
+
+    pthread_mutex_unlock(&chunk->mutex);
 
+    // Build the mesh - NO locks held here, safer for neighbor lookups
+    if (needs_meshing) {
+        chunk_build_mesh(chunk, world);
+
+        // Re-acquire chunk->mutex to update meshed flag atomically
+        pthread_mutex_lock(&chunk->mutex);
+        chunk->meshed = true;
         pthread_mutex_unlock(&chunk->mutex);
+    } else if (!chunk->meshed && chunk->generated && chunk->loaded) {
+        // Chunk not ready yet, just mark it (avoid infinite loops)
+        pthread_mutex_lock(&chunk->mutex);
+        chunk->meshed = true;
+        pthread_mutex_unlock(&chunk->mutex);
+    }
+
+    // Decrement in-use counter for this chunk
+    __atomic_sub_fetch(&chunk->in_use_count, 1, __ATOMIC_ACQ_REL);
+}
+
+// Worker thread main function - processes chunks for generation, meshing and saving
+static void *worker_thread_main(void *arg) {
+    World *world = (World *)arg;
+    WorkerQueue *queue = &world->worker_queue;
+
+    pthread_mutex_lock(&queue->mutex);
+    while (true) {
+        // Wait for work or shutdown signal
+        while (queue->count == 0 && !queue->shutdown) {
+            pthread_cond_wait(&queue->cond, &queue->mutex);
+        }
+
+        if (queue->shutdown && queue->count == 0) {
+            break; // Exit thread
+        }
 
-        // Cache visible blocks (mesh) - NO locks held here, safer for neighbor lookups
-        if (needs_meshing) {
-            fprintf(stderr, "[worker] Caching visible blocks for chunk (%d,%d,%d)\n", chunk->chunk_x, chunk->chunk_y, chunk->chunk_z);
-            fflush(stderr);
-
-            chunk_cache_visible_blocks(chunk, world);
-
-            fprintf(stderr, "[worker] Cached %d visible blocks for chunk (%d,%d,%d)\n", chunk->visible_count[chunk->active_mesh], chunk->chunk_x, chunk->chunk_y, chunk->chunk_z);
-            fflush(stderr);
-
-            // Re-acquire chunk->mutex to update meshed flag atomically
-            pthread_mutex_lock(&chunk->mutex);
-            chunk->meshed = true;
-            pthread_mutex_unlock(&chunk->mutex);
-        } else if (!chunk->meshed && chunk->generated && chunk->loaded) {
-            // Chunk not ready yet, just mark it (avoid infinite loops)
-            pthread_mutex_lock(&chunk->mutex);
-            chunk->meshed = true;
-            pthread_mutex_unlock(&chunk->mutex);
+        // Pop and move the job from "waiting" to "in progress" under one lock: count
+        // always matches the heap (so a worker never finds it non-zero with nothing
+        // to pop), and worker_flush_queue never sees both counters at zero mid-handoff
+        WorkerJob job;
+        if (!worker_take_job(queue, &job)) {
+            continue;
         }
+        worker_job_set_remove(&queue->queued, job);
+        queue->count--;
+        queue->jobs_in_progress++;
+        pthread_mutex_unlock(&queue->mutex);
+
+        worker_run_job(world, job);
 
         // Mark job as complete
         pthread_mutex_lock(&queue->mutex);
         queue->jobs_in_progress--;
-        pthread_mutex_unlock(&queue->mutex);
-
-        // Decrement in-use counter for this chunk
-        __atomic_sub_fetch(&chunk->in_use_count, 1, __ATOMIC_ACQ_REL);
     }
+    pthread_mutex_unlock(&queue->mutex);
 
     return NULL;
 }
 
-// Initialize worker thread system
-void worker_init(World *world) {
-    if (!world) {
+// ============================================================================
+// POOL SETUP / TEARDOWN
+// ============================================================================
+
+// Initialize worker thread pool
+void worker_init(World *world, const WorkerConfig *config) {
+    if (!world || !config) {
         return;
     }
 
+    long core_count = sysconf(_SC_NPROCESSORS_ONLN);
+    if (core_count < 1) {
+        core_count = 1;
+    }
+
+    // Auto size: one worker per core, leaving a core for the main thread
+    int thread_count = config->thread_count;
+    if (thread_count <= 0) {
+        thread_count = (int)core_count - 1;
+    }
+    if (thread_count < 1) {
+        thread_count = 1;
+    }
+    if (thread_count > WORKER_MAX_THREADS) {
+        thread_count = WORKER_MAX_THREADS;
+    }
+
     WorkerQueue *queue = &world->worker_queue;
-    queue->capacity = 256;
+    queue->thread_count = thread_count;
     queue->count = 0;
     queue->jobs_in_progress = 0; // No jobs in progress initially
-    queue->queue = (WorkerJob *)malloc(sizeof(WorkerJob) * queue->capacity);
+    queue->next_sequence = 0;
+    queue->interest_position = (Vector3){0.0f, 0.0f, 0.0f};
+    queue->interest_forward = (Vector3){0.0f, 0.0f, 1.0f};
+    queue->interest_epoch = 0;
     queue->shutdown = false;
+    worker_job_set_init(&queue->queued, 256);
+    worker_heap_init(&queue->heap, 64);
+    queue->threads = (pthread_t *)malloc(sizeof(pthread_t) * thread_count);
     pthread_mutex_init(&queue->mutex, NULL);
     pthread_cond_init(&queue->cond, NULL);
 
-    // Start worker thread with CPU affinity optimization
     world->worker_running = true;
 
-    // OPTIMIZATION: Set thread attributes for better performance
-    pthread_attr_t thread_attr;
-    pthread_attr_init(&thread_attr);
+    for (int i = 0; i < thread_count; i++) {
+        pthread_attr_t thread_attr;
+        pthread_attr_init(&thread_attr);
 
-// Try to pin worker thread to second core (core 1) for better cache locality
-// Falls back gracefully if CPU affinity not supported
+// Optionally pin worker i to core i+1 (core 0 stays with the main thread)
 #ifdef __linux__
-    cpu_set_t cpuset;
-    CPU_ZERO(&cpuset);
-    // Pin to core 1 (reserve core 0 for main thread)
-    CPU_SET(1, &cpuset);
-    pthread_attr_setaffinity_np(&thread_attr, sizeof(cpu_set_t), &cpuset);
-    printf("[worker] Worker thread CPU affinity set to core 1\n");
+        if (config->pin_threads && core_count > 1) {
+            cpu_set_t cpuset;
+            CPU_ZERO(&cpuset);
+            CPU_SET((i + 1) % core_count, &cpuset);
+            pthread_attr_setaffinity_np(&thread_attr, sizeof(cpu_set_t), &cpuset);
+        }
 #endif
 
-    pthread_create(&world->worker_thread, &thread_attr, worker_thread_main, (void *)world);
-    pthread_attr_destroy(&thread_attr);
-    printf("[worker] Worker thread started\n");
+        pthread_create(&queue->threads[i], &thread_attr, worker_thread_main, world);
+        pthread_attr_destroy(&thread_attr);
+    }
+
+    printf("[worker] Started %d worker thread(s)%s\n", thread_count, config->pin_threads ? " (pinned)" : "");
 }
 
 // Internal helper to queue a job (with deduplication)
@@ -218,31 +543,72 @@ static void worker_queue_job(World *world, WorkerJob job) {
 
     pthread_mutex_lock(&queue->mutex);
 
-    // Check if job already in queue by coordinates+type
-    for (int i = 0; i < queue->count; i++) {
-        if (queue->queue[i].chunk_x == job.chunk_x &&
-            queue->queue[i].chunk_y == job.chunk_y &&
-            queue->queue[i].chunk_z == job.chunk_z &&
-            queue->queue[i].type == job.type) {
-            pthread_mutex_unlock(&queue->mutex);
-            return; // Already queued
-        }
+    // Skip if the same job (coordinates+type) is already waiting
+    if (!worker_job_set_insert(&queue->queued, job)) {
+        pthread_mutex_unlock(&queue->mutex);
+        return; // Already queued
     }
 
-    // Add to queue
-    if (queue->count >= queue->capacity) {
-        queue->capacity *= 2;
-        queue->queue = (WorkerJob *)realloc(queue->queue, sizeof(WorkerJob) * queue->capacity);
-    }
+    WorkerHeapEntry entry = {.job = job,
+                             .priority = worker_job_priority(job, queue->interest_position, queue->interest_forward),
+                             .sequence = queue->next_sequence++};
+
+    // If the heap is still on an old epoch it gets rebuilt on the next pop,
+    // which recomputes this entry's priority too
+    worker_heap_push(&queue->heap, entry);
 
-    queue->queue[queue->count++] = job;
-    const char *type_name = (job.type == WORKER_JOB_SAVE_CHUNK) ? "save" : "mesh";
+    queue->count++;
+    const char *type_name = job.type == WORKER_JOB_GENERATE ? "generate" : "mesh";
     printf("[worker] Queued %s job for chunk (%d,%d,%d)\n", type_name, job.chunk_x, job.chunk_y, job.chunk_z);
-    pthread_cond_signal(&queue->cond); // Wake up worker thread
+    pthread_cond_signal(&queue->cond); // Wake up one worker thread
+
+    pthread_mutex_unlock(&queue->mutex);
+}
+
+// Move the point mesh jobs are prioritised around. Queued jobs are re-ordered
+// lazily (on the heap's next pop) once the view has changed enough to matter.
+void worker_set_interest(World *world, Vector3 position, Vector3 forward) {
+    if (!world || !world->worker_running) {
+        return;
+    }
+
+    float length = sqrtf(forward.x * forward.x + forward.y * forward.y + forward.z * forward.z);
+    if (length < 0.0001f) {
+        return;
+    }
+    forward = (Vector3){forward.x / length, forward.y / length, forward.z / length};
+
+    WorkerQueue *queue = &world->worker_queue;
+    pthread_mutex_lock(&queue->mutex);
+
+    Vector3 old_forward = queue->interest_forward;
+    float cos_turn = old_forward.x * forward.x + old_forward.y * forward.y + old_forward.z * forward.z;
+    float dx = position.x - queue->interest_position.x;
+    float dy = position.y - queue->interest_position.y;
+    float dz = position.z - queue->interest_position.z;
+    float moved_sq = dx * dx + dy * dy + dz * dz;
+
+    if (cos_turn < WORKER_REPRIORITIZE_COS || moved_sq > WORKER_REPRIORITIZE_DISTANCE * WORKER_REPRIORITIZE_DISTANCE) {
+        queue->interest_position = position;
+        queue->interest_forward = forward;
+        queue->interest_epoch++;
+    }
 
     pthread_mutex_unlock(&queue->mutex);
 }
 
+// Snapshot of the interest point for other queues that order chunks by it. The
+// epoch changes whenever worker_set_interest moves the point.
+uint32_t worker_get_interest(World *world, Vector3 *position, Vector3 *forward) {
+    WorkerQueue *queue = &world->worker_queue;
+    pthread_mutex_lock(&queue->mutex);
+    *position = queue->interest_position;
+    *forward = queue->interest_forward;
+    uint32_t epoch = queue->interest_epoch;
+    pthread_mutex_unlock(&queue->mutex);
+    return epoch;
+}
+
 // Queue a chunk for processing (lighting + meshing)
 void worker_queue_chunk(World *world, Chunk *chunk) {
     if (!world || !chunk) {
@@ -256,25 +622,15 @@ void worker_queue_chunk(World *world, Chunk *chunk) {
     worker_queue_job(world, job);
 }
 
-// Queue a chunk for asynchronous saving
-void worker_queue_chunk_save(World *world, Chunk *chunk) {
+void worker_queue_chunk_generate(World *world, Chunk *chunk) {
     if (!world || !chunk) {
         return;
     }
 
-    // Avoid requeuing if already pending save
-    pthread_mutex_lock(&chunk->mutex);
-    if (chunk->pending_save) {
-        pthread_mutex_unlock(&chunk->mutex);
-        return;
-    }
-    chunk->pending_save = true;
-    pthread_mutex_unlock(&chunk->mutex);
-
     WorkerJob job = {.chunk_x = chunk->chunk_x,
                      .chunk_y = chunk->chunk_y,
                      .chunk_z = chunk->chunk_z,
-                     .type = WORKER_JOB_SAVE_CHUNK};
+                     .type = WORKER_JOB_GENERATE};
     worker_queue_job(world, job);
 }
 
@@ -287,11 +643,13 @@ void worker_flush_queue(World *world) {
 
     WorkerQueue *queue = &world->worker_queue;
 
-    // Wait for queue to be empty AND no jobs in progress
+    // Wait for the heap to be empty AND no jobs in progress
     int wait_count = 0;
     while (true) {
         pthread_mutex_lock(&queue->mutex);
         bool queue_empty = (queue->count == 0 && queue->jobs_in_progress == 0);
+        int count = queue->count;
+        int in_progress = queue->jobs_in_progress;
         pthread_mutex_unlock(&queue->mutex);
 
         if (queue_empty) {
@@ -300,7 +658,7 @@ void worker_flush_queue(World *world) {
         }
 
         if (wait_count % 10 == 0) {
-            printf("[worker] Waiting for queue... (count=%d, in_progress=%d)\n", queue->count, queue->jobs_in_progress);
+            printf("[worker] Waiting for queue... (count=%d, in_progress=%d)\n", count, in_progress);
         }
         wait_count++;
 
@@ -309,13 +667,13 @@ void worker_flush_queue(World *world) {
 
         // Timeout after 5 seconds to prevent infinite hang
         if (wait_count > 500) {
-            printf("[worker] WARNING: Queue flush timeout! (count=%d, in_progress=%d)\n", queue->count, queue->jobs_in_progress);
+            printf("[worker] WARNING: Queue flush timeout! (count=%d, in_progress=%d)\n", count, in_progress);
             break;
         }
     }
 }
 
-// Shut down worker thread cleanly
+// Shut down worker threads cleanly
 void worker_shutdown(World *world) {
     if (!world) {
         return;
@@ -329,16 +687,21 @@ void worker_shutdown(World *world) {
     pthread_cond_broadcast(&queue->cond);
     pthread_mutex_unlock(&queue->mutex);
 
-    // Wait for thread to exit
-    printf("[worker] Waiting for worker thread to exit...\n");
-    pthread_join(world->worker_thread, NULL);
-    printf("[worker] Worker thread exited\n");
+    // Wait for threads to exit
+    printf("[worker] Waiting for %d worker thread(s) to exit...\n", queue->thread_count);
+    for (int i = 0; i < queue->thread_count; i++) {
+        pthread_join(queue->threads[i], NULL);
+    }
+    printf("[worker] Worker threads exited\n");
 
-    // Clean up queue
+    // Clean up the heap and the dedup set
+    worker_heap_destroy(&queue->heap);
+    worker_job_set_destroy(&queue->queued);
+    free(queue->threads);
+    queue->threads = NULL;
     pthread_mutex_destroy(&queue->mutex);
     pthread_cond_destroy(&queue->cond);
-    free(queue->queue);
 
     world->worker_running = false;
-    printf("[worker] Worker thread shut down\n");
+    printf("[worker] Worker pool shut down\n");
 }
@@ -1,20 +1,30 @@
 #include <math.h>
 #include <pthread.h>
+#include <sched.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
 #include <time.h>
 #include <zlib.h>
 
+#ifndef _WIN32
+#include <unistd.h>
+#endif
+
+#ifdef HAVE_LZ4
+#include <lz4.h>
+#endif
+
 #include "../../include/player.h"
 #include "raylib.h"
 #include "../../include/world.h"
 
 // Chunk loader helper declaration needed before use in world_load_or_create_chunk.
-static bool load_chunk_from_file(FILE *file, Chunk *chunk);
+static bool load_chunk_from_buffer(const uint8_t *data, size_t size, Chunk *chunk);
 
-// Human-readable error for last chunk load failure (used for diagnostics)
-static char CHUNK_LOAD_ERROR[256];
+// Human-readable error for last chunk load failure (used for diagnostics), per thread
+// as the chunk read engine decodes records off the main thread
+static _Thread_local char CHUNK_LOAD_ERROR[256];
 
 // forward declare helper to write players file (defined later)
 static void write_players_file(World *world, void *player_ptr, const char *world_name);
@@ -22,83 +32,266 @@ static void write_players_file(World *world, void *player_ptr, const char *world
 // ============================================================================
 // ISSUE #1: SPATIAL HASH TABLE FOR CHUNK LOOKUP (O(1) instead of O(n))
 // ============================================================================
+// Robin Hood open addressing over a power-of-two table. On insert, an entry
+// that has probed further than the resident one takes its slot, which keeps
+// probe lengths short and lets lookups stop as soon as they pass an entry
+// closer to home than themselves. Removal shifts the following run back one
+// slot, so there are no tombstones and chains never break. The table doubles
+// once it passes CHUNK_HASH_MAX_LOAD.
+//
+// Writers hold world->cache_mutex. world_get_block reads without it through
+// chunk_hash_lookup_concurrent: every write is bracketed by the hash_seq
+// seqlock, entries are stored field by field with atomic stores, and a reader
+// retries if the sequence moved under it. Replaced tables are freed through the
+// chunk pool's read epochs, so a reader never probes freed memory.
+//
+// The table only needs a ChunkCache, so --hash-bench drives one on its own
+// through the non-static functions below.
+
+#define CHUNK_HASH_INITIAL_CAPACITY 1024
+
+// Hash function for chunk coordinates (Issue #1). Each axis gets its own odd
+// multiplier, then a murmur3 finalizer spreads neighbouring chunks over the table.
+static uint32_t chunk_hash_func(int32_t chunk_x, int32_t chunk_y, int32_t chunk_z) {
+    uint64_t h = (uint64_t)(uint32_t)chunk_x * 0x9E3779B97F4A7C15ull;
+    h ^= (uint64_t)(uint32_t)chunk_y * 0xC2B2AE3D27D4EB4Full;
+    h ^= (uint64_t)(uint32_t)chunk_z * 0x165667B19E3779F9ull;
+    h ^= h >> 33;
+    h *= 0xFF51AFD7ED558CCDull;
+    h ^= h >> 33;
+    h *= 0xC4CEB9FE1A85EC53ull;
+    h ^= h >> 33;
+    return (uint32_t)h;
+}
+
+// How far an entry sits from its home slot
+static inline uint32_t chunk_hash_distance(const ChunkCache *cache, uint32_t hash, uint32_t slot) {
+    return (slot - hash) & (uint32_t)(cache->hash_capacity - 1);
+}
+
+// Store an entry so that concurrent readers see each field whole
+static inline void chunk_hash_store(ChunkHashEntry *slot, const ChunkHashEntry *entry) {
+    __atomic_store_n(&slot->chunk_x, entry->chunk_x, __ATOMIC_RELAXED);
+    __atomic_store_n(&slot->chunk_y, entry->chunk_y, __ATOMIC_RELAXED);
+    __atomic_store_n(&slot->chunk_z, entry->chunk_z, __ATOMIC_RELAXED);
+    __atomic_store_n(&slot->hash, entry->hash, __ATOMIC_RELAXED);
+    __atomic_store_n(&slot->chunk, entry->chunk, __ATOMIC_RELAXED);
+}
+
+static inline void chunk_hash_write_begin(ChunkCache *cache) {
+    __atomic_store_n(&cache->hash_seq, cache->hash_seq + 1, __ATOMIC_RELAXED);
+    __atomic_thread_fence(__ATOMIC_RELEASE);
+}
+
+static inline void chunk_hash_write_end(ChunkCache *cache) {
+    __atomic_store_n(&cache->hash_seq, cache->hash_seq + 1, __ATOMIC_RELEASE);
+}
+
+// Install an empty table. The table pointer is published before the capacity,
+// so a reader that sees the new capacity also sees the new (larger) table.
+static bool chunk_hash_alloc(ChunkCache *cache, int capacity) {
+    ChunkHashEntry *table = (ChunkHashEntry *)calloc((size_t)capacity, sizeof(ChunkHashEntry));
+    if (!table) {
+        return false;
+    }
+    __atomic_store_n(&cache->hash_table, table, __ATOMIC_RELEASE);
+    __atomic_store_n(&cache->hash_capacity, capacity, __ATOMIC_RELEASE);
+    cache->hash_count = 0;
+    return true;
+}
 
-// Hash function for chunk coordinates (Issue #1)
-static uint32_t chunk_hash_func(int32_t chunk_x, int32_t chunk_y, int32_t chunk_z, uint32_t capacity) {
-    // Combine coordinates using FNV-1a hash-like mixing
-    uint64_t h = 2166136261u;
-    h ^= (uint32_t)chunk_x;
-    h = h * 16777619u;
-    h ^= (uint32_t)chunk_y;
-    h = h * 16777619u;
-    h ^= (uint32_t)chunk_z;
-    h = h * 16777619u;
-    return h % capacity;
-}
-
-// Insert chunk into hash table (Issue #1)
-static void chunk_hash_insert(ChunkCache *cache, int32_t chunk_x, int32_t chunk_y, int32_t chunk_z, Chunk *chunk) {
+// Place an entry known not to be in the table. Assumes a free slot exists.
+static void chunk_hash_place(ChunkCache *cache, ChunkHashEntry entry) {
+    uint32_t mask = (uint32_t)(cache->hash_capacity - 1);
+    uint32_t slot = entry.hash & mask;
+    uint32_t distance = 0;
+
+    while (cache->hash_table[slot].chunk) {
+        ChunkHashEntry *resident = &cache->hash_table[slot];
+        uint32_t resident_distance = chunk_hash_distance(cache, resident->hash, slot);
+        if (resident_distance < distance) {
+            // Take from the rich: the resident is closer to home, so it moves on instead
+            ChunkHashEntry displaced = *resident;
+            chunk_hash_store(resident, &entry);
+            entry = displaced;
+            distance = resident_distance;
+        }
+        slot = (slot + 1) & mask;
+        distance++;
+    }
+    chunk_hash_store(&cache->hash_table[slot], &entry);
+    cache->hash_count++;
+}
+
+// Empty table of `capacity` slots (a power of two). False, with no table, on OOM.
+bool chunk_hash_init(ChunkCache *cache, int capacity) {
+    cache->hash_seq = 0;
+    if (!chunk_hash_alloc(cache, capacity)) {
+        cache->hash_table = NULL;
+        cache->hash_capacity = 0;
+        cache->hash_count = 0;
+        return false;
+    }
+    return true;
+}
+
+// Free the table. Tables replaced by a grow are freed by chunk_pool_destroy.
+void chunk_hash_destroy(ChunkCache *cache) {
+    free(cache->hash_table);
+    cache->hash_table = NULL;
+    cache->hash_capacity = 0;
+    cache->hash_count = 0;
+}
+
+// Double the table and rehash every entry
+static bool chunk_hash_grow(ChunkCache *cache) {
+    ChunkHashEntry *old_table = cache->hash_table;
+    int old_capacity = cache->hash_capacity;
+
+    if (!chunk_hash_alloc(cache, old_capacity * 2)) {
+        return false; // Old table is left untouched
+    }
+    for (int i = 0; i < old_capacity; i++) {
+        if (old_table[i].chunk) {
+            chunk_hash_place(cache, old_table[i]);
+        }
+    }
+    chunk_pool_defer_free(cache, old_table); // Lock-free readers may still be probing it
+    return true;
+}
+
+// Find the slot holding a chunk, or -1
+static int chunk_hash_find(const ChunkCache *cache, int32_t chunk_x, int32_t chunk_y, int32_t chunk_z) {
     if (!cache->hash_table) {
-        return;
+        return -1;
     }
 
-    uint32_t idx = chunk_hash_func(chunk_x, chunk_y, chunk_z, cache->hash_capacity);
+    uint32_t mask = (uint32_t)(cache->hash_capacity - 1);
+    uint32_t hash = chunk_hash_func(chunk_x, chunk_y, chunk_z);
+    uint32_t slot = hash & mask;
 
-    // Linear probing with wrap-around
-    for (uint32_t i = 0; i < cache->hash_capacity; i++) {
-        uint32_t probe_idx = (idx + i) % cache->hash_capacity;
-        if (!cache->hash_table[probe_idx].chunk) {
-            cache->hash_table[probe_idx].chunk_x = chunk_x;
-            cache->hash_table[probe_idx].chunk_y = chunk_y;
-            cache->hash_table[probe_idx].chunk_z = chunk_z;
-            cache->hash_table[probe_idx].chunk = chunk;
-            return;
+    for (uint32_t distance = 0;; distance++) {
+        const ChunkHashEntry *entry = &cache->hash_table[slot];
+        if (!entry->chunk || chunk_hash_distance(cache, entry->hash, slot) < distance) {
+            return -1; // Empty slot, or a richer entry our key would have displaced
         }
+        if (entry->hash == hash && entry->chunk_x == chunk_x && entry->chunk_y == chunk_y && entry->chunk_z == chunk_z) {
+            return (int)slot;
+        }
+        slot = (slot + 1) & mask;
     }
 }
 
-// Remove chunk from hash table (Issue #1)
-static void chunk_hash_remove(ChunkCache *cache, int32_t chunk_x, int32_t chunk_y, int32_t chunk_z) {
+// Insert chunk into hash table (Issue #1), replacing any entry for the same coordinates
+void chunk_hash_insert(ChunkCache *cache, int32_t chunk_x, int32_t chunk_y, int32_t chunk_z, Chunk *chunk) {
     if (!cache->hash_table) {
         return;
     }
 
-    uint32_t idx = chunk_hash_func(chunk_x, chunk_y, chunk_z, cache->hash_capacity);
+    chunk_hash_write_begin(cache);
 
-    // Linear probing to find and remove
-    for (uint32_t i = 0; i < cache->hash_capacity; i++) {
-        uint32_t probe_idx = (idx + i) % cache->hash_capacity;
-        if (cache->hash_table[probe_idx].chunk &&
-            cache->hash_table[probe_idx].chunk_x == chunk_x &&
-            cache->hash_table[probe_idx].chunk_y == chunk_y &&
-            cache->hash_table[probe_idx].chunk_z == chunk_z) {
-            cache->hash_table[probe_idx].chunk = NULL;
+    int existing = chunk_hash_find(cache, chunk_x, chunk_y, chunk_z);
+    if (existing >= 0) {
+        __atomic_store_n(&cache->hash_table[existing].chunk, chunk, __ATOMIC_RELAXED);
+        chunk_hash_write_end(cache);
+        return;
+    }
+
+    if ((float)(cache->hash_count + 1) > (float)cache->hash_capacity * CHUNK_HASH_MAX_LOAD && !chunk_hash_grow(cache)) {
+        if (cache->hash_count + 1 >= cache->hash_capacity) {
+            fprintf(stderr, "[ERROR] Chunk hash table full (%d entries) and could not grow\n", cache->hash_count);
+            chunk_hash_write_end(cache);
             return;
         }
     }
+
+    ChunkHashEntry entry = {.chunk_x = chunk_x, .chunk_y = chunk_y, .chunk_z = chunk_z, .hash = chunk_hash_func(chunk_x, chunk_y, chunk_z), .chunk = chunk};
+    chunk_hash_place(cache, entry);
+    chunk_hash_write_end(cache);
 }
 
-// Lookup chunk in hash table (Issue #1)
-static Chunk *chunk_hash_lookup(ChunkCache *cache, int32_t chunk_x, int32_t chunk_y, int32_t chunk_z) {
-    if (!cache->hash_table) {
-        return NULL;
+// Remove chunk from hash table (Issue #1) with backward-shift deletion
+void chunk_hash_remove(ChunkCache *cache, int32_t chunk_x, int32_t chunk_y, int32_t chunk_z) {
+    int found = chunk_hash_find(cache, chunk_x, chunk_y, chunk_z);
+    if (found < 0) {
+        return;
     }
 
-    uint32_t idx = chunk_hash_func(chunk_x, chunk_y, chunk_z, cache->hash_capacity);
+    chunk_hash_write_begin(cache);
+    uint32_t mask = (uint32_t)(cache->hash_capacity - 1);
+    uint32_t slot = (uint32_t)found;
+    uint32_t next = (slot + 1) & mask;
+    // Pull the rest of the run back until an empty slot or an entry already at home
+    while (cache->hash_table[next].chunk && chunk_hash_distance(cache, cache->hash_table[next].hash, next) > 0) {
+        chunk_hash_store(&cache->hash_table[slot], &cache->hash_table[next]);
+        slot = next;
+        next = (next + 1) & mask;
+    }
+    __atomic_store_n(&cache->hash_table[slot].chunk, NULL, __ATOMIC_RELAXED);
+    cache->hash_count--;
+    chunk_hash_write_end(cache);
+}
+
+// Lookup chunk in hash table (Issue #1)
+Chunk *chunk_hash_lookup(ChunkCache *cache, int32_t chunk_x, int32_t chunk_y, int32_t chunk_z) {
+    int slot = chunk_hash_find(cache, chunk_x, chunk_y, chunk_z);
+    return slot >= 0 ? cache->hash_table[slot].chunk : NULL;
+}
+
+// Lookup for callers that don't hold cache_mutex (see the section comment).
+// Must be called inside chunk_read_begin/end, which keeps the returned chunk
+// and the probed table from being freed.
+static Chunk *chunk_hash_lookup_concurrent(ChunkCache *cache, int32_t chunk_x, int32_t chunk_y, int32_t chunk_z) {
+    uint32_t hash = chunk_hash_func(chunk_x, chunk_y, chunk_z);
+
+    for (;;) {
+        uint32_t seq = __atomic_load_n(&cache->hash_seq, __ATOMIC_ACQUIRE);
+        if (seq & 1) {
+            sched_yield(); // Writer mid-update; it only holds the sequence for a few stores
+            continue;
+        }
 
-    // Linear probing to find entry
-    for (uint32_t i = 0; i < cache->hash_capacity; i++) {
-        uint32_t probe_idx = (idx + i) % cache->hash_capacity;
-        if (cache->hash_table[probe_idx].chunk == NULL) {
-            return NULL; // Empty slot, not found
+        // Capacity before table: a grow publishes them in the opposite order
+        int capacity = __atomic_load_n(&cache->hash_capacity, __ATOMIC_ACQUIRE);
+        ChunkHashEntry *table = __atomic_load_n(&cache->hash_table, __ATOMIC_ACQUIRE);
+        Chunk *found = NULL;
+
+        if (table) {
+            uint32_t mask = (uint32_t)(capacity - 1);
+            uint32_t slot = hash & mask;
+            // Bounded so a torn view of the table can't probe forever
+            for (uint32_t distance = 0; distance < (uint32_t)capacity; distance++) {
+                Chunk *chunk = __atomic_load_n(&table[slot].chunk, __ATOMIC_RELAXED);
+                uint32_t entry_hash = __atomic_load_n(&table[slot].hash, __ATOMIC_RELAXED);
+                if (!chunk || ((slot - entry_hash) & mask) < distance) {
+                    break;
+                }
+                if (entry_hash == hash &&
+                    __atomic_load_n(&table[slot].chunk_x, __ATOMIC_RELAXED) == chunk_x &&
+                    __atomic_load_n(&table[slot].chunk_y, __ATOMIC_RELAXED) == chunk_y &&
+                    __atomic_load_n(&table[slot].chunk_z, __ATOMIC_RELAXED) == chunk_z) {
+                    found = chunk;
+                    break;
+                }
+                slot = (slot + 1) & mask;
+            }
         }
-        if (cache->hash_table[probe_idx].chunk_x == chunk_x &&
-            cache->hash_table[probe_idx].chunk_y == chunk_y &&
-            cache->hash_table[probe_idx].chunk_z == chunk_z) {
-            return cache->hash_table[probe_idx].chunk;
+
+        __atomic_thread_fence(__ATOMIC_ACQUIRE);
+        if (__atomic_load_n(&cache->hash_seq, __ATOMIC_RELAXED) == seq) {
+            return found;
         }
     }
-    return NULL;
+}
+
+// Drop every entry, keeping the current capacity
+static void chunk_hash_clear(ChunkCache *cache) {
+    chunk_hash_write_begin(cache);
+    for (int i = 0; i < cache->hash_capacity; i++) {
+        __atomic_store_n(&cache->hash_table[i].chunk, NULL, __ATOMIC_RELAXED);
+    }
+    cache->hash_count = 0;
+    chunk_hash_write_end(cache);
 }
 
 // ============================================================================
@@ -174,6 +367,60 @@ static float fbm_noise(float x, float z, int octaves, uint64_t seed) {
     return value / max_value;
 }
 
+// Ridge-based noise for cave systems (simple 2D representation)
+static float ridge_noise(float x, float z, uint64_t seed) {
+    float value = fbm_noise(x * 0.02f, z * 0.02f, 2, seed + 1000);
+    float ridge = 1.0f - fabsf(2.0f * value - 1.0f);
+    return ridge;
+}
+
+// Smooth a column's height against its 8 neighbours (heights ordered dx-major, dz-minor; center is heights[4])
+static int smooth_height_samples(const float heights[9]) {
+    // Center is heights[4]
+    float center = heights[4];
+
+    // Count how many neighbors are significantly different (more than 2 blocks away)
+    int isolated_count = 0;
+    for (int i = 0; i < 9; i++) {
+        if (i != 4) {
+            if (fabsf(heights[i] - center) > 2.0f) {
+                isolated_count++;
+            }
+        }
+    }
+
+    // If this position is isolated (8 neighbors different), smooth it toward their average
+    if (isolated_count == 8) {
+        float neighbor_sum = 0.0f;
+        for (int i = 0; i < 9; i++) {
+            if (i != 4) {
+                neighbor_sum += heights[i];
+            }
+        }
+        float neighbor_avg = neighbor_sum / 8.0f;
+        center = center * 0.4f + neighbor_avg * 0.6f; // Blend 40/60 toward neighbors
+    }
+
+    return (int)(center);
+}
+
+// ============================================================================
+// BATCH NOISE KERNELS
+// ============================================================================
+// Row/column versions of the noise functions above. Each returns exactly what
+// the per-sample function returns for the same inputs, so existing seeds keep
+// generating the same terrain:
+//  - lattice corner values are hashed once per noise cell instead of once per
+//    sample (neighbouring samples at low frequencies share a cell), and
+//  - the per-sample float math runs as straight loops over arrays, written with
+//    the same expressions as the scalar code. The compiler vectorises them for
+//    the target (SSE2 baseline, AVX2 with -mavx2) while applying the same
+//    rounding and FMA contraction as it does to the scalar functions, which
+//    hand-written intrinsics could not guarantee.
+// The per-sample reference path (terrain_height_seeded and cave_noise_3d) stays
+// compiled in: world_generate_chunk_blocks_reference runs it, and --noise-bench
+// checks both paths generate the same blocks.
+
 // Generate terrain height at a world position using seeded noise
 static float terrain_height_seeded(float x, float z, uint64_t seed) {
     // Base terrain with multiple scales for much smoother transitions
@@ -208,54 +455,6 @@ static float terrain_height_seeded(float x, float z, uint64_t seed) {
     return height;
 }
 
-// Smooth terrain height to reduce 1-block stubs while preserving land relief
-static int smooth_terrain_height(int x, int z, uint64_t seed) {
-    // Sample this position and its 8 neighbors
-    float heights[9];
-    int idx = 0;
-
-    for (int dx = -1; dx <= 1; dx++) {
-        for (int dz = -1; dz <= 1; dz++) {
-            heights[idx] = terrain_height_seeded((float)(x + dx), (float)(z + dz), seed);
-            idx++;
-        }
-    }
-
-    // Center is heights[4]
-    float center = heights[4];
-
-    // Count how many neighbors are significantly different (more than 2 blocks away)
-    int isolated_count = 0;
-    for (int i = 0; i < 9; i++) {
-        if (i != 4) {
-            if (fabsf(heights[i] - center) > 2.0f) {
-                isolated_count++;
-            }
-        }
-    }
-
-    // If this position is isolated (8 neighbors different), smooth it toward their average
-    if (isolated_count == 8) {
-        float neighbor_sum = 0.0f;
-        for (int i = 0; i < 9; i++) {
-            if (i != 4) {
-                neighbor_sum += heights[i];
-            }
-        }
-        float neighbor_avg = neighbor_sum / 8.0f;
-        center = center * 0.4f + neighbor_avg * 0.6f; // Blend 40/60 toward neighbors
-    }
-
-    return (int)(center);
-}
-
-// Ridge-based noise for cave systems (simple 2D representation)
-static float ridge_noise(float x, float z, uint64_t seed) {
-    float value = fbm_noise(x * 0.02f, z * 0.02f, 2, seed + 1000);
-    float ridge = 1.0f - fabsf(2.0f * value - 1.0f);
-    return ridge;
-}
-
 // 3D cave noise for generating connected cave systems with proper interpolation
 static float cave_noise_3d(float x, float y, float z, uint64_t seed) {
     int xi = (int)floorf(x);
@@ -297,20 +496,450 @@ static float cave_noise_3d(float x, float y, float z, uint64_t seed) {
     return result;
 }
 
+// Per-sample versions of the batch entry points used by world_generate_chunk_blocks
+static void terrain_height_row_reference(int x0, int z, int n, uint64_t seed, float *out) {
+    for (int i = 0; i < n; i++) {
+        out[i] = terrain_height_seeded((float)(x0 + i), (float)z, seed);
+    }
+}
+
+static void cave_band_column_reference(int world_x, int world_z, int y0, int n, const float scales[3], uint64_t seed, float threshold, bool *is_cave) {
+    for (int i = 0; i < n; i++) {
+        int world_y = y0 + i;
+        float cave_val = 0.0f;
+        float cave_amp = 1.0f;
+
+        cave_val += cave_amp * cave_noise_3d(
+                                   (float)world_x * scales[0],
+                                   (float)world_y * scales[0],
+                                   (float)world_z * scales[0],
+                                   seed);
+        cave_amp *= 0.7f;
+
+        cave_val += cave_amp * cave_noise_3d(
+                                   (float)world_x * scales[1],
+                                   (float)world_y * scales[1],
+                                   (float)world_z * scales[1],
+                                   seed + 1);
+        cave_amp *= 0.6f;
+
+        cave_val += cave_amp * cave_noise_3d(
+                                   (float)world_x * scales[2],
+                                   (float)world_y * scales[2],
+                                   (float)world_z * scales[2],
+                                   seed + 2);
+
+        cave_val /= 2.3f;
+        is_cave[i] = cave_val < threshold;
+    }
+}
+
+#define NOISE_BATCH_MAX 64 // Largest n any batch kernel accepts
+
+// Perlin noise for n samples at (xs[i], zs[i]); matches perlin_noise
+static void perlin_noise_batch(const float *xs, const float *zs, int n, uint64_t seed, float *out) {
+    int xi[NOISE_BATCH_MAX];
+    int zi[NOISE_BATCH_MAX];
+    float u[NOISE_BATCH_MAX];
+    float v[NOISE_BATCH_MAX];
+    float n00[NOISE_BATCH_MAX];
+    float n10[NOISE_BATCH_MAX];
+    float n01[NOISE_BATCH_MAX];
+    float n11[NOISE_BATCH_MAX];
+
+    for (int i = 0; i < n; i++) {
+        xi[i] = (int)floorf(xs[i]);
+        zi[i] = (int)floorf(zs[i]);
+    }
+
+    for (int i = 0; i < n; i++) {
+        float xf = xs[i] - xi[i];
+        float zf = zs[i] - zi[i];
+        u[i] = xf * xf * xf * (xf * (xf * 6.0f - 15.0f) + 10.0f);
+        v[i] = zf * zf * zf * (zf * (zf * 6.0f - 15.0f) + 10.0f);
+    }
+
+    // Corner values only change when a sample crosses into a new cell
+    int cell_x = 0;
+    int cell_z = 0;
+    float c00 = 0.0f, c10 = 0.0f, c01 = 0.0f, c11 = 0.0f;
+    for (int i = 0; i < n; i++) {
+        if (i == 0 || xi[i] != cell_x || zi[i] != cell_z) {
+            cell_x = xi[i];
+            cell_z = zi[i];
+            c00 = noise_value((float)cell_x, (float)cell_z, seed);
+            c10 = noise_value((float)(cell_x + 1), (float)cell_z, seed);
+            c01 = noise_value((float)cell_x, (float)(cell_z + 1), seed);
+            c11 = noise_value((float)(cell_x + 1), (float)(cell_z + 1), seed);
+        }
+        n00[i] = c00;
+        n10[i] = c10;
+        n01[i] = c01;
+        n11[i] = c11;
+    }
+
+    for (int i = 0; i < n; i++) {
+        float nx0 = n00[i] * (1.0f - u[i]) + n10[i] * u[i];
+        float nx1 = n01[i] * (1.0f - u[i]) + n11[i] * u[i];
+        out[i] = nx0 * (1.0f - v[i]) + nx1 * v[i];
+    }
+}
+
+// fBm for n samples; matches fbm_noise
+static void fbm_noise_batch(const float *xs, const float *zs, int n, int octaves, uint64_t seed, float *out) {
+    float value[NOISE_BATCH_MAX];
+    float sample_x[NOISE_BATCH_MAX];
+    float sample_z[NOISE_BATCH_MAX];
+    float noise[NOISE_BATCH_MAX];
+    float amplitude = 1.0f;
+    float frequency = 1.0f;
+    float max_value = 0.0f;
+
+    for (int i = 0; i < n; i++) {
+        value[i] = 0.0f;
+    }
+
+    for (int octave = 0; octave < octaves; octave++) {
+        for (int i = 0; i < n; i++) {
+            sample_x[i] = xs[i] * frequency;
+            sample_z[i] = zs[i] * frequency;
+        }
+        perlin_noise_batch(sample_x, sample_z, n, seed + octave, noise);
+        for (int i = 0; i < n; i++) {
+            value[i] += amplitude * noise[i];
+        }
+        max_value += amplitude;
+        amplitude *= 0.5f;
+        frequency *= 2.0f;
+    }
+
+    for (int i = 0; i < n; i++) {
+        out[i] = value[i] / max_value;
+    }
+}
+
+// Add one fBm layer of terrain_height_seeded to heights
+static void terrain_height_layer(const float *xs, const float *zs, int n, float scale, int octaves, uint64_t seed, float weight, float *heights) {
+    float sample_x[NOISE_BATCH_MAX];
+    float sample_z[NOISE_BATCH_MAX];
+    float noise[NOISE_BATCH_MAX];
+
+    for (int i = 0; i < n; i++) {
+        sample_x[i] = xs[i] * scale;
+        sample_z[i] = zs[i] * scale;
+    }
+    fbm_noise_batch(sample_x, sample_z, n, octaves, seed, noise);
+    for (int i = 0; i < n; i++) {
+        heights[i] += noise[i] * weight;
+    }
+}
+
+// Terrain height for n samples; matches terrain_height_seeded
+static void terrain_height_batch(const float *xs, const float *zs, int n, uint64_t seed, float *heights) {
+    for (int i = 0; i < n; i++) {
+        heights[i] = 0.0f;
+    }
+
+    terrain_height_layer(xs, zs, n, 0.0008f, 5, seed, 20.0f, heights);
+    terrain_height_layer(xs, zs, n, 0.002f, 6, seed + 1, 16.0f, heights);
+    terrain_height_layer(xs, zs, n, 0.008f, 5, seed + 2, 10.0f, heights);
+    terrain_height_layer(xs, zs, n, 0.025f, 4, seed + 50, 6.0f, heights);
+    terrain_height_layer(xs, zs, n, 0.06f, 3, seed + 100, 1.0f, heights);
+
+    for (int i = 0; i < n; i++) {
+        heights[i] += 100.0f;
+        if (heights[i] < 85.0f) {
+            heights[i] = 85.0f;
+        }
+        if (heights[i] > 120.0f) {
+            heights[i] = 120.0f;
+        }
+    }
+}
+
+// Raw terrain heights for n consecutive columns (x0 .. x0+n-1) at row z
+static void terrain_height_row(int x0, int z, int n, uint64_t seed, float *out) {
+    float xs[NOISE_BATCH_MAX];
+    float zs[NOISE_BATCH_MAX];
+
+    for (int i = 0; i < n; i++) {
+        xs[i] = (float)(x0 + i);
+        zs[i] = (float)z;
+    }
+    terrain_height_batch(xs, zs, n, seed, out);
+}
+
+// 3D cave noise for n samples stacked along y at a fixed (x, z); matches cave_noise_3d
+static void cave_noise_3d_column(float x, const float *ys, float z, int n, uint64_t seed, float *out) {
+    int xi = (int)floorf(x);
+    int zi = (int)floorf(z);
+    float xf = x - xi;
+    float zf = z - zi;
+    float u = xf * xf * xf * (xf * (xf * 6.0f - 15.0f) + 10.0f);
+    float w = zf * zf * zf * (zf * (zf * 6.0f - 15.0f) + 10.0f);
+
+    int yi[NOISE_BATCH_MAX];
+    float v[NOISE_BATCH_MAX];
+    float c00[NOISE_BATCH_MAX];
+    float c10[NOISE_BATCH_MAX];
+    float c01[NOISE_BATCH_MAX];
+    float c11[NOISE_BATCH_MAX];
+
+    for (int i = 0; i < n; i++) {
+        yi[i] = (int)floorf(ys[i]);
+        float yf = ys[i] - yi[i];
+        v[i] = yf * yf * yf * (yf * (yf * 6.0f - 15.0f) + 10.0f);
+    }
+
+    // x and z are fixed, so the x-interpolated corner pairs only change with the y cell
+    int cell_y = 0;
+    float e00 = 0.0f, e10 = 0.0f, e01 = 0.0f, e11 = 0.0f;
+    for (int i = 0; i < n; i++) {
+        if (i == 0 || yi[i] != cell_y) {
+            cell_y = yi[i];
+            float c000 = (float)(hash_seed(xi, cell_y, zi + seed) % 1000) / 1000.0f;
+            float c100 = (float)(hash_seed(xi + 1, cell_y, zi + seed) % 1000) / 1000.0f;
+            float c010 = (float)(hash_seed(xi, cell_y + 1, zi + seed) % 1000) / 1000.0f;
+            float c110 = (float)(hash_seed(xi + 1, cell_y + 1, zi + seed) % 1000) / 1000.0f;
+            float c001 = (float)(hash_seed(xi, cell_y, zi + 1 + seed) % 1000) / 1000.0f;
+            float c101 = (float)(hash_seed(xi + 1, cell_y, zi + 1 + seed) % 1000) / 1000.0f;
+            float c011 = (float)(hash_seed(xi, cell_y + 1, zi + 1 + seed) % 1000) / 1000.0f;
+            float c111 = (float)(hash_seed(xi + 1, cell_y + 1, zi + 1 + seed) % 1000) / 1000.0f;
+            e00 = c000 * (1.0f - u) + c100 * u;
+            e10 = c010 * (1.0f - u) + c110 * u;
+            e01 = c001 * (1.0f - u) + c101 * u;
+            e11 = c011 * (1.0f - u) + c111 * u;
+        }
+        c00[i] = e00;
+        c10[i] = e10;
+        c01[i] = e01;
+        c11[i] = e11;
+    }
+
+    for (int i = 0; i < n; i++) {
+        float c0 = c00[i] * (1.0f - v[i]) + c10[i] * v[i];
+        float c1 = c01[i] * (1.0f - v[i]) + c11[i] * v[i];
+        out[i] = c0 * (1.0f - w) + c1 * w;
+    }
+}
+
+// Add one layer of cave noise for world_y = y0 .. y0+n-1 in column (world_x, world_z)
+static void cave_layer_column(int world_x, int world_z, int y0, int n, float scale, uint64_t seed, float amplitude, float *cave_val) {
+    float ys[NOISE_BATCH_MAX];
+    float noise[NOISE_BATCH_MAX];
+
+    for (int i = 0; i < n; i++) {
+        ys[i] = (float)(y0 + i) * scale;
+    }
+    cave_noise_3d_column((float)world_x * scale, ys, (float)world_z * scale, n, seed, noise);
+    for (int i = 0; i < n; i++) {
+        cave_val[i] += amplitude * noise[i];
+    }
+}
+
+// Cave test for world_y = y0 .. y0+n-1 within one cave band; matches the per-block
+// test in world_generate_chunk_blocks
+static void cave_band_column(int world_x, int world_z, int y0, int n, const float scales[3], uint64_t seed, float threshold, bool *is_cave) {
+    float cave_val[NOISE_BATCH_MAX];
+    float cave_amp = 1.0f;
+
+    for (int i = 0; i < n; i++) {
+        cave_val[i] = 0.0f;
+    }
+
+    cave_layer_column(world_x, world_z, y0, n, scales[0], seed, cave_amp, cave_val);
+    cave_amp *= 0.7f;
+    cave_layer_column(world_x, world_z, y0, n, scales[1], seed + 1, cave_amp, cave_val);
+    cave_amp *= 0.6f;
+    cave_layer_column(world_x, world_z, y0, n, scales[2], seed + 2, cave_amp, cave_val);
+
+    for (int i = 0; i < n; i++) {
+        cave_val[i] /= 2.3f;
+        is_cave[i] = cave_val[i] < threshold;
+    }
+}
+
+// ============================================================================
+// HEIGHTMAP CACHE
+// ============================================================================
+// Terrain height only depends on (x, z), so every chunk in a vertical stack
+// shares the same heightmap. Each tile holds the raw heights of one chunk
+// column plus a one-block margin (needed by the 3x3 smoothing) and the smoothed
+// result, so a column is sampled once instead of 9 times per chunk_y.
+
+#define HEIGHTMAP_CACHE_SIZE 256
+
+typedef struct {
+    int32_t chunk_x;
+    int32_t chunk_z;
+    uint64_t seed;
+    bool reference;                        // Built by the per-sample reference path
+    bool valid;
+    uint64_t last_used;                    // LRU stamp
+    int heights[CHUNK_DEPTH][CHUNK_WIDTH]; // Smoothed surface height per column
+} HeightmapTile;
+
+static HeightmapTile heightmap_cache[HEIGHTMAP_CACHE_SIZE];
+static uint64_t heightmap_cache_clock = 0;
+static pthread_mutex_t heightmap_cache_mutex = PTHREAD_MUTEX_INITIALIZER;
+
+// Compute the smoothed heights of one chunk column from a 34x34 raw tile
+static void heightmap_tile_build(int32_t chunk_x, int32_t chunk_z, uint64_t seed, bool reference, int heights[CHUNK_DEPTH][CHUNK_WIDTH]) {
+    float raw[CHUNK_DEPTH + 2][CHUNK_WIDTH + 2];
+    int x0 = chunk_x * CHUNK_WIDTH - 1;
+    int z0 = chunk_z * CHUNK_DEPTH - 1;
+
+    for (int z = 0; z < CHUNK_DEPTH + 2; z++) {
+        if (reference) {
+            terrain_height_row_reference(x0, z0 + z, CHUNK_WIDTH + 2, seed, raw[z]);
+        } else {
+            terrain_height_row(x0, z0 + z, CHUNK_WIDTH + 2, seed, raw[z]);
+        }
+    }
+
+    for (int z = 0; z < CHUNK_DEPTH; z++) {
+        for (int x = 0; x < CHUNK_WIDTH; x++) {
+            float samples[9];
+            int idx = 0;
+            for (int dx = -1; dx <= 1; dx++) {
+                for (int dz = -1; dz <= 1; dz++) {
+                    samples[idx] = raw[z + 1 + dz][x + 1 + dx];
+                    idx++;
+                }
+            }
+            heights[z][x] = smooth_height_samples(samples);
+        }
+    }
+}
+
+// Get the smoothed heightmap for a chunk column, building and caching it on a miss.
+// Safe to call from several workers; two racing misses just compute the tile twice.
+// Tiles of the two noise paths are kept apart so comparing them compares the noise.
+static void heightmap_cache_get(int32_t chunk_x, int32_t chunk_z, uint64_t seed, bool reference, int heights[CHUNK_DEPTH][CHUNK_WIDTH]) {
+    pthread_mutex_lock(&heightmap_cache_mutex);
+    for (int i = 0; i < HEIGHTMAP_CACHE_SIZE; i++) {
+        HeightmapTile *tile = &heightmap_cache[i];
+        if (tile->valid && tile->chunk_x == chunk_x && tile->chunk_z == chunk_z && tile->seed == seed &&
+            tile->reference == reference) {
+            tile->last_used = ++heightmap_cache_clock;
+            memcpy(heights, tile->heights, sizeof(tile->heights));
+            pthread_mutex_unlock(&heightmap_cache_mutex);
+            return;
+        }
+    }
+    pthread_mutex_unlock(&heightmap_cache_mutex);
+
+    // Miss: build without holding the lock
+    heightmap_tile_build(chunk_x, chunk_z, seed, reference, heights);
+
+    // Store over the least recently used tile
+    pthread_mutex_lock(&heightmap_cache_mutex);
+    HeightmapTile *victim = &heightmap_cache[0];
+    for (int i = 0; i < HEIGHTMAP_CACHE_SIZE; i++) {
+        HeightmapTile *tile = &heightmap_cache[i];
+        if (!tile->valid) {
+            victim = tile;
+            break;
+        }
+        if (tile->last_used < victim->last_used) {
+            victim = tile;
+        }
+    }
+    victim->chunk_x = chunk_x;
+    victim->chunk_z = chunk_z;
+    victim->seed = seed;
+    victim->reference = reference;
+    victim->valid = true;
+    victim->last_used = ++heightmap_cache_clock;
+    memcpy(victim->heights, heights, sizeof(victim->heights));
+    pthread_mutex_unlock(&heightmap_cache_mutex);
+}
+
+// ============================================================================
+// ENGINE SETTINGS
+// ============================================================================
+
+// Read worker, save and chunk read settings from options.conf (defaults if missing)
+void world_config_load(WorldConfig *config) {
+    if (!config) {
+        return;
+    }
+
+    config->worker.thread_count = 0;
+    config->worker.pin_threads = false;
+    config->save.fsync_mode = SAVE_FSYNC_BATCH;
+    config->save.autosave_interval = SAVE_QUEUE_DEFAULT_AUTOSAVE;
+    config->chunk_io.backend = CHUNK_IO_AUTO;
+    config->chunk_io.thread_count = CHUNK_IO_DEFAULT_THREADS;
+
+    FILE *file = fopen("./options.conf", "r");
+    if (!file) {
+        return;
+    }
+
+    char line[256];
+    char *key = NULL;
+    char *value = NULL;
+    while (options_read_line(file, line, sizeof(line), &key, &value)) {
+        bool enabled = strcmp(value, "true") == 0 || strcmp(value, "1") == 0;
+        if (strcmp(key, "worker_threads") == 0) {
+            int threads = atoi(value);
+            config->worker.thread_count = threads > 0 ? threads : 0;
+        } else if (strcmp(key, "worker_affinity") == 0) {
+            config->worker.pin_threads = enabled;
+        } else if (strcmp(key, "save_fsync") == 0) {
+            if (strcmp(value, "never") == 0) {
+                config->save.fsync_mode = SAVE_FSYNC_NEVER;
+            } else if (strcmp(value, "always") == 0) {
+                config->save.fsync_mode = SAVE_FSYNC_ALWAYS;
+            } else {
+                config->save.fsync_mode = SAVE_FSYNC_BATCH;
+            }
+        } else if (strcmp(key, "autosave_interval") == 0) {
+            int interval = atoi(value);
+            config->save.autosave_interval = interval > 0 ? interval : 0;
+        } else if (strcmp(key, "chunk_io") == 0) {
+            if (strcmp(value, "io_uring") == 0) {
+                config->chunk_io.backend = CHUNK_IO_URING;
+            } else if (strcmp(value, "threads") == 0) {
+                config->chunk_io.backend = CHUNK_IO_THREADS;
+            } else if (strcmp(value, "sync") == 0) {
+                config->chunk_io.backend = CHUNK_IO_SYNC;
+            } else {
+                config->chunk_io.backend = CHUNK_IO_AUTO;
+            }
+        } else if (strcmp(key, "chunk_io_threads") == 0) {
+            int threads = atoi(value);
+            config->chunk_io.thread_count = threads < 1 ? 1 : threads > CHUNK_IO_MAX_THREADS ? CHUNK_IO_MAX_THREADS : threads;
+        }
+    }
+
+    fclose(file);
+}
+
+// Write the settings world_config_load reads, one key=value line each
+void world_config_write(FILE *file, const WorldConfig *config) {
+    static const char *const fsync_names[] = {"never", "batch", "always"};
+    static const char *const chunk_io_names[] = {"auto", "io_uring", "threads", "sync"};
+    fprintf(file, "worker_threads=%d # 0 means one per core\n", config->worker.thread_count);
+    fprintf(file, "worker_affinity=%s\n", config->worker.pin_threads ? "true" : "false");
+    fprintf(file, "save_fsync=%s # never, batch or always\n", fsync_names[config->save.fsync_mode]);
+    fprintf(file, "autosave_interval=%d # seconds, 0 disables autosave\n", config->save.autosave_interval);
+    fprintf(file, "chunk_io=%s # auto, io_uring, threads or sync\n", chunk_io_names[config->chunk_io.backend]);
+    fprintf(file, "chunk_io_threads=%d\n", config->chunk_io.thread_count);
+}
+
 // Create and allocate a new infinite world with chunk system
 World *world_create(void) {
     World *world = (World *)malloc(sizeof(World));
 
-    // Preallocate large chunk cache upfront to avoid realloc during gameplay
-    // This prevents pointer invalidation when worker thread is accessing chunks
-    world->chunk_cache.chunk_capacity = 4096; // Pre-allocate space for 4096 chunks (very large)
-    world->chunk_cache.chunks = (Chunk *)malloc(sizeof(Chunk) * world->chunk_cache.chunk_capacity);
-    world->chunk_cache.chunk_count = 0;
+    // Chunks come from a slab pool that grows on demand; slabs never move, so
+    // workers can keep chunk pointers while the cache grows
+    chunk_pool_init(&world->chunk_cache);
 
     // Initialize hash table for O(1) chunk lookup (Issue #1)
-    world->chunk_cache.hash_capacity = 8192; // Hash table roughly 2x larger than max chunks to reduce collisions
-    world->chunk_cache.hash_table = (ChunkHashEntry *)malloc(sizeof(ChunkHashEntry) * world->chunk_cache.hash_capacity);
-    memset(world->chunk_cache.hash_table, 0, sizeof(ChunkHashEntry) * world->chunk_cache.hash_capacity);
+    // It starts small and doubles as chunks are added
+    chunk_hash_init(&world->chunk_cache, CHUNK_HASH_INITIAL_CAPACITY);
 
     world->last_loaded_chunk_x = INT32_MAX;
     world->last_loaded_chunk_y = INT32_MAX;
@@ -329,10 +958,15 @@ World *world_create(void) {
     // Initialize seed to a random value if not set later
     world->seed = (uint64_t)time(NULL);
     world->compress_chunk_files = true;
+    world->legacy_chunk_files = false;
 
     // Initialize worker thread system
+    WorldConfig config;
+    world_config_load(&config);
     pthread_mutex_init(&world->cache_mutex, NULL); // Initialize cache mutex before worker starts
-    worker_init(world);
+    worker_init(world, &config.worker);
+    save_queue_init(world, &config.save);
+    chunk_io_init(world, &config.chunk_io);
 
     // No player attached initially
     world->current_player = NULL;
@@ -346,25 +980,24 @@ World *world_create(void) {
 // Free world memory and all chunks
 void world_free(World *world) {
     if (world) {
-        // Shutdown worker thread first
+        // Stop chunk reads first (they queue worker jobs), then the workers, then
+        // write out chunks still queued for saving
+        chunk_io_shutdown(world);
         worker_shutdown(world);
+        save_queue_shutdown(world);
 
         // Clean up all remaining chunks
         for (int i = 0; i < world->chunk_cache.chunk_count; i++) {
-            Chunk *chunk = &world->chunk_cache.chunks[i];
-            chunk_free_visible_blocks(chunk); // Free any cached mesh data
-            // NOTE: Don't destroy mutexes - they're part of preallocated array memory
-            // They'll be reused when chunks are respawned or cleaned up
+            Chunk *chunk = world->chunk_cache.live[i];
+            chunk_free_merged_mesh(chunk); // Free any cached mesh data
+            chunk_storage_release(chunk);  // Free palette block storage
         }
 
-        // Free chunk cache array, hash table, and cache mutex
-        if (world->chunk_cache.chunks) {
-            free(world->chunk_cache.chunks);
-        }
-        if (world->chunk_cache.hash_table) {
-            free(world->chunk_cache.hash_table); // Free hash table (Issue #1)
-        }
+        // Unmap chunk slabs (destroys the per-slot mutexes), free hash table and cache mutex
+        chunk_pool_destroy(&world->chunk_cache);
+        chunk_hash_destroy(&world->chunk_cache); // Free hash table (Issue #1)
         pthread_mutex_destroy(&world->cache_mutex); // Destroy cache access mutex
+        region_close_all();                         // Workers are gone, nothing holds a region
 
         // Don't unload textures - they're shared across all worlds
         // and will be unloaded when the application closes
@@ -395,20 +1028,24 @@ static const BlockTexturePaths BLOCK_TEXTURE_PATHS[] = {
 #define BLOCK_TEXTURE_PATHS_COUNT (sizeof(BLOCK_TEXTURE_PATHS) / sizeof(BLOCK_TEXTURE_PATHS[0]))
 
 // Small path -> Texture2D cache, so a file requested by multiple faces/blocks
-// only gets loaded and uploaded once.
+// only gets loaded and uploaded once. The decoded image is kept until the
+// block atlas has been built from it.
 #define MAX_CACHED_BLOCK_TEXTURES 64
 typedef struct {
     char path[256];
     Texture2D texture;
+    Image image;                 // RGBA8 pixels, unloaded once the atlas is built
+    BlockAtlasImage atlas_image; // View of `image` handed to block_atlas_build
 } CachedBlockTexture;
 
 static CachedBlockTexture g_block_texture_cache[MAX_CACHED_BLOCK_TEXTURES];
 static int g_block_texture_cache_count = 0;
 
 #ifndef SERVER_BUILD
-static Texture2D load_block_face_texture(const char *filename) {
+// Load (or find in the cache) the texture for one face file. NULL when there is no file.
+static CachedBlockTexture *load_block_face_texture(const char *filename) {
     if (!filename) {
-        return (Texture2D){0};
+        return NULL;
     }
 
     char path[512];
@@ -416,13 +1053,16 @@ static Texture2D load_block_face_texture(const char *filename) {
 
     for (int i = 0; i < g_block_texture_cache_count; i++) {
         if (strcmp(g_block_texture_cache[i].path, path) == 0) {
-            return g_block_texture_cache[i].texture;
+            return &g_block_texture_cache[i];
         }
     }
+    if (g_block_texture_cache_count >= MAX_CACHED_BLOCK_TEXTURES) {
+        return NULL;
+    }
 
-    if (strcmp(filename, "glass_full.png") == 0) {
-        Image image = LoadImage(path);
-        ImageFormat(&image, PIXELFORMAT_UNCOMPRESSED_R8G8B8A8);
+    Image image = LoadImage(path);
+    ImageFormat(&image, PIXELFORMAT_UNCOMPRESSED_R8G8B8A8);
+    if (strcmp(filename, "glass_full.png") == 0 && image.data) {
         Color *pixels = (Color *)image.data;
         int pixel_count = image.width * image.height;
         for (int i = 0; i < pixel_count; i++) {
@@ -432,31 +1072,25 @@ static Texture2D load_block_face_texture(const char *filename) {
                 pixels[i].a = 255;
             }
         }
-        Texture2D texture = LoadTextureFromImage(image);
-        UnloadImage(image);
-        printf("[textures] loaded %s (id=%d)\n", path, texture.id);
-        if (g_block_texture_cache_count < MAX_CACHED_BLOCK_TEXTURES) {
-            strncpy(g_block_texture_cache[g_block_texture_cache_count].path, path,
-                    sizeof(g_block_texture_cache[0].path) - 1);
-            g_block_texture_cache[g_block_texture_cache_count].path[sizeof(g_block_texture_cache[0].path) - 1] = '\0';
-            g_block_texture_cache[g_block_texture_cache_count].texture = texture;
-            g_block_texture_cache_count++;
-        }
-        return texture;
     }
-
-    Texture2D texture = LoadTexture(path);
+    Texture2D texture = LoadTextureFromImage(image);
     printf("[textures] loaded %s (id=%d)\n", path, texture.id);
 
-    if (g_block_texture_cache_count < MAX_CACHED_BLOCK_TEXTURES) {
-        strncpy(g_block_texture_cache[g_block_texture_cache_count].path, path,
-                sizeof(g_block_texture_cache[0].path) - 1);
-        g_block_texture_cache[g_block_texture_cache_count].path[sizeof(g_block_texture_cache[0].path) - 1] = '\0';
-        g_block_texture_cache[g_block_texture_cache_count].texture = texture;
-        g_block_texture_cache_count++;
-    }
+    CachedBlockTexture *entry = &g_block_texture_cache[g_block_texture_cache_count++];
+    strncpy(entry->path, path, sizeof(entry->path) - 1);
+    entry->path[sizeof(entry->path) - 1] = '\0';
+    entry->texture = texture;
+    entry->image = image;
+    entry->atlas_image = (BlockAtlasImage){(const Color *)image.data, image.width, image.height};
+    return entry;
+}
+
+static Texture2D cached_block_texture(const CachedBlockTexture *entry) {
+    return entry ? entry->texture : (Texture2D){0};
+}
 
-    return texture;
+static const BlockAtlasImage *cached_block_atlas_image(const CachedBlockTexture *entry) {
+    return (entry && entry->image.data) ? &entry->atlas_image : NULL;
 }
 #endif
 
@@ -483,12 +1117,40 @@ void world_load_textures(World *world) {
 
     g_block_texture_cache_count = 0;
 
+    const BlockAtlasImage *layer_images[CHUNK_MESH_LAYER_COUNT] = {0};
     for (size_t i = 0; i < BLOCK_TEXTURE_PATHS_COUNT; i++) {
         const BlockTexturePaths *paths = &BLOCK_TEXTURE_PATHS[i];
         BlockTextureSet *set = &world->textures.sets[paths->type];
-        set->top    = load_block_face_texture(paths->top);
-        set->side   = load_block_face_texture(paths->side);
-        set->bottom = load_block_face_texture(paths->bottom);
+        CachedBlockTexture *top = load_block_face_texture(paths->top);
+        CachedBlockTexture *side = load_block_face_texture(paths->side);
+        CachedBlockTexture *bottom = load_block_face_texture(paths->bottom);
+        set->top = cached_block_texture(top);
+        set->side = cached_block_texture(side);
+        set->bottom = cached_block_texture(bottom);
+        layer_images[chunk_mesh_layer(paths->type, BLOCK_FACE_TOP)] = cached_block_atlas_image(top);
+        layer_images[chunk_mesh_layer(paths->type, BLOCK_FACE_SIDE)] = cached_block_atlas_image(side);
+        layer_images[chunk_mesh_layer(paths->type, BLOCK_FACE_BOTTOM)] = cached_block_atlas_image(bottom);
+    }
+
+    // Pack everything into one atlas so chunks draw with a single bound texture
+    world->textures.atlas_texture = (Texture2D){0};
+    if (block_atlas_build(&world->textures.atlas, layer_images)) {
+        Image atlas_image = {
+            .data = world->textures.atlas.pixels,
+            .width = world->textures.atlas.width,
+            .height = world->textures.atlas.height,
+            .mipmaps = 1,
+            .format = PIXELFORMAT_UNCOMPRESSED_R8G8B8A8};
+        world->textures.atlas_texture = LoadTextureFromImage(atlas_image);
+        block_atlas_free_pixels(&world->textures.atlas);
+        printf("[textures] built %dx%d block atlas with %d tiles (id=%d)\n", world->textures.atlas.width,
+               world->textures.atlas.height, world->textures.atlas.tile_count, world->textures.atlas_texture.id);
+    }
+
+    // The atlas holds its own copy of the pixels
+    for (int i = 0; i < g_block_texture_cache_count; i++) {
+        UnloadImage(g_block_texture_cache[i].image);
+        g_block_texture_cache[i].image = (Image){0};
     }
 
     world->textures.textures_loaded = true;
@@ -507,6 +1169,12 @@ void world_unload_textures(World *world) {
     }
     g_block_texture_cache_count = 0;
 
+    if (world->textures.atlas_texture.id > 0) {
+        UnloadTexture(world->textures.atlas_texture);
+    }
+    memset(&world->textures.atlas, 0, sizeof(world->textures.atlas));
+    world->textures.atlas_texture = (Texture2D){0};
+
     memset(world->textures.sets, 0, sizeof(world->textures.sets));
     world->textures.textures_loaded = false;
 }
@@ -542,23 +1210,13 @@ Chunk *world_get_chunk(World *world, int32_t chunk_x, int32_t chunk_y, int32_t c
     return chunk_hash_lookup(&world->chunk_cache, chunk_x, chunk_y, chunk_z);
 }
 
-// Load or create a chunk
-Chunk *world_load_or_create_chunk(World *world, int32_t chunk_x, int32_t chunk_y, int32_t chunk_z) {
-    // Try to find existing chunk
-    Chunk *existing = world_get_chunk(world, chunk_x, chunk_y, chunk_z);
-    if (existing) {
-        return existing;
-    }
-
-    // Expand chunk cache if needed
-    if (world->chunk_cache.chunk_count >= world->chunk_cache.chunk_capacity) {
-        fprintf(stderr, "[ERROR] Chunk cache overflow! count=%d, capacity=%d. Preallocated buffer was too small!\n",
-                world->chunk_cache.chunk_count, world->chunk_cache.chunk_capacity);
-        return NULL; // Fail instead of reallocating - we should have preallocated enough
+// Claim a slot from the pool and reset it to an empty, unhashed chunk at the given coordinates
+static Chunk *world_alloc_chunk(World *world, int32_t chunk_x, int32_t chunk_y, int32_t chunk_z) {
+    // Maps a new slab if every slab is full
+    Chunk *new_chunk = chunk_pool_alloc(&world->chunk_cache);
+    if (!new_chunk) {
+        return NULL;
     }
-
-    // Create new chunk
-    Chunk *new_chunk = &world->chunk_cache.chunks[world->chunk_cache.chunk_count++];
     new_chunk->chunk_x = chunk_x;
     new_chunk->chunk_y = chunk_y;
     new_chunk->chunk_z = chunk_z;
@@ -568,95 +1226,83 @@ Chunk *world_load_or_create_chunk(World *world, int32_t chunk_x, int32_t chunk_y
     new_chunk->meshed = false;
     new_chunk->pending_save = false;
     new_chunk->pending_unload = false;
+    new_chunk->pending_generate = false;
+    new_chunk->read_only = false;
     new_chunk->in_use_count = 0;
 
-    // Initialize double-buffered visible blocks cache
-    new_chunk->visible_blocks[0] = NULL;
-    new_chunk->visible_blocks[1] = NULL;
-    new_chunk->visible_count[0] = 0;
-    new_chunk->visible_count[1] = 0;
-    new_chunk->visible_capacity[0] = 0;
-    new_chunk->visible_capacity[1] = 0;
-    new_chunk->active_mesh = 0; // Start with buffer 0
-
     // Initialize merged mesh pointers for greedy meshing
     new_chunk->merged_mesh[0] = NULL;
     new_chunk->merged_mesh[1] = NULL;
     new_chunk->active_merged_mesh = 0;
+    new_chunk->mesh_version = 0;
 
-    pthread_mutex_init(&new_chunk->mesh_swap_mutex, NULL); // Mutex for atomic mesh swaps
-    pthread_mutex_init(&new_chunk->mutex, NULL);           // Initialize chunk mutex
+    // mesh_swap_mutex and mutex were initialized by the pool (when the slab was mapped or the slot reclaimed)
 
-    // Initialize blocks to air.
-    for (int y = 0; y < CHUNK_HEIGHT; y++) {
-        for (int z = 0; z < CHUNK_DEPTH; z++) {
-            for (int x = 0; x < CHUNK_WIDTH; x++) {
-                new_chunk->blocks[y][z][x].type = BLOCK_AIR;
-            }
-        }
-    }
+    // Initialize blocks to air. The slot's previous storage was released on unload.
+    chunk_storage_init(new_chunk);
+    return new_chunk;
+}
 
-    // Try to load from disk
-    char filepath[512];
-    snprintf(filepath, sizeof(filepath), "./worlds/%s/chunks/chunk_%d_%d_%d.chunk",
-             world->world_name, chunk_x, chunk_y, chunk_z);
+// Load or create a chunk
+Chunk *world_load_or_create_chunk(World *world, int32_t chunk_x, int32_t chunk_y, int32_t chunk_z) {
+    // Try to find existing chunk
+    Chunk *existing = world_get_chunk(world, chunk_x, chunk_y, chunk_z);
+    if (existing) {
+        return existing;
+    }
 
-    FILE *file = fopen(filepath, "rb");
-    if (file) {
-        bool load_success = true;
+    Chunk *new_chunk = world_alloc_chunk(world, chunk_x, chunk_y, chunk_z);
+    if (!new_chunk) {
+        return NULL;
+    }
 
-        // Detect file format and load accordingly, preserving compatibility with legacy raw format.
-        if (fseek(file, 0, SEEK_SET) != 0) {
-            load_success = false;
-        } else {
-            uint8_t magic[4];
-            if (fread(magic, 1, sizeof(magic), file) == sizeof(magic) &&
-                memcmp(magic, "B3DV", sizeof(magic)) == 0) {
-                // Rewind to position 0 before passing to load_chunk_from_file (it expects to read from the start)
-                if (fseek(file, 0, SEEK_SET) != 0) {
-                    load_success = false;
-                } else if (!load_chunk_from_file(file, new_chunk)) {
-                    // Provide diagnostic from loader for why parsing failed
-                    printf("[chunk_load] Failed to parse chunk file: %s (%s)\n", filepath, CHUNK_LOAD_ERROR);
-                    load_success = false;
-                }
-            } else {
-                // Legacy raw format: rewind and read BlockType values directly.
-                if (fseek(file, 0, SEEK_SET) != 0) {
-                    load_success = false;
-                } else {
-                    for (int y = 0; y < CHUNK_HEIGHT && load_success; y++) {
-                        for (int z = 0; z < CHUNK_DEPTH && load_success; z++) {
-                            for (int x = 0; x < CHUNK_WIDTH; x++) {
-                                BlockType block_type;
-                                if (fread(&block_type, sizeof(BlockType), 1, file) == 1) {
-                                    new_chunk->blocks[y][z][x].type = block_type;
-                                } else {
-                                    load_success = false;
-                                    break;
-                                }
-                            }
-                        }
-                    }
-                }
+    // Try to load from disk: the chunk's region file, or a per-chunk file that could not be migrated
+    char source[512];
+    snprintf(source, sizeof(source), "region of chunk %d,%d,%d", chunk_x, chunk_y, chunk_z);
+    RegionChunkView view;
+    uint8_t *legacy_record = NULL;
+    const uint8_t *record = NULL;
+    size_t record_size = 0;
+    bool found = region_map_chunk(world->world_name, chunk_x, chunk_y, chunk_z, &view);
+    if (found) {
+        record = view.data;
+        record_size = view.size;
+    } else if (world->legacy_chunk_files) {
+        snprintf(source, sizeof(source), "./worlds/%s/chunks/chunk_%d_%d_%d.chunk",
+                 world->world_name, chunk_x, chunk_y, chunk_z);
+        FILE *file = fopen(source, "rb");
+        if (file) {
+            long size = -1;
+            if (fseek(file, 0, SEEK_END) == 0) {
+                size = ftell(file);
+            }
+            if (size > 0 && fseek(file, 0, SEEK_SET) == 0 && (legacy_record = (uint8_t *)malloc((size_t)size))) {
+                record = legacy_record;
+                record_size = fread(legacy_record, 1, (size_t)size, file);
             }
+            fclose(file);
+            found = true;
         }
+    }
 
-        fclose(file);
-        if (load_success) {
+    if (found) {
+        if (record && load_chunk_from_buffer(record, record_size, new_chunk)) {
             new_chunk->loaded = true;
             new_chunk->generated = true; // Loaded chunks are already complete
             new_chunk->modified = false; // Not modified when loaded from disk
-            printf("[chunk_load] Loaded chunk from %s\n", filepath);
+            printf("[chunk_load] Loaded chunk from %s\n", source);
             // Queue for meshing
             worker_queue_chunk(world, new_chunk);
         } else {
-            printf("[chunk_load] Failed to parse chunk file: %s\n", filepath);
+            // Provide diagnostic from loader for why parsing failed
+            printf("[chunk_load] Failed to parse chunk: %s (%s)\n", source, CHUNK_LOAD_ERROR);
         }
+        region_unmap_chunk(&view);
+        free(legacy_record);
     } else {
         // Chunk doesn't exist on disk - don't auto-generate, return empty chunk
         // The caller (world_load) will handle generation if needed
-        printf("[chunk_load] Chunk not found: %s (will stay as air)\n", filepath);
+        printf("[chunk_load] Chunk not found: %d,%d,%d (will stay as air)\n", chunk_x, chunk_y, chunk_z);
     }
 
     // Add chunk to hash table for O(1) lookup (Issue #1)
@@ -671,20 +1317,70 @@ void world_generate_chunk(Chunk *chunk, uint64_t seed) {
         return;
     }
 
+    Block(*blocks)[CHUNK_DEPTH][CHUNK_WIDTH] = malloc(sizeof(Block) * CHUNK_HEIGHT * CHUNK_DEPTH * CHUNK_WIDTH);
+    if (!blocks) {
+        return;
+    }
+
+    world_generate_chunk_blocks(blocks, chunk->chunk_x, chunk->chunk_y, chunk->chunk_z, seed);
+    chunk_storage_fill(chunk, blocks);
+    free(blocks);
+    chunk->generated = true;
+}
+
+// Terrain of one chunk, from the batch noise kernels or the per-sample reference path
+static void generate_chunk_blocks(Block (*blocks)[CHUNK_DEPTH][CHUNK_WIDTH], int32_t chunk_x, int32_t chunk_y, int32_t chunk_z, uint64_t seed, bool reference) {
+    // Cave bands: big caves from y=15 to y=40, smaller ones from y=40 to y=85
+    static const float big_cave_scales[3] = {0.03f, 0.1f, 0.25f};    // Chambers, corridors, tunnels
+    static const float small_cave_scales[3] = {0.05f, 0.15f, 0.35f}; // Smaller chambers, corridors, fine tunnels
+    const float big_cave_threshold = 0.42f;                           // Lower threshold for bigger, more connected caves
+    const float small_cave_threshold = 0.45f;                         // Higher threshold for smaller, more fragmented caves
+
+    int chunk_base_y = chunk_y * CHUNK_HEIGHT;
+
+    // Get heights using improved noise function with smoothing, shared by every chunk in this column
+    // Use world seed directly to maintain terrain continuity across chunks
+    int terrain_heights[CHUNK_DEPTH][CHUNK_WIDTH];
+    heightmap_cache_get(chunk_x, chunk_z, seed, reference, terrain_heights);
+
     // Generate terrain with improved noise and features
     for (int x = 0; x < CHUNK_WIDTH; x++) {
         for (int z = 0; z < CHUNK_DEPTH; z++) {
             // Calculate world position
-            int world_x = chunk->chunk_x * CHUNK_WIDTH + x;
-            int world_z = chunk->chunk_z * CHUNK_DEPTH + z;
-
-            // Get height at this position using improved noise function with smoothing
-            // Use world seed directly to maintain terrain continuity across chunks
-            int terrain_height_blocks = smooth_terrain_height(world_x, world_z, seed);
+            int world_x = chunk_x * CHUNK_WIDTH + x;
+            int world_z = chunk_z * CHUNK_DEPTH + z;
+            int terrain_height_blocks = terrain_heights[z][x];
+
+            // Underground cave systems - use 3D noise for connected caverns
+            // Tiered cave generation for natural progression; only blocks below the surface are tested
+            bool is_cave[CHUNK_HEIGHT] = {false};
+            int cave_top = terrain_height_blocks < chunk_base_y + CHUNK_HEIGHT ? terrain_height_blocks : chunk_base_y + CHUNK_HEIGHT;
+            int big_start = chunk_base_y > 15 ? chunk_base_y : 15;
+            int big_end = cave_top < 40 ? cave_top : 40;
+            if (big_end > big_start) {
+                if (reference) {
+                    cave_band_column_reference(world_x, world_z, big_start, big_end - big_start, big_cave_scales,
+                                               seed + 5000, big_cave_threshold, &is_cave[big_start - chunk_base_y]);
+                } else {
+                    cave_band_column(world_x, world_z, big_start, big_end - big_start, big_cave_scales, seed + 5000,
+                                     big_cave_threshold, &is_cave[big_start - chunk_base_y]);
+                }
+            }
+            int small_start = chunk_base_y > 40 ? chunk_base_y : 40;
+            int small_end = cave_top < 85 ? cave_top : 85;
+            if (small_end > small_start) {
+                if (reference) {
+                    cave_band_column_reference(world_x, world_z, small_start, small_end - small_start, small_cave_scales,
+                                               seed + 5010, small_cave_threshold, &is_cave[small_start - chunk_base_y]);
+                } else {
+                    cave_band_column(world_x, world_z, small_start, small_end - small_start, small_cave_scales, seed + 5010,
+                                     small_cave_threshold, &is_cave[small_start - chunk_base_y]);
+                }
+            }
 
             // Generate vertical column
             for (int y = 0; y < CHUNK_HEIGHT; y++) {
-                int world_y = chunk->chunk_y * CHUNK_HEIGHT + y;
+                int world_y = chunk_base_y + y;
                 BlockType block_type = BLOCK_AIR;
 
                 // Bedrock layer at y=0
@@ -697,78 +1393,7 @@ void world_generate_chunk(Chunk *chunk, uint64_t seed) {
                 }
                 // Fill blocks below terrain height
                 else if (world_y < terrain_height_blocks) {
-                    // Underground cave systems - use 3D noise for connected caverns
-                    // Tiered cave generation for natural progression
-                    bool is_cave = false;
-
-                    // Big caves from y=15 to y=40
-                    if (world_y >= 15 && world_y < 40) {
-                        float cave_val = 0.0f;
-                        float cave_amp = 1.0f;
-
-                        // Layer 1: Large cave chambers
-                        cave_val += cave_amp * cave_noise_3d(
-                                                   (float)world_x * 0.03f,
-                                                   (float)world_y * 0.03f,
-                                                   (float)world_z * 0.03f,
-                                                   seed + 5000);
-                        cave_amp *= 0.7f;
-
-                        // Layer 2: Medium cave corridors
-                        cave_val += cave_amp * cave_noise_3d(
-                                                   (float)world_x * 0.1f,
-                                                   (float)world_y * 0.1f,
-                                                   (float)world_z * 0.1f,
-                                                   seed + 5001);
-                        cave_amp *= 0.6f;
-
-                        // Layer 3: Small cave tunnels
-                        cave_val += cave_amp * cave_noise_3d(
-                                                   (float)world_x * 0.25f,
-                                                   (float)world_y * 0.25f,
-                                                   (float)world_z * 0.25f,
-                                                   seed + 5002);
-
-                        cave_val /= 2.3f;
-
-                        // Lower threshold for bigger, more connected caves
-                        is_cave = cave_val < 0.42f;
-                    }
-                    // Smaller caves from y=40 to y=85
-                    else if (world_y >= 40 && world_y < 85) {
-                        float cave_val = 0.0f;
-                        float cave_amp = 1.0f;
-
-                        // Layer 1: Smaller chambers
-                        cave_val += cave_amp * cave_noise_3d(
-                                                   (float)world_x * 0.05f,
-                                                   (float)world_y * 0.05f,
-                                                   (float)world_z * 0.05f,
-                                                   seed + 5010);
-                        cave_amp *= 0.7f;
-
-                        // Layer 2: Smaller corridors
-                        cave_val += cave_amp * cave_noise_3d(
-                                                   (float)world_x * 0.15f,
-                                                   (float)world_y * 0.15f,
-                                                   (float)world_z * 0.15f,
-                                                   seed + 5011);
-                        cave_amp *= 0.6f;
-
-                        // Layer 3: Fine tunnels
-                        cave_val += cave_amp * cave_noise_3d(
-                                                   (float)world_x * 0.35f,
-                                                   (float)world_y * 0.35f,
-                                                   (float)world_z * 0.35f,
-                                                   seed + 5012);
-
-                        cave_val /= 2.3f;
-
-                        // Higher threshold for smaller, more fragmented caves
-                        is_cave = cave_val < 0.45f;
-                    }
-
-                    if (is_cave) {
+                    if (is_cave[y]) {
                         block_type = BLOCK_AIR;
                     }
                     // Top surface block is grass
@@ -791,16 +1416,27 @@ void world_generate_chunk(Chunk *chunk, uint64_t seed) {
                     block_type = BLOCK_AIR;
                 }
 
-                chunk->blocks[y][z][x].type = block_type;
+                blocks[y][z][x].type = block_type;
             }
         }
     }
+}
 
-    chunk->generated = true;
+// Generate the terrain of one chunk into a block buffer. Touches no chunk or
+// world state, so workers can run it on a detached buffer.
+void world_generate_chunk_blocks(Block (*blocks)[CHUNK_DEPTH][CHUNK_WIDTH], int32_t chunk_x, int32_t chunk_y, int32_t chunk_z, uint64_t seed) {
+    generate_chunk_blocks(blocks, chunk_x, chunk_y, chunk_z, seed, false);
+}
+
+// Same blocks as world_generate_chunk_blocks, from the per-sample noise functions
+void world_generate_chunk_blocks_reference(Block (*blocks)[CHUNK_DEPTH][CHUNK_WIDTH], int32_t chunk_x, int32_t chunk_y, int32_t chunk_z, uint64_t seed) {
+    generate_chunk_blocks(blocks, chunk_x, chunk_y, chunk_z, seed, true);
 }
 
-// Set block at world position
-void world_set_block(World *world, int x, int y, int z, BlockType type) {
+// Set block at world position. Refused (returns false) while the chunk's terrain is
+// not in yet: generation or a read would publish over the edit and lose it. Also
+// refused in a read-only chunk, whose edits could never be saved.
+bool world_set_block(World *world, int x, int y, int z, BlockType type) {
     // Calculate chunk coordinates
     int32_t chunk_x = x < 0 ? (x - CHUNK_WIDTH + 1) / CHUNK_WIDTH : x / CHUNK_WIDTH;
     int32_t chunk_y = y < 0 ? (y - CHUNK_HEIGHT + 1) / CHUNK_HEIGHT : y / CHUNK_HEIGHT;
@@ -819,8 +1455,19 @@ void world_set_block(World *world, int x, int y, int z, BlockType type) {
     if (chunk) {
         // Lock chunk while modifying blocks and invalidating cache
         pthread_mutex_lock(&chunk->mutex);
+        if (!chunk->generated || chunk->pending_generate || chunk->read_only) {
+            pthread_mutex_unlock(&chunk->mutex);
+            pthread_mutex_unlock(&world->cache_mutex);
+            return false;
+        }
 
+        BlockType previous = world_chunk_get_block(chunk, local_x, local_y, local_z);
         world_chunk_set_block(chunk, local_x, local_y, local_z, type);
+        // Only a change between see-through and opaque can reconnect or cut off faces, so
+        // other edits keep the chunk's visibility graph and skip the flood fill on remesh
+        if (block_is_transparent(previous) != block_is_transparent(type)) {
+            __atomic_store_n(&chunk->visibility_dirty, true, __ATOMIC_RELEASE);
+        }
 
         // Always mark meshed=false so worker will rebuild the mesh.
         // (we're doing it immediately below)
@@ -829,15 +1476,14 @@ void world_set_block(World *world, int x, int y, int z, BlockType type) {
         pthread_mutex_unlock(&chunk->mutex);
         pthread_mutex_unlock(&world->cache_mutex);
 
-        // INSTANT MESH UPDATE: Rebuild visible blocks immediately on main thread
+        // INSTANT MESH UPDATE: Rebuild the mesh immediately on main thread
         // This gives instant visual feedback for block changes without waiting for worker
-        // The visible block list doesn't depend on lighting (lighting calculated at render time)
-        // chunk_cache_visible_blocks calls world_get_block which locks world->cache_mutex,
-        // so we call it WITHOUT holding any locks
+        // chunk_build_mesh snapshots neighbour borders through the cache, so we call it
+        // WITHOUT holding any locks
 
-        // Issue #2: Use dirty-region remeshing instead of full chunk rebuild
-        // Only update a 3x3x3 region around the changed block, much faster for single block changes
-        chunk_update_visible_blocks_region(chunk, world, local_x, local_y, local_z, 1);
+        // Full rebuild: the merged quads can span the whole chunk, so they cannot be
+        // patched locally. Meshing works on a padded snapshot and takes well under 1 ms.
+        chunk_build_mesh(chunk, world);
 
         // Update mesh flag to mark it as done (worker will skip mesh rebuild and only do lighting)
         pthread_mutex_lock(&chunk->mutex);
@@ -870,32 +1516,12 @@ void world_set_block(World *world, int x, int y, int z, BlockType type) {
                 continue;
             }
 
-            // Calculate the corresponding position in the neighbor chunk (Issue #2)
-            int neighbor_local_x = local_x;
-            int neighbor_local_y = local_y;
-            int neighbor_local_z = local_z;
-
-            if (ni == 0) {
-                neighbor_local_x = 0; // Block is at far-X edge of this chunk, at near-X of neighbor
-            } else if (ni == 1) {
-                neighbor_local_x = CHUNK_WIDTH - 1; // Block is at near-X edge, at far-X of neighbor
-            } else if (ni == 2) {
-                neighbor_local_y = 0;
-            } else if (ni == 3) {
-                neighbor_local_y = CHUNK_HEIGHT - 1;
-            } else if (ni == 4) {
-                neighbor_local_z = 0;
-            } else if (ni == 5) {
-                neighbor_local_z = CHUNK_DEPTH - 1;
-            }
-
             // Invalidate neighbor mesh and rebuild it immediately to prevent flicker
             pthread_mutex_lock(&neighbor->mutex);
             neighbor->meshed = false;
             pthread_mutex_unlock(&neighbor->mutex);
 
-            // Issue #2: Use dirty-region remeshing for neighbor too
-            chunk_update_visible_blocks_region(neighbor, world, neighbor_local_x, neighbor_local_y, neighbor_local_z, 1);
+            chunk_build_mesh(neighbor, world);
 
             pthread_mutex_lock(&neighbor->mutex);
             neighbor->meshed = true;
@@ -903,9 +1529,10 @@ void world_set_block(World *world, int x, int y, int z, BlockType type) {
 
             worker_queue_chunk(world, neighbor);
         }
-    } else {
-        pthread_mutex_unlock(&world->cache_mutex);
+        return true;
     }
+    pthread_mutex_unlock(&world->cache_mutex);
+    return false;
 }
 
 // Get block at world position
@@ -920,20 +1547,19 @@ BlockType world_get_block(World *world, int x, int y, int z) {
     int local_y = y - (chunk_y * CHUNK_HEIGHT);
     int local_z = z - (chunk_z * CHUNK_DEPTH);
 
-    // CRITICAL: Lock cache before accessing chunk to prevent concurrent unloading
-    pthread_mutex_lock(&world->cache_mutex);
-    Chunk *chunk = world_get_chunk(world, chunk_x, chunk_y, chunk_z);
-    if (!chunk) {
-        pthread_mutex_unlock(&world->cache_mutex);
-        return BLOCK_AIR; // Unloaded chunks are treated as air
+    // No cache_mutex: the read section keeps an unloaded chunk's storage alive until we're done
+    int reader = chunk_read_begin(&world->chunk_cache);
+    Chunk *chunk = chunk_hash_lookup_concurrent(&world->chunk_cache, chunk_x, chunk_y, chunk_z);
+    BlockType result = BLOCK_AIR; // Unloaded chunks are treated as air
+    if (chunk) {
+        result = world_chunk_get_block(chunk, local_x, local_y, local_z);
     }
-
-    BlockType result = world_chunk_get_block(chunk, local_x, local_y, local_z);
-    pthread_mutex_unlock(&world->cache_mutex);
+    chunk_read_end(&world->chunk_cache, reader);
     return result;
 }
 
-// Get block, treating unloaded chunks as air.
+// Get block for collision: chunks that are absent or still pending generation/load read
+// as stone, so the player stands on terrain that hasn't arrived instead of falling through.
 BlockType world_get_block_or_solid(World *world, int x, int y, int z) {
     // Calculate chunk coordinates
     int32_t chunk_x = x < 0 ? (x - CHUNK_WIDTH + 1) / CHUNK_WIDTH : x / CHUNK_WIDTH;
@@ -945,37 +1571,106 @@ BlockType world_get_block_or_solid(World *world, int x, int y, int z) {
     int local_y = y - (chunk_y * CHUNK_HEIGHT);
     int local_z = z - (chunk_z * CHUNK_DEPTH);
 
-    // Lock cache before accessing chunk
-    pthread_mutex_lock(&world->cache_mutex);
-    Chunk *chunk = world_get_chunk(world, chunk_x, chunk_y, chunk_z);
-    if (!chunk || !chunk->loaded) {
-        pthread_mutex_unlock(&world->cache_mutex);
-        return BLOCK_AIR; // Unloaded chunks behave like empty air for sunlight.
+    // Lock-free lookup, as in world_get_block
+    int reader = chunk_read_begin(&world->chunk_cache);
+    Chunk *chunk = chunk_hash_lookup_concurrent(&world->chunk_cache, chunk_x, chunk_y, chunk_z);
+    BlockType result = BLOCK_STONE;
+    // generated is published last (release), so once it reads true the blocks are in
+    if (chunk && __atomic_load_n(&chunk->generated, __ATOMIC_ACQUIRE) && __atomic_load_n(&chunk->loaded, __ATOMIC_RELAXED)) {
+        result = world_chunk_get_block(chunk, local_x, local_y, local_z);
     }
-
-    BlockType result = world_chunk_get_block(chunk, local_x, local_y, local_z);
-    pthread_mutex_unlock(&world->cache_mutex);
+    chunk_read_end(&world->chunk_cache, reader);
     return result;
 }
 
-// Set block within a chunk
-void world_chunk_set_block(Chunk *chunk, int x, int y, int z, BlockType type) {
-    if (x >= 0 && x < CHUNK_WIDTH &&
-        y >= 0 && y < CHUNK_HEIGHT &&
-        z >= 0 && z < CHUNK_DEPTH) {
-        chunk->blocks[y][z][x].type = type;
-        chunk->modified = true; // Mark chunk as modified when block changes
-    }
-}
+// Walk a ray voxel by voxel (Amanatides & Woo): each block the ray passes through is
+// visited exactly once, in order, so thin walls and block corners can't be skipped the way
+// fixed-size steps skip them. The face crossed into each block comes for free. Stops at the
+// first non-air block entered before max_distance; unloaded chunks count as air. The whole
+// walk is one read section and the chunk is only looked up again when the ray leaves it.
+bool world_raycast(World *world, Vector3 origin, Vector3 direction, float max_distance, WorldRayHit *hit) {
+    float pos[3] = {origin.x, origin.y, origin.z};
+    float dir[3] = {direction.x, direction.y, direction.z};
+    int cell[3];
+    int step[3];
+    float t_max[3];   // Ray distance at which the next boundary on each axis is crossed
+    float t_delta[3]; // Ray distance between two boundaries on each axis
+    for (int axis = 0; axis < 3; axis++) {
+        cell[axis] = (int)floorf(pos[axis]);
+        if (dir[axis] > 0.0f) {
+            step[axis] = 1;
+            t_delta[axis] = 1.0f / dir[axis];
+            t_max[axis] = ((float)cell[axis] + 1.0f - pos[axis]) * t_delta[axis];
+        } else if (dir[axis] < 0.0f) {
+            step[axis] = -1;
+            t_delta[axis] = -1.0f / dir[axis];
+            t_max[axis] = (pos[axis] - (float)cell[axis]) * t_delta[axis];
+        } else {
+            step[axis] = 0;
+            t_delta[axis] = INFINITY;
+            t_max[axis] = INFINITY;
+        }
+    }
+
+    int reader = chunk_read_begin(&world->chunk_cache);
+    Chunk *chunk = NULL;
+    int32_t chunk_coords[3] = {0, 0, 0};
+    bool chunk_valid = false;
+    int entered_axis = -1; // Axis crossed into the current block, -1 for the starting block
+    float t = 0.0f;
+    bool found = false;
+    while (true) {
+        int32_t chunk_x = cell[0] < 0 ? (cell[0] - CHUNK_WIDTH + 1) / CHUNK_WIDTH : cell[0] / CHUNK_WIDTH;
+        int32_t chunk_y = cell[1] < 0 ? (cell[1] - CHUNK_HEIGHT + 1) / CHUNK_HEIGHT : cell[1] / CHUNK_HEIGHT;
+        int32_t chunk_z = cell[2] < 0 ? (cell[2] - CHUNK_DEPTH + 1) / CHUNK_DEPTH : cell[2] / CHUNK_DEPTH;
+        if (!chunk_valid || chunk_x != chunk_coords[0] || chunk_y != chunk_coords[1] || chunk_z != chunk_coords[2]) {
+            chunk = chunk_hash_lookup_concurrent(&world->chunk_cache, chunk_x, chunk_y, chunk_z);
+            chunk_coords[0] = chunk_x;
+            chunk_coords[1] = chunk_y;
+            chunk_coords[2] = chunk_z;
+            chunk_valid = true;
+        }
+
+        BlockType type = BLOCK_AIR;
+        if (chunk) {
+            type = world_chunk_get_block(chunk, cell[0] - chunk_x * CHUNK_WIDTH, cell[1] - chunk_y * CHUNK_HEIGHT,
+                                         cell[2] - chunk_z * CHUNK_DEPTH);
+        }
+        if (type != BLOCK_AIR) {
+            hit->x = cell[0];
+            hit->y = cell[1];
+            hit->z = cell[2];
+            int normal[3] = {0, 0, 0};
+            if (entered_axis >= 0) {
+                normal[entered_axis] = -step[entered_axis];
+            }
+            hit->normal_x = normal[0];
+            hit->normal_y = normal[1];
+            hit->normal_z = normal[2];
+            hit->distance = t;
+            hit->type = type;
+            found = true;
+            break;
+        }
 
-// Get block within a chunk
-BlockType world_chunk_get_block(Chunk *chunk, int x, int y, int z) {
-    if (x >= 0 && x < CHUNK_WIDTH &&
-        y >= 0 && y < CHUNK_HEIGHT &&
-        z >= 0 && z < CHUNK_DEPTH) {
-        return chunk->blocks[y][z][x].type;
+        // Cross the nearest boundary into the next block
+        int axis = 0;
+        if (t_max[1] < t_max[axis]) {
+            axis = 1;
+        }
+        if (t_max[2] < t_max[axis]) {
+            axis = 2;
+        }
+        t = t_max[axis];
+        if (!(t < max_distance)) {
+            break; // Also ends a zero-length direction, whose t_max are all infinite
+        }
+        cell[axis] += step[axis];
+        t_max[axis] += t_delta[axis];
+        entered_axis = axis;
     }
-    return BLOCK_AIR;
+    chunk_read_end(&world->chunk_cache, reader);
+    return found;
 }
 
 // Get color for block type
@@ -1024,6 +1719,14 @@ void world_update_chunks(World *world, Vector3 player_pos, Vector3 camera_forwar
         return;
     }
 
+    // Release chunks unloaded earlier once lock-free readers can no longer see them
+    pthread_mutex_lock(&world->cache_mutex);
+    chunk_pool_reclaim(&world->chunk_cache);
+    pthread_mutex_unlock(&world->cache_mutex);
+
+    // Hand modified chunks to the save thread when an autosave is due (only queues them)
+    save_queue_autosave(world);
+
     // Calculate player's chunk coordinates
     int32_t player_chunk_x = (int32_t)floorf(player_pos.x / CHUNK_WIDTH);
     int32_t player_chunk_y = (int32_t)floorf(player_pos.y / CHUNK_HEIGHT);
@@ -1057,6 +1760,23 @@ void world_update_chunks(World *world, Vector3 player_pos, Vector3 camera_forwar
     world->last_chunk_update_position = player_pos;
     world->last_chunk_update_forward = camera_forward;
 
+    struct ChunkQueueEntry {
+        int32_t x;
+        int32_t y;
+        int32_t z;
+    };
+
+    // Chunks that need terrain; generation runs on the workers, not here
+    struct ChunkQueueEntry *pending_generate = NULL;
+    int pending_generate_count = 0;
+    int pending_generate_capacity = 0;
+
+    // Chunks not in memory yet, for the read engine when there is one (see chunk_io.c)
+    struct ChunkQueueEntry *pending_read = NULL;
+    int pending_read_count = 0;
+    int pending_read_capacity = 0;
+    bool read_async = world->chunk_io.running && !world->legacy_chunk_files;
+
     // CRITICAL: Lock cache mutex while loading/creating chunks to prevent races with unload
     pthread_mutex_lock(&world->cache_mutex);
 
@@ -1099,12 +1819,55 @@ void world_update_chunks(World *world, Vector3 player_pos, Vector3 camera_forwar
                     }
                 }
 
-                Chunk *chunk = world_load_or_create_chunk(world, cx, cy, cz);
+                Chunk *chunk = world_get_chunk(world, cx, cy, cz);
+                if (!chunk && read_async) {
+                    // Read it off the main thread. Like a chunk being generated it stays
+                    // pending (hidden) until the engine publishes it, or until a worker
+                    // generates it if it turns out not to be stored.
+                    if (pending_read_count >= pending_read_capacity) {
+                        int new_cap = pending_read_capacity == 0 ? 64 : pending_read_capacity * 2;
+                        struct ChunkQueueEntry *new_ptr = (struct ChunkQueueEntry *)realloc(pending_read, sizeof(struct ChunkQueueEntry) * new_cap);
+                        if (!new_ptr) {
+                            continue;
+                        }
+                        pending_read = new_ptr;
+                        pending_read_capacity = new_cap;
+                    }
+                    chunk = world_alloc_chunk(world, cx, cy, cz);
+                    if (chunk) {
+                        chunk->pending_generate = true;
+                        chunk_hash_insert(&world->chunk_cache, cx, cy, cz, chunk);
+                        pending_read[pending_read_count].x = cx;
+                        pending_read[pending_read_count].y = cy;
+                        pending_read[pending_read_count].z = cz;
+                        pending_read_count++;
+                    }
+                    continue;
+                }
+                if (!chunk) {
+                    chunk = world_load_or_create_chunk(world, cx, cy, cz);
+                }
                 if (chunk && !chunk->loaded) {
                     if (!chunk->generated) {
-                        // Generate this chunk procedurally
-                        world_generate_chunk(chunk, world->seed);
-                        chunk->generated = true;
+                        // Hand generation to a worker; the chunk stays pending (hidden)
+                        // until the worker publishes the finished terrain
+                        if (!chunk->pending_generate) {
+                            if (pending_generate_count >= pending_generate_capacity) {
+                                int new_cap = pending_generate_capacity == 0 ? 64 : pending_generate_capacity * 2;
+                                struct ChunkQueueEntry *new_ptr = (struct ChunkQueueEntry *)realloc(pending_generate, sizeof(struct ChunkQueueEntry) * new_cap);
+                                if (!new_ptr) {
+                                    continue;
+                                }
+                                pending_generate = new_ptr;
+                                pending_generate_capacity = new_cap;
+                            }
+                            chunk->pending_generate = true;
+                            pending_generate[pending_generate_count].x = cx;
+                            pending_generate[pending_generate_count].y = cy;
+                            pending_generate[pending_generate_count].z = cz;
+                            pending_generate_count++;
+                        }
+                        continue;
                     }
                     // Mark as loaded again (this chunk was previously unloaded)
                     chunk->loaded = true;
@@ -1119,13 +1882,26 @@ void world_update_chunks(World *world, Vector3 player_pos, Vector3 camera_forwar
 
     pthread_mutex_unlock(&world->cache_mutex);
 
-    // Queue newly generated chunks for lighting/meshing after releasing cache_mutex.
+    // Queue generation jobs after releasing cache_mutex (see below)
+    for (int i = 0; i < pending_generate_count; i++) {
+        Chunk *chunk = world_get_chunk(world, pending_generate[i].x, pending_generate[i].y, pending_generate[i].z);
+        if (chunk && chunk->pending_generate) {
+            worker_queue_chunk_generate(world, chunk);
+        }
+    }
+    free(pending_generate);
+
+    // Hand new chunks to the read engine, which reads whatever has queued up as one batch
+    for (int i = 0; i < pending_read_count; i++) {
+        Chunk *chunk = world_get_chunk(world, pending_read[i].x, pending_read[i].y, pending_read[i].z);
+        if (chunk && chunk->pending_generate) {
+            chunk_io_request(world, chunk);
+        }
+    }
+    free(pending_read);
+
+    // Queue newly loaded chunks for lighting/meshing after releasing cache_mutex.
     // IMPORTANT: queueing jobs while cache_mutex is held can deadlock with the worker thread.
-    struct ChunkQueueEntry {
-        int32_t x;
-        int32_t y;
-        int32_t z;
-    };
     struct ChunkQueueEntry *pending_mesh = NULL;
     int pending_mesh_count = 0;
     int pending_mesh_capacity = 0;
@@ -1244,7 +2020,7 @@ void world_update_chunks(World *world, Vector3 player_pos, Vector3 camera_forwar
     // Unload chunks that are too far away or behind the player
     int unload_dist = load_dist + 1;
     int i = 0;
-    Chunk *chunk_to_save = NULL;
+    ChunkHandle chunk_to_save = {0, 0};
 
     // Throttle unloads to avoid stuttering when crossing chunk boundaries.
     // We only unload a small number of chunks per frame, spreading work across frames.
@@ -1257,7 +2033,7 @@ void world_update_chunks(World *world, Vector3 player_pos, Vector3 camera_forwar
             break;
         }
 
-        Chunk *chunk = &world->chunk_cache.chunks[i];
+        Chunk *chunk = world->chunk_cache.live[i];
         int dx = chunk->chunk_x - player_chunk_x;
         int dy = chunk->chunk_y - player_chunk_y;
         int dz = chunk->chunk_z - player_chunk_z;
@@ -1284,21 +2060,10 @@ void world_update_chunks(World *world, Vector3 player_pos, Vector3 camera_forwar
                 i++;
                 continue;
             }
-            // also make sure the chunk we're about to swap INTO this slot
-            // isn't being concurrently processed by the worker thread. Copying
-            // its struct (pointers + mutexes) while it's mid-update is what
-            // causes the aliased-pointer double-free.
-            if (i < world->chunk_cache.chunk_count - 1) {
-                Chunk *last_chunk = &world->chunk_cache.chunks[world->chunk_cache.chunk_count - 1];
-                if (__atomic_load_n(&last_chunk->in_use_count, __ATOMIC_ACQUIRE) > 0) {
-                    // Can't safely swap right now — try this slot again on a later update
-                    i++;
-                    continue;
-                }
-            }
             // Invalidate neighbor meshes before unloading this chunk.
             // Neighbors may now need to update faces that were previously against this chunk.
-            {
+            // Chunks held back for a save (pending_unload) did this when the save was queued.
+            if (!chunk->pending_unload) {
                 const int neighbor_offsets[6][3] = {
                     {1, 0, 0}, {-1, 0, 0}, {0, 1, 0}, {0, -1, 0}, {0, 0, 1}, {0, 0, -1}};
                 for (int ni = 0; ni < 6; ni++) {
@@ -1325,37 +2090,32 @@ void world_update_chunks(World *world, Vector3 player_pos, Vector3 camera_forwar
                 }
             }
 
-            // If modified, queue async save and mark for unload after save completes.
+            // If modified, queue it for the save thread and mark for unload after the save completes.
             // This prevents main-thread stalls due to disk I/O during unloading.
             if (chunk->modified && !chunk->pending_save) {
                 chunk->pending_unload = true;
                 // We can mark the chunk as unloaded for rendering purposes while we save it.
                 // This keeps it in memory until save completes, but removes it from active rendering.
                 chunk->loaded = false;
-                chunk_to_save = chunk;
+                chunk_to_save = chunk_pool_handle(chunk);
+                i++;
+                continue; // Unloaded on a later update, once the save has finished
             }
 
             // If chunk is not pending save, we can unload it immediately
             if (!chunk->pending_save) {
                 // Clean up chunk resources
-                chunk_free_visible_blocks(chunk); // Free mesh
+                chunk_free_merged_mesh(chunk); // Free mesh (only the renderer and workers read it)
 
                 // Remove chunk from hash table (Issue #1)
                 chunk_hash_remove(&world->chunk_cache, chunk->chunk_x, chunk->chunk_y, chunk->chunk_z);
 
-                // Remove chunk from cache (swap with last)
-                if (i < world->chunk_cache.chunk_count - 1) {
-                    Chunk *last_chunk = &world->chunk_cache.chunks[world->chunk_cache.chunk_count - 1];
-                    // Need to update hash table entry for the swapped chunk (Issue #1)
-                    chunk_hash_remove(&world->chunk_cache, last_chunk->chunk_x, last_chunk->chunk_y, last_chunk->chunk_z);
-                    world->chunk_cache.chunks[i] = *last_chunk;
-                    chunk_hash_insert(&world->chunk_cache, last_chunk->chunk_x, last_chunk->chunk_y, last_chunk->chunk_z, &world->chunk_cache.chunks[i]);
-                }
-                world->chunk_cache.chunk_count--;
+                // Lock-free world_get_block callers may still be reading its blocks, so
+                // storage and slot are released later by chunk_pool_reclaim. Only the
+                // live list entry moves; the last chunk now sits at index i and is
+                // checked next update.
+                chunk_pool_retire(&world->chunk_cache, chunk);
                 unloads_this_frame++;
-                // Advance to the next slot after removal. If we leave i unchanged,
-                // the swapped-in last chunk can be reprocessed forever and lock up
-                // the main thread during world loading.
                 i++;
             } else {
                 // Skip this chunk for now; it will be removed once the save completes
@@ -1368,65 +2128,42 @@ void world_update_chunks(World *world, Vector3 player_pos, Vector3 camera_forwar
 
     pthread_mutex_unlock(&world->cache_mutex);
 
-    if (chunk_to_save) {
-        worker_queue_chunk_save(world, chunk_to_save);
+    // Only the main thread unloads chunks, so the handle is still live here
+    Chunk *save_chunk = chunk_pool_resolve(&world->chunk_cache, chunk_to_save);
+    if (save_chunk) {
+        save_queue_chunk(world, save_chunk);
     }
 }
 
 // Chunk file format header
 static const char CHUNK_FILE_MAGIC[4] = {'B', '3', 'D', 'V'};
 static const uint8_t CHUNK_FILE_VERSION = 2;
-
-// Human-readable error for last chunk load failure (used for diagnostics)
-static char CHUNK_LOAD_ERROR[256];
+#define CHUNK_RECORD_HEADER_SIZE 14 // Magic, version, method, payload size, uncompressed size
 
 enum ChunkFileMethod {
     CHUNK_METHOD_RAW = 0,
     CHUNK_METHOD_RLE = 1,
-    CHUNK_METHOD_RAW_COMPRESSED = 2,
-    CHUNK_METHOD_RLE_COMPRESSED = 3,
+    CHUNK_METHOD_RAW_COMPRESSED = 2, // zlib
+    CHUNK_METHOD_RLE_COMPRESSED = 3, // zlib
+    CHUNK_METHOD_RAW_LZ4 = 4,        // Written by builds with HAVE_LZ4, readable only by them
+    CHUNK_METHOD_RLE_LZ4 = 5,
 };
 
-static bool write_le32(FILE *file, uint32_t value) {
-    uint8_t bytes[4] = {
-        (uint8_t)(value & 0xFF),
-        (uint8_t)((value >> 8) & 0xFF),
-        (uint8_t)((value >> 16) & 0xFF),
-        (uint8_t)((value >> 24) & 0xFF),
-    };
-    return fwrite(bytes, 1, sizeof(bytes), file) == sizeof(bytes);
-}
+// Payloads this small gain nothing from compression (a uniform chunk is one 5-byte run)
+#define CHUNK_COMPRESS_MIN_PAYLOAD 64
 
-static bool read_le32(FILE *file, uint32_t *out_value) {
-    uint8_t bytes[4];
-    if (fread(bytes, 1, sizeof(bytes), file) != sizeof(bytes)) {
-        return false;
-    }
-    *out_value = (uint32_t)bytes[0] |
-                 ((uint32_t)bytes[1] << 8) |
-                 ((uint32_t)bytes[2] << 16) |
-                 ((uint32_t)bytes[3] << 24);
-    return true;
+static void put_le32(uint8_t *dst, uint32_t value) {
+    dst[0] = (uint8_t)(value & 0xFF);
+    dst[1] = (uint8_t)((value >> 8) & 0xFF);
+    dst[2] = (uint8_t)((value >> 16) & 0xFF);
+    dst[3] = (uint8_t)((value >> 24) & 0xFF);
 }
 
-static uint8_t *serialize_chunk_raw(Chunk *chunk, size_t *out_size) {
-    const int total_blocks = CHUNK_WIDTH * CHUNK_HEIGHT * CHUNK_DEPTH;
-    uint8_t *buffer = (uint8_t *)malloc(total_blocks);
-    if (!buffer) {
-        return NULL;
-    }
-
-    int offset = 0;
-    for (int y = 0; y < CHUNK_HEIGHT; y++) {
-        for (int z = 0; z < CHUNK_DEPTH; z++) {
-            for (int x = 0; x < CHUNK_WIDTH; x++) {
-                buffer[offset++] = (uint8_t)chunk->blocks[y][z][x].type;
-            }
-        }
-    }
-
-    *out_size = total_blocks;
-    return buffer;
+static uint32_t get_le32(const uint8_t *src) {
+    return (uint32_t)src[0] |
+           ((uint32_t)src[1] << 8) |
+           ((uint32_t)src[2] << 16) |
+           ((uint32_t)src[3] << 24);
 }
 
 static uint8_t *serialize_chunk_rle_v1(Chunk *chunk, size_t *out_size) {
@@ -1437,7 +2174,7 @@ static uint8_t *serialize_chunk_rle_v1(Chunk *chunk, size_t *out_size) {
         return NULL;
     }
 
-    uint8_t current_type = (uint8_t)chunk->blocks[0][0][0].type;
+    uint8_t current_type = (uint8_t)world_chunk_get_block(chunk, 0, 0, 0);
     uint16_t run_length = 1;
     size_t offset = 0;
 
@@ -1446,7 +2183,7 @@ static uint8_t *serialize_chunk_rle_v1(Chunk *chunk, size_t *out_size) {
         int rem = block_index % (CHUNK_WIDTH * CHUNK_DEPTH);
         int z = rem / CHUNK_WIDTH;
         int x = rem % CHUNK_WIDTH;
-        uint8_t next_type = (uint8_t)chunk->blocks[y][z][x].type;
+        uint8_t next_type = (uint8_t)world_chunk_get_block(chunk, x, y, z);
 
         if (next_type == current_type && run_length < UINT16_MAX) {
             run_length++;
@@ -1467,323 +2204,324 @@ static uint8_t *serialize_chunk_rle_v1(Chunk *chunk, size_t *out_size) {
     return buffer;
 }
 
-static uint8_t *serialize_chunk_rle_v2(Chunk *chunk, size_t *out_size) {
-    const int total_blocks = CHUNK_WIDTH * CHUNK_HEIGHT * CHUNK_DEPTH;
-    size_t max_size = (size_t)total_blocks * 5;
-    uint8_t *buffer = (uint8_t *)malloc(max_size);
-    if (!buffer) {
-        return NULL;
+// End of the run of equal bytes starting at `start`, comparing 8 bytes at a time
+static size_t chunk_run_end(const uint8_t *types, size_t start, size_t total_blocks) {
+    const uint64_t pattern = types[start] * UINT64_C(0x0101010101010101);
+    size_t end = start + 1;
+    while (end + sizeof(uint64_t) <= total_blocks) {
+        uint64_t word;
+        memcpy(&word, types + end, sizeof(word));
+        if (word != pattern) {
+            break;
+        }
+        end += sizeof(uint64_t);
+    }
+    while (end < total_blocks && types[end] == types[start]) {
+        end++;
     }
+    return end;
+}
 
-    uint8_t current_type = (uint8_t)chunk->blocks[0][0][0].type;
-    uint32_t run_length = 1;
+// RLE v2 payload of one type byte per block: a uint32_t run length, then the type, per run.
+// `out` needs 5 bytes per run. Returns the payload size.
+static size_t encode_rle_runs(const uint8_t *types, size_t total_blocks, uint8_t *out) {
     size_t offset = 0;
+    for (size_t start = 0; start < total_blocks;) {
+        size_t end = chunk_run_end(types, start, total_blocks);
+        uint32_t run_length = (uint32_t)(end - start);
+        memcpy(out + offset, &run_length, sizeof(run_length));
+        offset += sizeof(run_length);
+        out[offset++] = types[start];
+        start = end;
+    }
+    return offset;
+}
 
-    for (int block_index = 1; block_index < total_blocks; block_index++) {
-        int y = block_index / (CHUNK_WIDTH * CHUNK_DEPTH);
-        int rem = block_index % (CHUNK_WIDTH * CHUNK_DEPTH);
-        int z = rem / CHUNK_WIDTH;
-        int x = rem % CHUNK_WIDTH;
-        uint8_t next_type = (uint8_t)chunk->blocks[y][z][x].type;
+// Compress `source` into `dest` (room for chunk_compress_bound bytes) with the build's
+// codec. Returns the compressed size, 0 on failure.
+static size_t chunk_compress_bound(size_t source_size) {
+#ifdef HAVE_LZ4
+    return (size_t)LZ4_compressBound((int)source_size);
+#else
+    return (size_t)compressBound((uLong)source_size);
+#endif
+}
 
-        if (next_type == current_type) {
-            run_length++;
+static size_t chunk_compress(const uint8_t *source, size_t source_size, uint8_t *dest) {
+#ifdef HAVE_LZ4
+    int size = LZ4_compress_default((const char *)source, (char *)dest, (int)source_size,
+                                    (int)chunk_compress_bound(source_size));
+    return size > 0 ? (size_t)size : 0;
+#else
+    uLongf size = (uLongf)chunk_compress_bound(source_size);
+    return compress2(dest, &size, source, (uLong)source_size, Z_BEST_SPEED) == Z_OK ? (size_t)size : 0;
+#endif
+}
+
+// Encode a chunk's block types (chunk_storage_read_types order) as a chunk record
+// (header + payload), the unit stored in region files. Returns a malloc'd buffer,
+// NULL on allocation failure.
+//
+// The method comes from one pass over the block types rather than from trying them all:
+// the run count gives the RLE size exactly (5 bytes a run), and whichever of RLE and raw
+// is smaller is the only payload built and, when allowed, compressed. The compressed form
+// is kept only if it is smaller still.
+uint8_t *chunk_encode_types(const uint8_t *types, bool allow_compression, size_t *out_size) {
+    const size_t total_blocks = CHUNK_WIDTH * CHUNK_HEIGHT * CHUNK_DEPTH;
+    size_t runs = 0;
+    for (size_t start = 0; start < total_blocks; start = chunk_run_end(types, start, total_blocks)) {
+        runs++;
+    }
+
+    uint8_t method = CHUNK_METHOD_RAW;
+    const uint8_t *payload = types;
+    size_t payload_size = total_blocks;
+    uint8_t *rle = NULL;
+    size_t rle_size = runs * (sizeof(uint32_t) + 1);
+    if (rle_size < total_blocks && (rle = (uint8_t *)malloc(rle_size))) {
+        method = CHUNK_METHOD_RLE;
+        payload = rle;
+        payload_size = encode_rle_runs(types, total_blocks, rle);
+    }
+
+    bool compress = allow_compression && payload_size > CHUNK_COMPRESS_MIN_PAYLOAD;
+    size_t capacity = compress ? chunk_compress_bound(payload_size) : payload_size;
+    if (capacity < payload_size) {
+        capacity = payload_size;
+    }
+    uint8_t *record = (uint8_t *)malloc(CHUNK_RECORD_HEADER_SIZE + capacity);
+    if (record) {
+        uint32_t uncompressed_size = (uint32_t)payload_size;
+        size_t record_payload_size = compress ? chunk_compress(payload, payload_size, record + CHUNK_RECORD_HEADER_SIZE) : 0;
+        if (record_payload_size > 0 && record_payload_size < payload_size) {
+#ifdef HAVE_LZ4
+            method = method == CHUNK_METHOD_RLE ? CHUNK_METHOD_RLE_LZ4 : CHUNK_METHOD_RAW_LZ4;
+#else
+            method = method == CHUNK_METHOD_RLE ? CHUNK_METHOD_RLE_COMPRESSED : CHUNK_METHOD_RAW_COMPRESSED;
+#endif
         } else {
-            memcpy(buffer + offset, &run_length, sizeof(run_length));
-            offset += sizeof(run_length);
-            buffer[offset++] = current_type;
-            current_type = next_type;
-            run_length = 1;
+            memcpy(record + CHUNK_RECORD_HEADER_SIZE, payload, payload_size);
+            record_payload_size = payload_size;
         }
+        memcpy(record, CHUNK_FILE_MAGIC, sizeof(CHUNK_FILE_MAGIC));
+        record[4] = CHUNK_FILE_VERSION;
+        record[5] = method;
+        put_le32(record + 6, (uint32_t)record_payload_size);
+        put_le32(record + 10, uncompressed_size);
+        *out_size = CHUNK_RECORD_HEADER_SIZE + record_payload_size;
     }
 
-    memcpy(buffer + offset, &run_length, sizeof(run_length));
-    offset += sizeof(run_length);
-    buffer[offset++] = current_type;
-
-    *out_size = offset;
-    return buffer;
+    free(rle);
+    return record;
 }
 
-static uint8_t *compress_buffer(const uint8_t *source, size_t source_size, size_t *out_compressed_size) {
-    uLong bound = compressBound(source_size);
-    uint8_t *compressed = (uint8_t *)malloc(bound);
-    if (!compressed) {
+static uint8_t *encode_chunk_record(Chunk *chunk, bool allow_compression, size_t *out_size) {
+    if (!chunk) {
         return NULL;
     }
-
-    uLongf compressed_size = bound;
-    int result = compress2(compressed, &compressed_size, source, source_size, Z_BEST_SPEED);
-    if (result != Z_OK) {
-        free(compressed);
+    uint8_t *types = (uint8_t *)malloc(CHUNK_WIDTH * CHUNK_HEIGHT * CHUNK_DEPTH);
+    if (!types) {
         return NULL;
     }
-
-    *out_compressed_size = (size_t)compressed_size;
-    return compressed;
-}
-
-static bool write_chunk_file(FILE *file, Chunk *chunk, bool allow_compression) {
-    if (!file || !chunk) {
-        return false;
-    }
-
-    size_t raw_size = 0;
-    uint8_t *raw_buffer = serialize_chunk_raw(chunk, &raw_size);
-    if (!raw_buffer) {
-        return false;
-    }
-
-    size_t rle_size = 0;
-    uint8_t *rle_buffer = serialize_chunk_rle_v2(chunk, &rle_size);
-    if (!rle_buffer) {
-        free(raw_buffer);
-        return false;
-    }
-
-    size_t raw_comp_size = 0;
-    uint8_t *raw_comp = NULL;
-    size_t rle_comp_size = 0;
-    uint8_t *rle_comp = NULL;
-    if (allow_compression) {
-        raw_comp = compress_buffer(raw_buffer, raw_size, &raw_comp_size);
-        rle_comp = compress_buffer(rle_buffer, rle_size, &rle_comp_size);
-    }
-
-    uint8_t method = CHUNK_METHOD_RLE;
-    const uint8_t *payload = rle_buffer;
-    size_t payload_size = rle_size;
-    uint32_t uncompressed_size = (uint32_t)rle_size;
-
-    if (raw_size < payload_size) {
-        method = CHUNK_METHOD_RAW;
-        payload = raw_buffer;
-        payload_size = raw_size;
-        uncompressed_size = (uint32_t)raw_size;
-    }
-
-    if (allow_compression && raw_comp && raw_comp_size < payload_size) {
-        method = CHUNK_METHOD_RAW_COMPRESSED;
-        payload = raw_comp;
-        payload_size = raw_comp_size;
-        uncompressed_size = (uint32_t)raw_size;
-    }
-
-    if (allow_compression && rle_comp && rle_comp_size < payload_size) {
-        method = CHUNK_METHOD_RLE_COMPRESSED;
-        payload = rle_comp;
-        payload_size = rle_comp_size;
-        uncompressed_size = (uint32_t)rle_size;
-    }
-
-    bool success = true;
-    if (fwrite(CHUNK_FILE_MAGIC, 1, sizeof(CHUNK_FILE_MAGIC), file) != sizeof(CHUNK_FILE_MAGIC) ||
-        fwrite(&CHUNK_FILE_VERSION, 1, 1, file) != 1 ||
-        fwrite(&method, 1, 1, file) != 1 ||
-        !write_le32(file, (uint32_t)payload_size) ||
-        !write_le32(file, uncompressed_size) ||
-        fwrite(payload, 1, payload_size, file) != payload_size) {
-        success = false;
-    }
-
-    free(raw_buffer);
-    free(rle_buffer);
-    if (raw_comp) {
-        free(raw_comp);
-    }
-    if (rle_comp) {
-        free(rle_comp);
-    }
-    return success;
+    chunk_storage_read_types(chunk, types);
+    uint8_t *record = chunk_encode_types(types, allow_compression, out_size);
+    free(types);
+    return record;
 }
 
-static bool parse_rle_payload_v1(const uint8_t *buffer, size_t buffer_size, Chunk *chunk) {
-    const int total_blocks = CHUNK_WIDTH * CHUNK_HEIGHT * CHUNK_DEPTH;
-    int loaded_blocks = 0;
+// Expand an RLE payload into one block type byte per block. Runs are a length (uint16_t
+// in version 1, uint32_t since) followed by the type, and each is a single memset.
+static bool expand_rle_payload(const uint8_t *buffer, size_t buffer_size, uint8_t version, uint8_t *types) {
+    const size_t total_blocks = CHUNK_WIDTH * CHUNK_HEIGHT * CHUNK_DEPTH;
+    const size_t length_size = version == 1 ? sizeof(uint16_t) : sizeof(uint32_t);
+    size_t loaded_blocks = 0;
     size_t offset = 0;
 
-    while (loaded_blocks < total_blocks && offset + sizeof(uint16_t) + 1 <= buffer_size) {
-        uint16_t run_length;
-        memcpy(&run_length, buffer + offset, sizeof(run_length));
-        offset += sizeof(run_length);
+    while (loaded_blocks < total_blocks && offset + length_size + 1 <= buffer_size) {
+        uint32_t run_length;
+        if (version == 1) {
+            uint16_t short_length;
+            memcpy(&short_length, buffer + offset, sizeof(short_length));
+            run_length = short_length;
+        } else {
+            memcpy(&run_length, buffer + offset, sizeof(run_length));
+        }
+        offset += length_size;
         uint8_t block_type = buffer[offset++];
 
-        if (run_length == 0 || loaded_blocks + run_length > total_blocks) {
+        if (run_length == 0 || run_length > total_blocks - loaded_blocks) {
             return false;
         }
-
-        for (int i = 0; i < run_length; i++) {
-            int flat_index = loaded_blocks + i;
-            int y = flat_index / (CHUNK_WIDTH * CHUNK_DEPTH);
-            int rem = flat_index % (CHUNK_WIDTH * CHUNK_DEPTH);
-            int z = rem / CHUNK_WIDTH;
-            int x = rem % CHUNK_WIDTH;
-            chunk->blocks[y][z][x].type = (BlockType)block_type;
-        }
+        memset(types + loaded_blocks, block_type, run_length);
         loaded_blocks += run_length;
     }
 
     return loaded_blocks == total_blocks;
 }
 
-static bool parse_rle_payload_v2(const uint8_t *buffer, size_t buffer_size, Chunk *chunk) {
-    const int total_blocks = CHUNK_WIDTH * CHUNK_HEIGHT * CHUNK_DEPTH;
-    int loaded_blocks = 0;
-    size_t offset = 0;
-
-    while (loaded_blocks < total_blocks && offset + sizeof(uint32_t) + 1 <= buffer_size) {
-        uint32_t run_length;
-        memcpy(&run_length, buffer + offset, sizeof(run_length));
-        offset += sizeof(run_length);
-        uint8_t block_type = buffer[offset++];
-
-        if (run_length == 0 || loaded_blocks + run_length > total_blocks) {
-            return false;
-        }
-
-        for (uint32_t i = 0; i < run_length; i++) {
-            int flat_index = loaded_blocks + i;
-            int y = flat_index / (CHUNK_WIDTH * CHUNK_DEPTH);
-            int rem = flat_index % (CHUNK_WIDTH * CHUNK_DEPTH);
-            int z = rem / CHUNK_WIDTH;
-            int x = rem % CHUNK_WIDTH;
-            chunk->blocks[y][z][x].type = (BlockType)block_type;
-        }
-        loaded_blocks += run_length;
+// Legacy raw format: one BlockType value per block, no header
+static bool load_chunk_legacy_raw(const uint8_t *data, size_t size, Chunk *chunk) {
+    const size_t total_blocks = CHUNK_WIDTH * CHUNK_HEIGHT * CHUNK_DEPTH;
+    if (size < total_blocks * sizeof(BlockType)) {
+        snprintf(CHUNK_LOAD_ERROR, sizeof(CHUNK_LOAD_ERROR), "legacy raw chunk truncated (%zu bytes)", size);
+        return false;
     }
-
-    return loaded_blocks == total_blocks;
+    uint8_t *types = (uint8_t *)malloc(total_blocks);
+    if (!types) {
+        snprintf(CHUNK_LOAD_ERROR, sizeof(CHUNK_LOAD_ERROR), "malloc block scratch failed");
+        return false;
+    }
+    for (size_t i = 0; i < total_blocks; i++) {
+        BlockType block_type;
+        memcpy(&block_type, data + i * sizeof(BlockType), sizeof(BlockType));
+        types[i] = (uint8_t)block_type;
+    }
+    chunk_storage_fill_types(chunk, types);
+    free(types);
+    return true;
 }
 
-static bool load_chunk_from_file(FILE *file, Chunk *chunk) {
+// Decode a chunk record (or a whole legacy chunk file) into the chunk's storage. The record
+// is only read, so it can point straight into a mapped region file. Raw payloads are packed
+// from the record itself; other methods inflate and expand into one scratch buffer.
+static bool load_chunk_from_buffer(const uint8_t *data, size_t size, Chunk *chunk) {
+    const size_t total_blocks = CHUNK_WIDTH * CHUNK_HEIGHT * CHUNK_DEPTH;
+
     // Clear previous error
     CHUNK_LOAD_ERROR[0] = '\0';
 
-    uint8_t magic[4];
-    if (fread(magic, 1, sizeof(magic), file) != sizeof(magic)) {
-        snprintf(CHUNK_LOAD_ERROR, sizeof(CHUNK_LOAD_ERROR), "short header");
-        return false;
+    // Detect the format, preserving compatibility with the legacy raw format
+    if (size < sizeof(CHUNK_FILE_MAGIC) || memcmp(data, CHUNK_FILE_MAGIC, sizeof(CHUNK_FILE_MAGIC)) != 0) {
+        return load_chunk_legacy_raw(data, size, chunk);
     }
-    if (memcmp(magic, CHUNK_FILE_MAGIC, sizeof(magic)) != 0) {
-        snprintf(CHUNK_LOAD_ERROR, sizeof(CHUNK_LOAD_ERROR), "bad magic: %.4s", (char *)magic);
+    if (size < CHUNK_RECORD_HEADER_SIZE) {
+        snprintf(CHUNK_LOAD_ERROR, sizeof(CHUNK_LOAD_ERROR), "short header");
         return false;
     }
 
-    uint8_t version;
-    if (fread(&version, 1, 1, file) != 1) {
-        snprintf(CHUNK_LOAD_ERROR, sizeof(CHUNK_LOAD_ERROR), "short version byte");
-        return false;
-    }
+    // A record this build can't decode may be perfectly good (a newer format, or LZ4
+    // from a -Dlz4 build): the chunk goes read-only so its stand-in terrain is never
+    // saved over it
+    uint8_t version = data[4];
     if (version != 1 && version != CHUNK_FILE_VERSION) {
-        snprintf(CHUNK_LOAD_ERROR, sizeof(CHUNK_LOAD_ERROR), "unsupported version %u", version);
+        snprintf(CHUNK_LOAD_ERROR, sizeof(CHUNK_LOAD_ERROR), "unsupported version %u, chunk is read-only", version);
+        chunk->read_only = true;
         return false;
     }
 
-    uint8_t method;
-    if (fread(&method, 1, 1, file) != 1) {
-        snprintf(CHUNK_LOAD_ERROR, sizeof(CHUNK_LOAD_ERROR), "short method byte");
+    uint8_t method = data[5];
+    uint32_t payload_size = get_le32(data + 6);
+    uint32_t uncompressed_size = get_le32(data + 10);
+    if (payload_size > size - CHUNK_RECORD_HEADER_SIZE) {
+        snprintf(CHUNK_LOAD_ERROR, sizeof(CHUNK_LOAD_ERROR), "payload truncated (got %zu expected %u)",
+                 size - CHUNK_RECORD_HEADER_SIZE, payload_size);
         return false;
     }
+    const uint8_t *payload = data + CHUNK_RECORD_HEADER_SIZE;
 
-    uint32_t payload_size;
-    uint32_t uncompressed_size;
-    if (!read_le32(file, &payload_size) || !read_le32(file, &uncompressed_size)) {
-        snprintf(CHUNK_LOAD_ERROR, sizeof(CHUNK_LOAD_ERROR), "short size fields");
-        return false;
+    if (method == CHUNK_METHOD_RAW) {
+        if (payload_size != total_blocks) {
+            snprintf(CHUNK_LOAD_ERROR, sizeof(CHUNK_LOAD_ERROR), "raw size mismatch parsed=%u expected=%zu", payload_size, total_blocks);
+            return false;
+        }
+        chunk_storage_fill_types(chunk, payload);
+        return true;
     }
 
-    uint8_t *payload = (uint8_t *)malloc(payload_size);
-    if (!payload) {
-        snprintf(CHUNK_LOAD_ERROR, sizeof(CHUNK_LOAD_ERROR), "malloc payload failed (%u)", payload_size);
+    bool lz4 = method == CHUNK_METHOD_RAW_LZ4 || method == CHUNK_METHOD_RLE_LZ4;
+    bool compressed = lz4 || method == CHUNK_METHOD_RAW_COMPRESSED || method == CHUNK_METHOD_RLE_COMPRESSED;
+    bool rle = method == CHUNK_METHOD_RLE || method == CHUNK_METHOD_RLE_COMPRESSED || method == CHUNK_METHOD_RLE_LZ4;
+    if (!compressed && !rle) {
+        snprintf(CHUNK_LOAD_ERROR, sizeof(CHUNK_LOAD_ERROR), "unknown method %u, chunk is read-only", method);
+        chunk->read_only = true;
         return false;
     }
-    if (fread(payload, 1, payload_size, file) != payload_size) {
-        snprintf(CHUNK_LOAD_ERROR, sizeof(CHUNK_LOAD_ERROR), "payload truncated (got %zu expected %u)", (size_t)fread(payload, 1, 0, file), payload_size);
-        free(payload);
+#ifndef HAVE_LZ4
+    if (lz4) {
+        snprintf(CHUNK_LOAD_ERROR, sizeof(CHUNK_LOAD_ERROR),
+                 "LZ4 record, but built without LZ4 (zig build -Dlz4=true), chunk is read-only");
+        chunk->read_only = true;
+        return false;
+    }
+#endif
+    // Raw data inflates to exactly one byte per block; an RLE stream is at most 5 bytes per run
+    if (compressed && (rle ? uncompressed_size > total_blocks * 5 : uncompressed_size != total_blocks)) {
+        snprintf(CHUNK_LOAD_ERROR, sizeof(CHUNK_LOAD_ERROR), "bad uncompressed size %u", uncompressed_size);
         return false;
     }
 
-    uint8_t *decompressed = NULL;
-    const uint8_t *parse_buffer = payload;
-    size_t parse_buffer_size = payload_size;
-
-    if (method == CHUNK_METHOD_RAW_COMPRESSED || method == CHUNK_METHOD_RLE_COMPRESSED) {
-        decompressed = (uint8_t *)malloc(uncompressed_size);
-        if (!decompressed) {
-            snprintf(CHUNK_LOAD_ERROR, sizeof(CHUNK_LOAD_ERROR), "malloc decompressed failed (%u)", uncompressed_size);
-            free(payload);
-            return false;
-        }
-        uLongf dest_len = uncompressed_size;
-        int result = uncompress(decompressed, &dest_len, payload, payload_size);
-        free(payload);
-        if (result != Z_OK || dest_len != uncompressed_size) {
-            snprintf(CHUNK_LOAD_ERROR, sizeof(CHUNK_LOAD_ERROR), "zlib uncompress failed (%d) dest_len=%lu expected=%u", result, (unsigned long)dest_len, uncompressed_size);
-            free(decompressed);
-            return false;
-        }
-        parse_buffer = decompressed;
-        parse_buffer_size = dest_len;
+    // Block types first, then room for the inflated RLE stream if there is one
+    uint8_t *types = (uint8_t *)malloc(total_blocks + (compressed && rle ? uncompressed_size : 0));
+    if (!types) {
+        snprintf(CHUNK_LOAD_ERROR, sizeof(CHUNK_LOAD_ERROR), "malloc block scratch failed");
+        return false;
     }
 
-    bool success = false;
-    if (method == CHUNK_METHOD_RAW || method == CHUNK_METHOD_RAW_COMPRESSED) {
-        const int total_blocks = CHUNK_WIDTH * CHUNK_HEIGHT * CHUNK_DEPTH;
-        if (parse_buffer_size == (size_t)total_blocks) {
-            int offset = 0;
-            for (int y = 0; y < CHUNK_HEIGHT; y++) {
-                for (int z = 0; z < CHUNK_DEPTH; z++) {
-                    for (int x = 0; x < CHUNK_WIDTH; x++) {
-                        chunk->blocks[y][z][x].type = (BlockType)parse_buffer[offset++];
-                    }
-                }
-            }
-            success = true;
-        } else {
-            snprintf(CHUNK_LOAD_ERROR, sizeof(CHUNK_LOAD_ERROR), "raw size mismatch parsed=%zu expected=%d", parse_buffer_size, CHUNK_WIDTH * CHUNK_HEIGHT * CHUNK_DEPTH);
-        }
-    } else if (method == CHUNK_METHOD_RLE || method == CHUNK_METHOD_RLE_COMPRESSED) {
-        if (version == 1) {
-            success = parse_rle_payload_v1(parse_buffer, parse_buffer_size, chunk);
-            if (!success) {
-                snprintf(CHUNK_LOAD_ERROR, sizeof(CHUNK_LOAD_ERROR), "rle v1 parse failed (buf=%zu)", parse_buffer_size);
+    const uint8_t *rle_buffer = payload;
+    size_t rle_size = payload_size;
+    bool success = true;
+    if (compressed) {
+        uint8_t *dest = rle ? types + total_blocks : types;
+        size_t dest_len = 0;
+        if (lz4) {
+#ifdef HAVE_LZ4
+            int result = LZ4_decompress_safe((const char *)payload, (char *)dest, (int)payload_size, (int)uncompressed_size);
+            if (result < 0 || (uint32_t)result != uncompressed_size) {
+                snprintf(CHUNK_LOAD_ERROR, sizeof(CHUNK_LOAD_ERROR), "lz4 decompress failed (%d) expected=%u", result, uncompressed_size);
+                success = false;
             }
+            dest_len = uncompressed_size;
+#endif
         } else {
-            success = parse_rle_payload_v2(parse_buffer, parse_buffer_size, chunk);
-            if (!success) {
-                snprintf(CHUNK_LOAD_ERROR, sizeof(CHUNK_LOAD_ERROR), "rle v2 parse failed (buf=%zu)", parse_buffer_size);
+            uLongf zlib_len = uncompressed_size;
+            int result = uncompress(dest, &zlib_len, payload, payload_size);
+            if (result != Z_OK || zlib_len != uncompressed_size) {
+                snprintf(CHUNK_LOAD_ERROR, sizeof(CHUNK_LOAD_ERROR), "zlib uncompress failed (%d) dest_len=%lu expected=%u", result, (unsigned long)zlib_len, uncompressed_size);
+                success = false;
             }
+            dest_len = zlib_len;
         }
-    } else {
-        snprintf(CHUNK_LOAD_ERROR, sizeof(CHUNK_LOAD_ERROR), "unknown method %u", method);
+        rle_buffer = dest;
+        rle_size = dest_len;
     }
-
-    if (decompressed) {
-        free(decompressed);
+    if (success && rle) {
+        success = expand_rle_payload(rle_buffer, rle_size, version, types);
+        if (!success) {
+            snprintf(CHUNK_LOAD_ERROR, sizeof(CHUNK_LOAD_ERROR), "rle v%u parse failed (buf=%zu)", version, rle_size);
+        }
     }
-    if (method == CHUNK_METHOD_RAW || method == CHUNK_METHOD_RLE) {
-        free(payload);
+
+    if (success) {
+        chunk_storage_fill_types(chunk, types);
     }
+    free(types);
     return success;
 }
 
-// Save a single chunk to disk
+// Decode a stored record for callers outside this file (the chunk read engine).
+// On failure `out_error` points at this thread's description of why.
+bool chunk_load_record(const uint8_t *record, size_t size, Chunk *chunk, const char **out_error) {
+    bool ok = load_chunk_from_buffer(record, size, chunk);
+    if (out_error) {
+        *out_error = CHUNK_LOAD_ERROR;
+    }
+    return ok;
+}
+
+// Save a single chunk to disk, into its region file
 bool world_save_chunk(Chunk *chunk, const char *world_name, bool allow_compression) {
     if (!chunk || !world_name) {
         return false;
     }
 
-    char filepath[512];
-    snprintf(filepath, sizeof(filepath), "./worlds/%s/chunks/chunk_%d_%d_%d.chunk",
-             world_name, chunk->chunk_x, chunk->chunk_y, chunk->chunk_z);
-
-    FILE *file = fopen(filepath, "wb");
-    if (!file) {
+    size_t record_size = 0;
+    uint8_t *record = encode_chunk_record(chunk, allow_compression, &record_size);
+    if (!record) {
         return false;
     }
 
-    bool success = write_chunk_file(file, chunk, allow_compression);
-    fclose(file);
+    bool success = region_write_chunk(world_name, chunk->chunk_x, chunk->chunk_y, chunk->chunk_z, record, record_size);
+    free(record);
     return success;
 }
 
@@ -1796,7 +2534,39 @@ void world_system_init(void) {
 #endif
 }
 
+// world.txt and players.toml are written to "<path>.tmp" and renamed over the old
+// file once complete, so a crash mid-save leaves the previous version intact
+static FILE *open_temp_file(const char *path, char *temp_path, size_t temp_size) {
+    snprintf(temp_path, temp_size, "%s.tmp", path);
+    return fopen(temp_path, "w");
+}
+
+static bool commit_temp_file(FILE *file, const char *temp_path, const char *path, bool sync) {
+    bool success = fflush(file) == 0;
+#ifndef _WIN32
+    if (success && sync) {
+        success = fsync(fileno(file)) == 0;
+    }
+#else
+    (void)sync;
+#endif
+    success = fclose(file) == 0 && success;
+#ifdef _WIN32
+    remove(path); // rename() does not replace an existing file on Windows
+#endif
+    if (!success || rename(temp_path, path) != 0) {
+        printf("[save] Failed to write %s\n", path);
+        remove(temp_path);
+        return false;
+    }
+    return true;
+}
+
 // Save world to files (chunks)
+//
+// Saving under the world's own name writes only modified chunks, through the save
+// thread, and returns once they are on disk. Saving under another name ("save as")
+// writes every loaded chunk directly, as the new world has none of them yet.
 bool world_save(World *world, const char *world_name) {
     if (!world || !world_name) {
         return false;
@@ -1824,7 +2594,9 @@ bool world_save(World *world, const char *world_name) {
     char metadata_path[512];
     snprintf(metadata_path, sizeof(metadata_path), "./worlds/%s/world.txt", world_name);
 
-    FILE *metadata_file = fopen(metadata_path, "w");
+    char metadata_temp_path[520];
+    bool sync = world->save_queue.config.fsync_mode != SAVE_FSYNC_NEVER;
+    FILE *metadata_file = open_temp_file(metadata_path, metadata_temp_path, sizeof(metadata_temp_path));
     if (metadata_file) {
         time_t now = time(NULL);
         struct tm *timeinfo = localtime(&now);
@@ -1837,17 +2609,30 @@ bool world_save(World *world, const char *world_name) {
         fprintf(metadata_file, "last_saved=%s\n", time_str);
         fprintf(metadata_file, "chunk_count=%d\n", world->chunk_cache.chunk_count);
         // Player position is stored per-world in players.toml (or legacy players.txt) now
-        fclose(metadata_file);
+        commit_temp_file(metadata_file, metadata_temp_path, metadata_path, sync);
     }
 
     // Prefer player position from players.toml or fallback to legacy players.txt
     world_apply_players_to(world, NULL);
 
-    // Save each loaded chunk
-    for (int i = 0; i < world->chunk_cache.chunk_count; i++) {
-        Chunk *chunk = &world->chunk_cache.chunks[i];
-        if (world_save_chunk(chunk, world_name, world->compress_chunk_files)) {
-            chunk->modified = false; // Mark chunk as saved
+    if (strcmp(world_name, world->world_name) == 0) {
+        // Queue every modified chunk (already queued ones are coalesced) and wait for the writes
+        pthread_mutex_lock(&world->cache_mutex);
+        for (int i = 0; i < world->chunk_cache.chunk_count; i++) {
+            save_queue_chunk(world, world->chunk_cache.live[i]);
+        }
+        pthread_mutex_unlock(&world->cache_mutex);
+        save_queue_flush(world);
+    } else {
+        // Save each loaded chunk into the other world
+        for (int i = 0; i < world->chunk_cache.chunk_count; i++) {
+            Chunk *chunk = world->chunk_cache.live[i];
+            // Terrain still being generated would be written out as air, and a
+            // read-only chunk's terrain is only a stand-in for its stored record
+            if (chunk->pending_generate || chunk->read_only) {
+                continue;
+            }
+            world_save_chunk(chunk, world_name, world->compress_chunk_files);
         }
     }
 
@@ -1927,7 +2712,8 @@ static void write_players_file(World *world, void *player_ptr, const char *world
     Player *player = (Player *)player_ptr;
     char path[512];
     snprintf(path, sizeof(path), "./worlds/%s/players.toml", world_name);
-    FILE *f = fopen(path, "w");
+    char temp_path[520];
+    FILE *f = open_temp_file(path, temp_path, sizeof(temp_path));
     if (!f) {
         return;
     }
@@ -1965,7 +2751,7 @@ static void write_players_file(World *world, void *player_ptr, const char *world
         }
     }
 
-    fclose(f);
+    commit_temp_file(f, temp_path, path, world->save_queue.config.fsync_mode != SAVE_FSYNC_NEVER);
 }
 
 // Read players.txt and apply found player's position into world->last_player_position
@@ -2217,22 +3003,23 @@ bool world_load(World *world, const char *world_name) {
         return false;
     }
 
-    // CRITICAL: Flush the worker queue before clearing chunks
-    // This prevents the worker thread from accessing chunks we're about to reset
+    // CRITICAL: Flush the read, worker and save queues before clearing chunks
+    // This prevents their threads from accessing chunks we're about to reset.
+    // Reads go first since finishing one can queue worker jobs.
+    chunk_io_flush(world);
     worker_flush_queue(world);
+    save_queue_flush(world);
 
-    // Clear existing chunks first
-    // NOTE: Don't destroy mutexes - worker thread is still running and might use them
-    // Just clear out the data
-    if (world->chunk_cache.chunks) {
-        for (int i = 0; i < world->chunk_cache.chunk_count; i++) {
-            chunk_free_visible_blocks(&world->chunk_cache.chunks[i]);
-            // Don't destroy mutexes - they'll be reused when new chunks are loaded
-        }
+    // Clear existing chunks first. They are retired rather than freed, since a
+    // lock-free world_get_block may still be reading one.
+    pthread_mutex_lock(&world->cache_mutex);
+    chunk_hash_clear(&world->chunk_cache);
+    while (world->chunk_cache.chunk_count > 0) {
+        Chunk *chunk = world->chunk_cache.live[world->chunk_cache.chunk_count - 1];
+        chunk_free_merged_mesh(chunk);
+        chunk_pool_retire(&world->chunk_cache, chunk);
     }
-
-    // Reset the chunk count (keeps pre-allocated memory)
-    world->chunk_cache.chunk_count = 0;
+    pthread_mutex_unlock(&world->cache_mutex);
 
     // Set the world name so chunk loading uses the correct directory
     strncpy(world->world_name, world_name, sizeof(world->world_name) - 1);
@@ -2264,6 +3051,15 @@ bool world_load(World *world, const char *world_name) {
     // If players.txt exists, prefer player position from there (players file supersedes world.txt)
     world_apply_players_to(world, NULL);
 
+    // Worlds saved before region files have one file per chunk: move them into regions once
+    int migration_failed = 0;
+    int migrated = region_migrate_chunk_files(world_name, &migration_failed);
+    if (migrated > 0 || migration_failed > 0) {
+        printf("[region] Moved %d chunk files of %s into region files (%d could not be moved)\n",
+               migrated, world_name, migration_failed);
+    }
+    world->legacy_chunk_files = migration_failed > 0;
+
     // Try to load initial chunks from disk
     // Only generate minimal spawn area to avoid startup lag
     int spawn_dist = 1; // Only load immediate area around spawn
@@ -2292,79 +3088,172 @@ bool world_load(World *world, const char *world_name) {
     return true;
 }
 
-// GREEDY MESHING: Merge adjacent coplanar exposed faces into larger rectangles
-// This dramatically reduces geometry - typically 60-80% reduction in face count
-// Algorithm: For each face direction, find maximal rectangles of exposed faces
-MergedMesh *chunk_greedy_mesh(Chunk *chunk, World *world) {
-    MergedMesh *mesh = (MergedMesh *)malloc(sizeof(MergedMesh));
-    memset(mesh, 0, sizeof(MergedMesh));
+// ============================================================================
+// PADDED MESH SNAPSHOT
+// ============================================================================
+// Meshing needs every block of a chunk plus the face-adjacent blocks of its six
+// neighbours. Rather than a world_get_block call (hash lookup, read section)
+// per neighbour test, the mesher first copies the chunk and a one-block border
+// into a (W+2)x(H+2)x(D+2) byte array, then runs entirely on that array.
+// Border cells outside a loaded neighbour read as air, as world_get_block does.
+// The 12 edge and 8 corner strips are never consulted (faces only look along
+// one axis) and stay air.
+
+#define MESH_PAD_WIDTH (CHUNK_WIDTH + 2)
+#define MESH_PAD_HEIGHT (CHUNK_HEIGHT + 2)
+#define MESH_PAD_DEPTH (CHUNK_DEPTH + 2)
 
-    // Initialize arrays for each face
-    for (int f = 0; f < 6; f++) {
-        mesh->quad_capacity[f] = 256;
-        mesh->quads[f] = (MergedQuad *)malloc(sizeof(MergedQuad) * mesh->quad_capacity[f]);
-        mesh->quad_count[f] = 0;
+typedef struct {
+    uint8_t blocks[MESH_PAD_HEIGHT][MESH_PAD_DEPTH][MESH_PAD_WIDTH];
+} ChunkMeshVolume;
+
+// Block at chunk-local coordinates, each in [-1, size]
+#define MESH_VOLUME_AT(volume, x, y, z) ((volume)->blocks[(y) + 1][(z) + 1][(x) + 1])
+
+static void chunk_mesh_snapshot(const Chunk *chunk, World *world, ChunkMeshVolume *volume) {
+    memset(volume, BLOCK_AIR, sizeof(*volume));
+
+    // The chunk itself, a row at a time
+    for (int y = 0; y < CHUNK_HEIGHT; y++) {
+        for (int z = 0; z < CHUNK_DEPTH; z++) {
+            chunk_storage_read_row(chunk, y, z, &MESH_VOLUME_AT(volume, 0, y, z));
+        }
     }
 
-    // For each face direction, perform greedy meshing
-    // Face 0: +X, Face 1: -X, Face 2: +Y, Face 3: -Y, Face 4: +Z, Face 5: -Z
+    // Borders from the six face neighbours. The read section keeps a neighbour
+    // that is being unloaded alive until we are done copying from it.
+    int reader = chunk_read_begin(&world->chunk_cache);
+    Chunk *pos_x = chunk_hash_lookup_concurrent(&world->chunk_cache, chunk->chunk_x + 1, chunk->chunk_y, chunk->chunk_z);
+    Chunk *neg_x = chunk_hash_lookup_concurrent(&world->chunk_cache, chunk->chunk_x - 1, chunk->chunk_y, chunk->chunk_z);
+    Chunk *pos_y = chunk_hash_lookup_concurrent(&world->chunk_cache, chunk->chunk_x, chunk->chunk_y + 1, chunk->chunk_z);
+    Chunk *neg_y = chunk_hash_lookup_concurrent(&world->chunk_cache, chunk->chunk_x, chunk->chunk_y - 1, chunk->chunk_z);
+    Chunk *pos_z = chunk_hash_lookup_concurrent(&world->chunk_cache, chunk->chunk_x, chunk->chunk_y, chunk->chunk_z + 1);
+    Chunk *neg_z = chunk_hash_lookup_concurrent(&world->chunk_cache, chunk->chunk_x, chunk->chunk_y, chunk->chunk_z - 1);
 
-    // +Y (top faces) - process in XZ plane
-    {
-        bool used[CHUNK_DEPTH][CHUNK_WIDTH] = {0}; // Mark which blocks have been merged
+    for (int y = 0; y < CHUNK_HEIGHT; y++) {
+        for (int z = 0; z < CHUNK_DEPTH; z++) {
+            if (pos_x) {
+                MESH_VOLUME_AT(volume, CHUNK_WIDTH, y, z) = (uint8_t)world_chunk_get_block(pos_x, 0, y, z);
+            }
+            if (neg_x) {
+                MESH_VOLUME_AT(volume, -1, y, z) = (uint8_t)world_chunk_get_block(neg_x, CHUNK_WIDTH - 1, y, z);
+            }
+        }
+        if (pos_z) {
+            chunk_storage_read_row(pos_z, y, 0, &MESH_VOLUME_AT(volume, 0, y, CHUNK_DEPTH));
+        }
+        if (neg_z) {
+            chunk_storage_read_row(neg_z, y, CHUNK_DEPTH - 1, &MESH_VOLUME_AT(volume, 0, y, -1));
+        }
+    }
+    for (int z = 0; z < CHUNK_DEPTH; z++) {
+        if (pos_y) {
+            chunk_storage_read_row(pos_y, 0, z, &MESH_VOLUME_AT(volume, 0, CHUNK_HEIGHT, z));
+        }
+        if (neg_y) {
+            chunk_storage_read_row(neg_y, CHUNK_HEIGHT - 1, z, &MESH_VOLUME_AT(volume, 0, -1, z));
+        }
+    }
+    chunk_read_end(&world->chunk_cache, reader);
+}
 
-        for (int y = CHUNK_HEIGHT - 1; y >= 0; y--) {
-            for (int z = 0; z < CHUNK_DEPTH; z++) {
-                for (int x = 0; x < CHUNK_WIDTH; x++) {
-                    if (used[z][x]) {
-                        continue;
-                    }
+// GREEDY MESHING: Merge adjacent coplanar exposed faces into larger rectangles
+// This dramatically reduces geometry - typically 60-80% reduction in face count
+// Algorithm: For each face direction and each layer along its normal, build a
+// mask of exposed faces, then repeatedly take the first set cell, grow it as
+// far as possible along the first in-plane axis (w), then along the second (h).
+// Faces only merge with faces of the same block type; within one direction
+// they also share a texture group (top/side/bottom), so a merged quad can be
+// drawn with one texture tiled w x h times.
+
+// {normal axis, w axis, h axis} per face direction, 0 = x, 1 = y, 2 = z (see MergedQuad)
+static const int greedy_face_axes[6][3] = {
+    {0, 2, 1}, // +X: w along z, h along y
+    {0, 2, 1}, // -X
+    {1, 0, 2}, // +Y: w along x, h along z
+    {1, 0, 2}, // -Y
+    {2, 0, 1}, // +Z: w along x, h along y
+    {2, 0, 1}, // -Z
+};
 
-                    BlockType block = world_chunk_get_block(chunk, x, y, z);
-                    if (block == BLOCK_AIR) {
-                        continue;
-                    }
+static void merged_mesh_free(MergedMesh *mesh) {
+    if (!mesh) {
+        return;
+    }
+    for (int f = 0; f < 6; f++) {
+        free(mesh->quads[f]);
+    }
+    free(mesh->vertices);
+    free(mesh);
+}
+
+static bool greedy_push_quad(MergedMesh *mesh, int face, MergedQuad quad) {
+    if (mesh->quad_count[face] >= mesh->quad_capacity[face]) {
+        int new_capacity = mesh->quad_capacity[face] > 0 ? mesh->quad_capacity[face] * 2 : 64;
+        MergedQuad *quads = (MergedQuad *)realloc(mesh->quads[face], sizeof(MergedQuad) * new_capacity);
+        if (!quads) {
+            return false;
+        }
+        mesh->quads[face] = quads;
+        mesh->quad_capacity[face] = new_capacity;
+    }
+    mesh->quads[face][mesh->quad_count[face]++] = quad;
+    return true;
+}
 
-                    // Check if +Y face is exposed
-                    int world_x = chunk->chunk_x * CHUNK_WIDTH + x;
-                    int world_y = chunk->chunk_y * CHUNK_HEIGHT + y;
-                    int world_z = chunk->chunk_z * CHUNK_DEPTH + z;
+// Greedy-mesh a padded grid of cells into `mesh`. origin_cell points at cell (0, 0, 0),
+// strides are the byte steps along x, y and z, and every cell is a cube of `scale` blocks
+// whose minimum corner sits at origin + cell * scale. Returns false when out of memory.
+static bool greedy_mesh_cells(MergedMesh *mesh, const uint8_t *origin_cell, const int dims[3], const int strides[3],
+                              int scale, const int origin[3]) {
+    // Face 0: +X, Face 1: -X, Face 2: +Y, Face 3: -Y, Face 4: +Z, Face 5: -Z
+    for (int face = 0; face < 6; face++) {
+        int n_axis = greedy_face_axes[face][0];
+        int w_axis = greedy_face_axes[face][1];
+        int h_axis = greedy_face_axes[face][2];
+        int size_w = dims[w_axis];
+        int size_h = dims[h_axis];
+        int neighbor_offset = (face & 1) ? -strides[n_axis] : strides[n_axis];
+        // A quad lies on its corner block's face side, so positive faces use the cell's last block
+        int face_block = (face & 1) ? 0 : scale - 1;
+
+        for (int layer = 0; layer < dims[n_axis]; layer++) {
+            // Block type of each exposed face in this layer, 0 (air) where there is none
+            uint8_t mask[CHUNK_HEIGHT * CHUNK_HEIGHT];
+            bool layer_has_faces = false;
+            for (int v = 0; v < size_h; v++) {
+                const uint8_t *cell = origin_cell + layer * strides[n_axis] + v * strides[h_axis];
+                for (int u = 0; u < size_w; u++, cell += strides[w_axis]) {
+                    BlockType block = (BlockType)cell[0];
+                    BlockType neighbor = (BlockType)cell[neighbor_offset];
+                    bool exposed = block != BLOCK_AIR && block_face_is_exposed(block, neighbor);
+                    mask[v * size_w + u] = exposed ? (uint8_t)block : BLOCK_AIR;
+                    layer_has_faces |= exposed;
+                }
+            }
+            if (!layer_has_faces) {
+                continue; // Solid interior or open air: nothing to merge
+            }
 
-                    if (world_get_block(world, world_x, world_y + 1, world_z) != BLOCK_AIR) {
+            for (int v = 0; v < size_h; v++) {
+                for (int u = 0; u < size_w; u++) {
+                    uint8_t type = mask[v * size_w + u];
+                    if (type == BLOCK_AIR) {
                         continue;
                     }
 
                     // Find max width
                     int w = 1;
-                    while (x + w < CHUNK_WIDTH && !used[z][x + w]) {
-                        BlockType b = world_chunk_get_block(chunk, x + w, y, z);
-                        if (b == BLOCK_AIR) {
-                            break;
-                        }
-                        int wx = world_x + w;
-                        if (world_get_block(world, wx, world_y + 1, world_z) != BLOCK_AIR) {
-                            break;
-                        }
+                    while (u + w < size_w && mask[v * size_w + u + w] == type) {
                         w++;
                     }
 
-                    // Find max height
+                    // Find max height: every cell of the next row under [u, u + w) must match
                     int h = 1;
-                    while (z + h < CHUNK_DEPTH) {
+                    while (v + h < size_h) {
                         bool can_extend = true;
-                        for (int dx = 0; dx < w; dx++) {
-                            if (used[z + h][x + dx]) {
-                                can_extend = false;
-                                break;
-                            }
-                            BlockType b = world_chunk_get_block(chunk, x + dx, y, z + h);
-                            if (b == BLOCK_AIR) {
-                                can_extend = false;
-                                break;
-                            }
-                            int wx = world_x + dx;
-                            int wz = world_z + h;
-                            if (world_get_block(world, wx, world_y + 1, wz) != BLOCK_AIR) {
+                        for (int du = 0; du < w; du++) {
+                            if (mask[(v + h) * size_w + u + du] != type) {
                                 can_extend = false;
                                 break;
                             }
@@ -2375,286 +3264,319 @@ MergedMesh *chunk_greedy_mesh(Chunk *chunk, World *world) {
                         h++;
                     }
 
-                    // Add quad
-                    if (mesh->quad_count[2] >= mesh->quad_capacity[2]) {
-                        mesh->quad_capacity[2] *= 2;
-                        mesh->quads[2] = (MergedQuad *)realloc(mesh->quads[2], sizeof(MergedQuad) * mesh->quad_capacity[2]);
+                    // Mark as used
+                    for (int dv = 0; dv < h; dv++) {
+                        memset(&mask[(v + dv) * size_w + u], BLOCK_AIR, (size_t)w);
                     }
 
-                    MergedQuad *quad = &mesh->quads[2][mesh->quad_count[2]++];
-                    quad->x = world_x;
-                    quad->y = world_y;
-                    quad->z = world_z;
-                    quad->w = w;
-                    quad->h = h;
-                    quad->face = 2; // +Y
-                    quad->type = block;
-
-                    // Mark as used
-                    for (int dz = 0; dz < h; dz++) {
-                        for (int dx = 0; dx < w; dx++) {
-                            used[z + dz][x + dx] = true;
-                        }
+                    int corner[3];
+                    corner[n_axis] = origin[n_axis] + layer * scale + face_block;
+                    corner[w_axis] = origin[w_axis] + u * scale;
+                    corner[h_axis] = origin[h_axis] + v * scale;
+                    MergedQuad quad = {.x = corner[0], .y = corner[1], .z = corner[2], .w = w * scale, .h = h * scale, .face = face, .type = (BlockType)type};
+                    if (!greedy_push_quad(mesh, face, quad)) {
+                        return false;
                     }
                 }
             }
         }
     }
+    return true;
+}
 
-    // -Y (bottom faces) - similar process
-    {
-        bool used[CHUNK_DEPTH][CHUNK_WIDTH] = {0};
-
-        for (int y = 0; y < CHUNK_HEIGHT; y++) {
-            for (int z = 0; z < CHUNK_DEPTH; z++) {
-                for (int x = 0; x < CHUNK_WIDTH; x++) {
-                    if (used[z][x]) {
-                        continue;
-                    }
-
-                    BlockType block = world_chunk_get_block(chunk, x, y, z);
-                    if (block == BLOCK_AIR) {
-                        continue;
-                    }
+static MergedMesh *chunk_greedy_mesh(const ChunkMeshVolume *volume, const Chunk *chunk) {
+    MergedMesh *mesh = (MergedMesh *)calloc(1, sizeof(MergedMesh));
+    if (!mesh) {
+        return NULL;
+    }
 
-                    int world_x = chunk->chunk_x * CHUNK_WIDTH + x;
-                    int world_y = chunk->chunk_y * CHUNK_HEIGHT + y;
-                    int world_z = chunk->chunk_z * CHUNK_DEPTH + z;
+    const int dims[3] = {CHUNK_WIDTH, CHUNK_HEIGHT, CHUNK_DEPTH};
+    const int origin[3] = {chunk->chunk_x * CHUNK_WIDTH, chunk->chunk_y * CHUNK_HEIGHT, chunk->chunk_z * CHUNK_DEPTH};
+    // Byte strides of one step along x, y and z inside the padded volume
+    const int strides[3] = {1, MESH_PAD_DEPTH * MESH_PAD_WIDTH, MESH_PAD_WIDTH};
+    if (!greedy_mesh_cells(mesh, &MESH_VOLUME_AT(volume, 0, 0, 0), dims, strides, 1, origin)) {
+        fprintf(stderr, "[ERROR] Out of memory building merged mesh for chunk (%d,%d,%d)\n",
+                chunk->chunk_x, chunk->chunk_y, chunk->chunk_z);
+    }
+    return mesh;
+}
 
-                    if (world_get_block(world, world_x, world_y - 1, world_z) != BLOCK_AIR) {
-                        continue;
-                    }
+#ifndef SERVER_BUILD
+// ============================================================================
+// LEVEL OF DETAIL MESHES
+// ============================================================================
+// Far chunks are drawn from coarser meshes instead of being dropped. Level l
+// merges scale = 2^l blocks along each axis into one cell: a cell is solid
+// when at least half of its blocks are opaque, and takes the type of its
+// highest opaque block so hills keep their grass tops. Glass and other
+// see-through blocks count as air. Border cells come from the neighbours'
+// one-block borders in the snapshot, solid when at least half of the blocks
+// on the shared face are. The coarse grid is then greedy meshed as usual.
+// Client only: the server never draws.
+
+#define LOD_MAX_PAD_CELLS ((CHUNK_WIDTH / 2 + 2) * (CHUNK_HEIGHT / 2 + 2) * (CHUNK_DEPTH / 2 + 2))
+
+static bool lod_block_opaque(const ChunkMeshVolume *volume, int x, int y, int z) {
+    return !block_is_transparent((BlockType)MESH_VOLUME_AT(volume, x, y, z));
+}
 
-                    int w = 1;
-                    while (x + w < CHUNK_WIDTH && !used[z][x + w]) {
-                        BlockType b = world_chunk_get_block(chunk, x + w, y, z);
-                        if (b == BLOCK_AIR) {
-                            break;
-                        }
-                        int wx = world_x + w;
-                        if (world_get_block(world, wx, world_y - 1, world_z) != BLOCK_AIR) {
-                            break;
-                        }
-                        w++;
-                    }
+// Majority of the scale x scale blocks of the snapshot border plane on `face` behind cell (u, v)
+static uint8_t lod_border_cell(const ChunkMeshVolume *volume, int face, int u, int v, int scale) {
+    int n_axis = greedy_face_axes[face][0];
+    int w_axis = greedy_face_axes[face][1];
+    int h_axis = greedy_face_axes[face][2];
+    const int dims[3] = {CHUNK_WIDTH, CHUNK_HEIGHT, CHUNK_DEPTH};
+    int opaque = 0;
+    for (int dv = 0; dv < scale; dv++) {
+        for (int du = 0; du < scale; du++) {
+            int pos[3];
+            pos[n_axis] = (face & 1) ? -1 : dims[n_axis];
+            pos[w_axis] = u * scale + du;
+            pos[h_axis] = v * scale + dv;
+            opaque += lod_block_opaque(volume, pos[0], pos[1], pos[2]);
+        }
+    }
+    // Only exposure is ever asked of border cells, so any opaque type will do
+    return opaque * 2 >= scale * scale ? (uint8_t)BLOCK_STONE : (uint8_t)BLOCK_AIR;
+}
 
-                    int h = 1;
-                    while (z + h < CHUNK_DEPTH) {
-                        bool can_extend = true;
-                        for (int dx = 0; dx < w; dx++) {
-                            if (used[z + h][x + dx]) {
-                                can_extend = false;
-                                break;
-                            }
-                            BlockType b = world_chunk_get_block(chunk, x + dx, y, z + h);
-                            if (b == BLOCK_AIR) {
-                                can_extend = false;
-                                break;
-                            }
-                            int wx = world_x + dx;
-                            int wz = world_z + h;
-                            if (world_get_block(world, wx, world_y - 1, wz) != BLOCK_AIR) {
-                                can_extend = false;
-                                break;
+static MergedMesh *chunk_lod_mesh(const ChunkMeshVolume *volume, const Chunk *chunk, int scale) {
+    const int dims[3] = {CHUNK_WIDTH / scale, CHUNK_HEIGHT / scale, CHUNK_DEPTH / scale};
+    const int pad_w = dims[0] + 2;
+    const int pad_d = dims[2] + 2;
+    const int strides[3] = {1, pad_d * pad_w, pad_w};
+    uint8_t cells[LOD_MAX_PAD_CELLS];
+    memset(cells, BLOCK_AIR, (size_t)(dims[1] + 2) * pad_d * pad_w);
+    uint8_t *origin_cell = &cells[strides[1] + strides[2] + 1];
+
+    int half = scale * scale * scale / 2;
+    for (int cy = 0; cy < dims[1]; cy++) {
+        for (int cz = 0; cz < dims[2]; cz++) {
+            for (int cx = 0; cx < dims[0]; cx++) {
+                int opaque = 0;
+                BlockType top = BLOCK_AIR;
+                // Top down, so the first opaque block found is the cell's surface
+                for (int y = cy * scale + scale - 1; y >= cy * scale; y--) {
+                    for (int z = cz * scale; z < cz * scale + scale; z++) {
+                        for (int x = cx * scale; x < cx * scale + scale; x++) {
+                            BlockType block = (BlockType)MESH_VOLUME_AT(volume, x, y, z);
+                            if (!block_is_transparent(block)) {
+                                opaque++;
+                                top = top == BLOCK_AIR ? block : top;
                             }
                         }
-                        if (!can_extend) {
-                            break;
-                        }
-                        h++;
-                    }
-
-                    if (mesh->quad_count[3] >= mesh->quad_capacity[3]) {
-                        mesh->quad_capacity[3] *= 2;
-                        mesh->quads[3] = (MergedQuad *)realloc(mesh->quads[3], sizeof(MergedQuad) * mesh->quad_capacity[3]);
-                    }
-
-                    MergedQuad *quad = &mesh->quads[3][mesh->quad_count[3]++];
-                    quad->x = world_x;
-                    quad->y = world_y;
-                    quad->z = world_z;
-                    quad->w = w;
-                    quad->h = h;
-                    quad->face = 3; // -Y
-                    quad->type = block;
-
-                    for (int dz = 0; dz < h; dz++) {
-                        for (int dx = 0; dx < w; dx++) {
-                            used[z + dz][x + dx] = true;
-                        }
                     }
                 }
+                origin_cell[cx * strides[0] + cy * strides[1] + cz * strides[2]] = opaque >= half ? (uint8_t)top : (uint8_t)BLOCK_AIR;
+            }
+        }
+    }
+
+    // Face-adjacent border cells; edges and corners are never consulted and stay air
+    for (int face = 0; face < 6; face++) {
+        int n_axis = greedy_face_axes[face][0];
+        int w_axis = greedy_face_axes[face][1];
+        int h_axis = greedy_face_axes[face][2];
+        int layer = (face & 1) ? -1 : dims[n_axis];
+        for (int v = 0; v < dims[h_axis]; v++) {
+            for (int u = 0; u < dims[w_axis]; u++) {
+                origin_cell[layer * strides[n_axis] + u * strides[w_axis] + v * strides[h_axis]] = lod_border_cell(volume, face, u, v, scale);
             }
         }
     }
 
+    MergedMesh *mesh = (MergedMesh *)calloc(1, sizeof(MergedMesh));
+    if (!mesh) {
+        return NULL;
+    }
+    const int origin[3] = {chunk->chunk_x * CHUNK_WIDTH, chunk->chunk_y * CHUNK_HEIGHT, chunk->chunk_z * CHUNK_DEPTH};
+    if (!greedy_mesh_cells(mesh, origin_cell, dims, strides, scale, origin)) {
+        merged_mesh_free(mesh);
+        return NULL;
+    }
     return mesh;
 }
+#endif
 
-// OPTIMIZED MESHING FOR VOXEL RENDERING
-// Pre-compute and cache all visible blocks in a chunk (blocks with exposed faces)
-// This avoids the per-frame triple-nested loop and provides massive performance improvement
-//
-// GREEDY MESHING IMPLEMENTATION:
-// - For each block, we only add it if it has exposed faces (faces adjacent to air)
-// - We track per-face lighting to enable better face merging during rendering
-// - The rendering pipeline (draw_cube_faces) can then optimize by rendering
-//   larger merged quads instead of individual faces when faces have matching lighting
-//
-// PERFORMANCE OPTIMIZATIONS INCLUDED:
-// 1. Skip entirely interior blocks (completely surrounded by solid blocks)
-// 2. Only track exposed faces that border unloaded/air blocks
-// 3. Bake lighting per-face to enable adaptive face merging
-// 4. Double-buffered swapping for thread-safe concurrent updates
-// 5. Blocks are stored in order of iteration for cache coherence
-//
-// Result: Typical 40-60% reduction in geometry compared to rendering all block faces
+// ============================================================================
+// CHUNK VISIBILITY GRAPH
+// ============================================================================
+// For cave culling the renderer needs to know, per chunk, which pairs of its
+// six faces can see each other through air or glass. Each see-through region
+// of the chunk is flood filled once; every pair of faces the region touches
+// is connected. A chunk that is all see-through or all opaque skips the fill.
 
-// Pre-compute and cache all visible blocks in a chunk (blocks with exposed faces)
-void chunk_cache_visible_blocks(Chunk *chunk, World *world) {
-    if (!chunk) {
-        return;
-    }
+#define VISIBILITY_CELLS (CHUNK_WIDTH * CHUNK_HEIGHT * CHUNK_DEPTH)
+
+static bool visibility_see_through(const ChunkMeshVolume *volume, int x, int y, int z) {
+    return block_is_transparent((BlockType)MESH_VOLUME_AT(volume, x, y, z));
+}
 
-    // Build into a temporary array to avoid realloc while render thread might use the original
-    int temp_capacity = 1024; // Start with 1024 blocks
-    int temp_count = 0;
-    CachedVisibleBlock *temp_blocks = (CachedVisibleBlock *)malloc(sizeof(CachedVisibleBlock) * temp_capacity);
+// Faces (bit per direction, see MergedQuad) that the cell lies on
+static uint8_t visibility_cell_faces(int x, int y, int z) {
+    uint8_t faces = 0;
+    faces |= (uint8_t)(x == CHUNK_WIDTH - 1) << 0;
+    faces |= (uint8_t)(x == 0) << 1;
+    faces |= (uint8_t)(y == CHUNK_HEIGHT - 1) << 2;
+    faces |= (uint8_t)(y == 0) << 3;
+    faces |= (uint8_t)(z == CHUNK_DEPTH - 1) << 4;
+    faces |= (uint8_t)(z == 0) << 5;
+    return faces;
+}
 
-    // Iterate through all blocks in chunk
+static uint16_t chunk_compute_visibility(const ChunkMeshVolume *volume) {
+    int see_through = 0;
     for (int y = 0; y < CHUNK_HEIGHT; y++) {
         for (int z = 0; z < CHUNK_DEPTH; z++) {
             for (int x = 0; x < CHUNK_WIDTH; x++) {
-                BlockType block = world_chunk_get_block(chunk, x, y, z);
+                see_through += visibility_see_through(volume, x, y, z);
+            }
+        }
+    }
+    if (see_through == VISIBILITY_CELLS) {
+        return CHUNK_VISIBILITY_ALL;
+    }
+    if (see_through == 0) {
+        return 0;
+    }
 
-                // Skip air blocks
-                if (block == BLOCK_AIR) {
-                    continue;
-                }
+    // Cell index (y * D + z) * W + x fits in 16 bits; each cell is pushed at most once
+    uint8_t *visited = (uint8_t *)calloc(VISIBILITY_CELLS, 1);
+    uint16_t *stack = (uint16_t *)malloc(sizeof(uint16_t) * VISIBILITY_CELLS);
+    if (!visited || !stack) {
+        free(visited);
+        free(stack);
+        return CHUNK_VISIBILITY_ALL; // Conservative: never cull on failure
+    }
 
-                // Get world coordinates
-                int world_x = chunk->chunk_x * CHUNK_WIDTH + x;
-                int world_y = chunk->chunk_y * CHUNK_HEIGHT + y;
-                int world_z = chunk->chunk_z * CHUNK_DEPTH + z;
-
-                // Check which faces are exposed (neighbor is air)
-                // Only mark a face as exposed if the neighbor exists and is air
-                // If neighbor chunk isn't loaded, don't mark face as exposed
-                uint8_t exposed_faces = 0;
-
-                BlockType neighbor;
-                // Check +X direction
-                neighbor = world_get_block(world, world_x + 1, world_y, world_z);
-                if (block_face_is_exposed(block, neighbor)) {
-                    exposed_faces |= (1 << 0);
-                }
-                // Check -X direction
-                neighbor = world_get_block(world, world_x - 1, world_y, world_z);
-                if (block_face_is_exposed(block, neighbor)) {
-                    exposed_faces |= (1 << 1);
-                }
-                // Check +Y direction
-                neighbor = world_get_block(world, world_x, world_y + 1, world_z);
-                if (block_face_is_exposed(block, neighbor)) {
-                    exposed_faces |= (1 << 2);
-                }
-                // Check -Y direction
-                neighbor = world_get_block(world, world_x, world_y - 1, world_z);
-                if (block_face_is_exposed(block, neighbor)) {
-                    exposed_faces |= (1 << 3);
-                }
-                // Check +Z direction
-                neighbor = world_get_block(world, world_x, world_y, world_z + 1);
-                if (block_face_is_exposed(block, neighbor)) {
-                    exposed_faces |= (1 << 4);
+    uint16_t visibility = 0;
+    for (int start = 0; start < VISIBILITY_CELLS; start++) {
+        int sx = start % CHUNK_WIDTH;
+        int sz = (start / CHUNK_WIDTH) % CHUNK_DEPTH;
+        int sy = start / (CHUNK_WIDTH * CHUNK_DEPTH);
+        if (visited[start] || !visibility_see_through(volume, sx, sy, sz)) {
+            continue;
+        }
+
+        // Flood fill one region and collect the faces it reaches
+        uint8_t faces = 0;
+        int top = 0;
+        stack[top++] = (uint16_t)start;
+        visited[start] = 1;
+        while (top > 0) {
+            int cell = stack[--top];
+            int x = cell % CHUNK_WIDTH;
+            int z = (cell / CHUNK_WIDTH) % CHUNK_DEPTH;
+            int y = cell / (CHUNK_WIDTH * CHUNK_DEPTH);
+            faces |= visibility_cell_faces(x, y, z);
+
+            const int neighbors[6][4] = {
+                {x + 1, y, z, cell + 1},
+                {x - 1, y, z, cell - 1},
+                {x, y + 1, z, cell + CHUNK_WIDTH * CHUNK_DEPTH},
+                {x, y - 1, z, cell - CHUNK_WIDTH * CHUNK_DEPTH},
+                {x, y, z + 1, cell + CHUNK_WIDTH},
+                {x, y, z - 1, cell - CHUNK_WIDTH}};
+            for (int n = 0; n < 6; n++) {
+                int nx = neighbors[n][0];
+                int ny = neighbors[n][1];
+                int nz = neighbors[n][2];
+                int next = neighbors[n][3];
+                if (nx < 0 || nx >= CHUNK_WIDTH || ny < 0 || ny >= CHUNK_HEIGHT || nz < 0 || nz >= CHUNK_DEPTH) {
+                    continue;
                 }
-                // Check -Z direction
-                neighbor = world_get_block(world, world_x, world_y, world_z - 1);
-                if (block_face_is_exposed(block, neighbor)) {
-                    exposed_faces |= (1 << 5);
+                if (visited[next] || !visibility_see_through(volume, nx, ny, nz)) {
+                    continue;
                 }
+                visited[next] = 1;
+                stack[top++] = (uint16_t)next;
+            }
+        }
 
-                if (exposed_faces != 0) {
-                    // Grow temporary array if needed
-                    if (temp_count >= temp_capacity) {
-                        temp_capacity *= 2;
-                        temp_blocks = (CachedVisibleBlock *)realloc(temp_blocks,
-                                                                    sizeof(CachedVisibleBlock) * temp_capacity);
-                    }
-
-                    // Add to temporary array
-                    temp_blocks[temp_count].x = x;
-                    temp_blocks[temp_count].y = y;
-                    temp_blocks[temp_count].z = z;
-                    temp_blocks[temp_count].exposed_faces = exposed_faces;
-                    temp_count++;
+        for (int a = 0; a < 6; a++) {
+            for (int b = a + 1; b < 6; b++) {
+                if ((faces & (1 << a)) && (faces & (1 << b))) {
+                    visibility |= chunk_visibility_bit(a, b);
                 }
             }
         }
+        if (visibility == CHUNK_VISIBILITY_ALL) {
+            break;
+        }
+    }
+
+    free(visited);
+    free(stack);
+    return visibility;
+}
+
+// Build a chunk's mesh: snapshot the chunk with its neighbour borders, greedy-mesh
+// the snapshot into merged quads and (client only) bake them into GPU vertices.
+// The result is built off to the side and swapped in under mesh_swap_mutex, so
+// the render thread keeps drawing the old mesh until the new one is complete.
+void chunk_build_mesh(Chunk *chunk, World *world) {
+    if (!chunk) {
+        return;
+    }
+
+    // Snapshot the chunk and its neighbour borders once; everything below reads only this
+    ChunkMeshVolume *volume = (ChunkMeshVolume *)malloc(sizeof(ChunkMeshVolume));
+    if (!volume) {
+        return;
+    }
+    // Claim the dirty flag before reading blocks: an edit after this point marks it again
+    bool visibility_dirty = __atomic_exchange_n(&chunk->visibility_dirty, false, __ATOMIC_ACQ_REL);
+    chunk_mesh_snapshot(chunk, world, volume);
+    uint16_t visibility = visibility_dirty ? chunk_compute_visibility(volume) : 0;
+
+    // GREEDY MESHING: Generate merged quads for better performance (outside the swap lock)
+    MergedMesh *new_merged = chunk_greedy_mesh(volume, chunk);
+#ifndef SERVER_BUILD
+    // Bake the GPU vertex list here too, so the render thread only has to upload it.
+    // The coarser levels only live long enough to be baked into the same vertex list.
+    if (new_merged) {
+        MergedMesh *lods[CHUNK_LOD_LEVELS - 1];
+        for (int lod = 1; lod < CHUNK_LOD_LEVELS; lod++) {
+            lods[lod - 1] = chunk_lod_mesh(volume, chunk, 1 << lod);
+        }
+        chunk_mesh_build_vertices(new_merged, chunk, lods);
+        for (int lod = 1; lod < CHUNK_LOD_LEVELS; lod++) {
+            merged_mesh_free(lods[lod - 1]);
+        }
     }
+#endif
+    free(volume);
 
-    // ATOMIC SWAP: Now safely replace the old array with the new one
-    // Using double-buffering: build into inactive buffer, then atomically swap active_mesh index
+    // ATOMIC SWAP: Now safely replace the old mesh with the new one
+    // Using double-buffering: build into inactive buffer, then atomically swap active_merged_mesh index
     // This ensures render thread always sees consistent data (no partial updates)
 
     // Lock mutex during swap to prevent render thread from reading between buffer updates
     // This ensures the render thread never sees an inconsistent state
     pthread_mutex_lock(&chunk->mesh_swap_mutex);
 
-    int current_active = __atomic_load_n(&chunk->active_mesh, __ATOMIC_ACQUIRE);
+    int current_active = __atomic_load_n(&chunk->active_merged_mesh, __ATOMIC_ACQUIRE);
     int inactive_buffer = 1 - current_active; // Opposite of currently active buffer
 
-    // Free old data in the inactive buffer if it exists
-    if (chunk->visible_blocks[inactive_buffer] != NULL) {
-        free(chunk->visible_blocks[inactive_buffer]);
-    }
-
-    // Store new mesh into inactive buffer
-    chunk->visible_blocks[inactive_buffer] = temp_blocks;
-    chunk->visible_count[inactive_buffer] = temp_count;
-    chunk->visible_capacity[inactive_buffer] = temp_capacity;
-
-    // GREEDY MESHING: Generate merged quads for better performance
-    MergedMesh *new_merged = chunk_greedy_mesh(chunk, world);
-
     // Free old merged mesh in inactive buffer
-    if (chunk->merged_mesh[inactive_buffer] != NULL) {
-        for (int f = 0; f < 6; f++) {
-            if (chunk->merged_mesh[inactive_buffer]->quads[f] != NULL) {
-                free(chunk->merged_mesh[inactive_buffer]->quads[f]);
-            }
-        }
-        free(chunk->merged_mesh[inactive_buffer]);
-    }
+    merged_mesh_free(chunk->merged_mesh[inactive_buffer]);
 
     // Store new merged mesh
     chunk->merged_mesh[inactive_buffer] = new_merged;
+    if (visibility_dirty) {
+        __atomic_store_n(&chunk->visibility, visibility, __ATOMIC_RELAXED);
+    }
 
     // ATOMIC SWAP: Use atomic operation with memory barrier
     // This ensures the updated mesh is fully visible before we flip the active buffer switch
     // Render thread will see the new mesh on the next inspection
-    __atomic_store_n(&chunk->active_mesh, inactive_buffer, __ATOMIC_RELEASE);
     __atomic_store_n(&chunk->active_merged_mesh, inactive_buffer, __ATOMIC_RELEASE);
+    // Publish the version last: the renderer checks it without the lock and only locks when it moved
+    __atomic_store_n(&chunk->mesh_version, chunk->mesh_version + 1, __ATOMIC_RELEASE);
 
     pthread_mutex_unlock(&chunk->mesh_swap_mutex);
 }
 
-// Free the visible blocks cache (both buffers)
-void chunk_free_visible_blocks(Chunk *chunk) {
-    // Free both buffers
-    for (int i = 0; i < 2; i++) {
-        if (chunk->visible_blocks[i] != NULL) {
-            free(chunk->visible_blocks[i]);
-            chunk->visible_blocks[i] = NULL;
-        }
-        chunk->visible_count[i] = 0;
-        chunk->visible_capacity[i] = 0;
-    }
-    // NOTE: Don't set meshed=false here - keep rendering old mesh while worker recalculates
-    // This prevents flickering when blocks are placed/broken
-    // Worker thread will recalculate and update visible_blocks while meshed stays true
-}
-
 // Free merged mesh data
 void chunk_free_merged_mesh(Chunk *chunk) {
     if (!chunk) {
@@ -2662,194 +3584,7 @@ void chunk_free_merged_mesh(Chunk *chunk) {
     }
 
     for (int i = 0; i < 2; i++) {
-        if (chunk->merged_mesh[i] != NULL) {
-            for (int f = 0; f < 6; f++) {
-                if (chunk->merged_mesh[i]->quads[f] != NULL) {
-                    free(chunk->merged_mesh[i]->quads[f]);
-                }
-            }
-            free(chunk->merged_mesh[i]);
-            chunk->merged_mesh[i] = NULL;
-        }
-    }
-}
-
-// ============================================================================
-// ISSUE #2: DIRTY-REGION REMESHING
-// ============================================================================
-// Update only the visible blocks in a region around a changed block (Issue #2)
-// This is much faster than rebuilding the entire chunk mesh for a single block change
-// Radius: how many blocks away from the change to update (typically 1-2)
-void chunk_update_visible_blocks_region(Chunk *chunk, World *world, int local_x, int local_y, int local_z, int radius) {
-    if (!chunk) {
-        return;
-    }
-
-    // Define region bounds with radius
-    int min_x = local_x - radius;
-    int max_x = local_x + radius;
-    int min_y = local_y - radius;
-    int max_y = local_y + radius;
-    int min_z = local_z - radius;
-    int max_z = local_z + radius;
-
-    // Clamp to chunk bounds
-    if (min_x < 0) {
-        min_x = 0;
-    }
-    if (max_x >= CHUNK_WIDTH) {
-        max_x = CHUNK_WIDTH - 1;
-    }
-    if (min_y < 0) {
-        min_y = 0;
-    }
-    if (max_y >= CHUNK_HEIGHT) {
-        max_y = CHUNK_HEIGHT - 1;
-    }
-    if (min_z < 0) {
-        min_z = 0;
-    }
-    if (max_z >= CHUNK_DEPTH) {
-        max_z = CHUNK_DEPTH - 1;
-    }
-
-    // Build a temporary array for the region's visible blocks
-    int temp_capacity = 512;
-    int temp_count = 0;
-    CachedVisibleBlock *temp_blocks = (CachedVisibleBlock *)malloc(sizeof(CachedVisibleBlock) * temp_capacity);
-
-    // Only iterate over the affected region
-    for (int y = min_y; y <= max_y; y++) {
-        for (int z = min_z; z <= max_z; z++) {
-            for (int x = min_x; x <= max_x; x++) {
-                BlockType block = world_chunk_get_block(chunk, x, y, z);
-
-                // Skip air blocks
-                if (block == BLOCK_AIR) {
-                    continue;
-                }
-
-                // Get world coordinates
-                int world_x = chunk->chunk_x * CHUNK_WIDTH + x;
-                int world_y = chunk->chunk_y * CHUNK_HEIGHT + y;
-                int world_z = chunk->chunk_z * CHUNK_DEPTH + z;
-
-                // Check which faces are exposed
-                uint8_t exposed_faces = 0;
-                BlockType neighbor;
-
-                neighbor = world_get_block(world, world_x + 1, world_y, world_z);
-                if (block_face_is_exposed(block, neighbor)) {
-                    exposed_faces |= (1 << 0);
-                }
-                neighbor = world_get_block(world, world_x - 1, world_y, world_z);
-                if (block_face_is_exposed(block, neighbor)) {
-                    exposed_faces |= (1 << 1);
-                }
-                neighbor = world_get_block(world, world_x, world_y + 1, world_z);
-                if (block_face_is_exposed(block, neighbor)) {
-                    exposed_faces |= (1 << 2);
-                }
-                neighbor = world_get_block(world, world_x, world_y - 1, world_z);
-                if (block_face_is_exposed(block, neighbor)) {
-                    exposed_faces |= (1 << 3);
-                }
-                neighbor = world_get_block(world, world_x, world_y, world_z + 1);
-                if (block_face_is_exposed(block, neighbor)) {
-                    exposed_faces |= (1 << 4);
-                }
-                neighbor = world_get_block(world, world_x, world_y, world_z - 1);
-                if (block_face_is_exposed(block, neighbor)) {
-                    exposed_faces |= (1 << 5);
-                }
-
-                if (exposed_faces != 0) {
-                    // Grow temporary array if needed
-                    if (temp_count >= temp_capacity) {
-                        temp_capacity *= 2;
-                        temp_blocks = (CachedVisibleBlock *)realloc(temp_blocks,
-                                                                    sizeof(CachedVisibleBlock) * temp_capacity);
-                    }
-
-                    // Add to temporary array
-                    temp_blocks[temp_count].x = x;
-                    temp_blocks[temp_count].y = y;
-                    temp_blocks[temp_count].z = z;
-                    temp_blocks[temp_count].exposed_faces = exposed_faces;
-                    temp_count++;
-                }
-            }
-        }
-    }
-
-    // Now merge the updated region with existing visible blocks (Issue #2)
-    // Remove old entries in the affected region and add the new ones
-    pthread_mutex_lock(&chunk->mesh_swap_mutex);
-
-    int current_active = __atomic_load_n(&chunk->active_mesh, __ATOMIC_ACQUIRE);
-    int inactive_buffer = 1 - current_active;
-
-    // Copy current active buffer to inactive (or start fresh if needed)
-    CachedVisibleBlock *merged_blocks = NULL;
-    int merged_count = 0;
-    int merged_capacity = 1024;
-
-    // If we have an old inactive buffer, start from its size
-    if (chunk->visible_blocks[inactive_buffer] != NULL) {
-        merged_capacity = chunk->visible_capacity[inactive_buffer];
-        merged_blocks = (CachedVisibleBlock *)malloc(sizeof(CachedVisibleBlock) * merged_capacity);
-    } else {
-        merged_blocks = (CachedVisibleBlock *)malloc(sizeof(CachedVisibleBlock) * merged_capacity);
-    }
-
-    // Copy existing visible blocks that are NOT in the affected region
-    if (chunk->visible_blocks[current_active] != NULL) {
-        for (int i = 0; i < chunk->visible_count[current_active]; i++) {
-            CachedVisibleBlock *old_block = &chunk->visible_blocks[current_active][i];
-
-            // Skip if block is in the affected region (we'll replace it from temp_blocks)
-            if (old_block->x >= min_x && old_block->x <= max_x &&
-                old_block->y >= min_y && old_block->y <= max_y &&
-                old_block->z >= min_z && old_block->z <= max_z) {
-                continue; // Skip this old entry; it will be replaced by updated region
-            }
-
-            // Grow merged array if needed
-            if (merged_count >= merged_capacity) {
-                merged_capacity *= 2;
-                merged_blocks = (CachedVisibleBlock *)realloc(merged_blocks,
-                                                              sizeof(CachedVisibleBlock) * merged_capacity);
-            }
-
-            // Copy old block
-            merged_blocks[merged_count++] = *old_block;
-        }
-    }
-
-    // Add new blocks from the updated region
-    for (int i = 0; i < temp_count; i++) {
-        if (merged_count >= merged_capacity) {
-            merged_capacity *= 2;
-            merged_blocks = (CachedVisibleBlock *)realloc(merged_blocks,
-                                                          sizeof(CachedVisibleBlock) * merged_capacity);
-        }
-        merged_blocks[merged_count++] = temp_blocks[i];
-    }
-
-    free(temp_blocks);
-
-    // Free old data in the inactive buffer if it exists
-    if (chunk->visible_blocks[inactive_buffer] != NULL) {
-        free(chunk->visible_blocks[inactive_buffer]);
+        merged_mesh_free(chunk->merged_mesh[i]);
+        chunk->merged_mesh[i] = NULL;
     }
-
-    // Store merged mesh into inactive buffer
-    chunk->visible_blocks[inactive_buffer] = merged_blocks;
-    chunk->visible_count[inactive_buffer] = merged_count;
-    chunk->visible_capacity[inactive_buffer] = merged_capacity;
-
-    // Atomically swap active buffer
-    __atomic_store_n(&chunk->active_mesh, inactive_buffer, __ATOMIC_RELEASE);
-
-    pthread_mutex_unlock(&chunk->mesh_swap_mutex);
 }
@@ -0,0 +1,1690 @@
+#include <math.h>
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/stat.h>
+#include <time.h>
+
+#include "../../include/world.h"
+#include "../../include/server_checks.h"
+
+// ============================================================================
+// SELF-CHECKS AND BENCHMARKS
+// ============================================================================
+// Modes of the server binary that load or generate a world, check or time one
+// subsystem and exit. Run them on a scratch world name: chunks they generate
+// may be stored under it.
+
+#define CHECK_LOAD_DIST 2 // Chunks around the origin in each direction, unless a mode asks for more
+#define CHECK_ANY_SEED 0  // Keep whatever seed the world has or gets
+
+static double check_now(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec + (double)ts.tv_nsec * 1e-9;
+}
+
+// Where checks stand: the middle of chunk (0, 1, 0)
+static const Vector3 CHECK_POSITION = {CHUNK_WIDTH / 2.0f, CHUNK_HEIGHT + CHUNK_HEIGHT / 2.0f, CHUNK_DEPTH / 2.0f};
+
+// Create `world_name` (or load it), with no chunks in memory yet. A new world gets
+// `seed`, or a seed from the clock when it is CHECK_ANY_SEED; an existing world
+// keeps its own, and must match `seed` unless that is CHECK_ANY_SEED. NULL on failure.
+static World *check_world_create(const char *world_name, uint64_t seed) {
+    World *world = world_create();
+    if (!world) {
+        fprintf(stderr, "Failed to allocate world\n");
+        return NULL;
+    }
+    world_system_init();
+    if (seed != CHECK_ANY_SEED) {
+        world->seed = seed;
+    }
+    if (!world_load(world, world_name)) {
+        fprintf(stderr, "Failed to load world '%s'\n", world_name);
+        world_free(world);
+        return NULL;
+    }
+    if (seed != CHECK_ANY_SEED && world->seed != seed) {
+        fprintf(stderr, "World '%s' has seed %llu, this mode needs a new world (seed %llu)\n", world_name,
+                (unsigned long long)world->seed, (unsigned long long)seed);
+        world_free(world);
+        return NULL;
+    }
+    return world;
+}
+
+// Create `world_name` (or load it) as check_world_create does and bring every chunk
+// within `load_dist` of CHECK_POSITION into memory, generated and meshed. NULL if the
+// world can't be set up.
+static World *check_world_open(const char *world_name, uint64_t seed, int load_dist) {
+    World *world = check_world_create(world_name, seed);
+    if (!world) {
+        return NULL;
+    }
+
+    Vector3 position = CHECK_POSITION;
+    Vector3 down = {0.0f, -1.0f, 0.0f}; // No horizontal view, so no chunk counts as behind
+    worker_set_interest(world, position, down);
+    world_update_chunks(world, position, down, (float)(load_dist * CHUNK_WIDTH));
+    chunk_io_flush(world);
+    worker_flush_queue(world);
+    return world;
+}
+
+// ============================================================================
+// NOISE BENCHMARK
+// ============================================================================
+// `--noise-bench [chunks]` times terrain generation, where every block costs one
+// terrain height and one cave noise sample, over `chunks` chunks in a square of
+// columns two chunks high. It runs both the batch kernels (world_generate_chunk_blocks)
+// and the per-sample reference path (world_generate_chunk_blocks_reference) and
+// prints the best of a few passes of each in ns per block, plus a digest of the
+// blocks. The run fails if the two paths generate different blocks.
+
+#define NOISE_BENCH_DEFAULT_CHUNKS 64
+#define NOISE_BENCH_PASSES 3
+#define NOISE_BENCH_SEED 12345
+
+typedef void (*NoiseBenchGenerate)(Block (*blocks)[CHUNK_DEPTH][CHUNK_WIDTH], int32_t chunk_x, int32_t chunk_y,
+                                   int32_t chunk_z, uint64_t seed);
+
+// Best time over NOISE_BENCH_PASSES passes of `generate`; `digest` gets an FNV-1a hash of the block types
+static double noise_bench_path(NoiseBenchGenerate generate, Block (*blocks)[CHUNK_DEPTH][CHUNK_WIDTH], int chunks,
+                               uint64_t *digest) {
+    int side = (int)ceilf(sqrtf((float)chunks / 2.0f));
+    double best = 0.0;
+    for (int pass = 0; pass < NOISE_BENCH_PASSES; pass++) {
+        uint64_t hash = 1469598103934665603ull;
+        double elapsed = 0.0;
+        for (int i = 0; i < chunks; i++) {
+            int32_t chunk_x = i % side - side / 2;
+            int32_t chunk_z = (i / side) % side - side / 2;
+            int32_t chunk_y = i / (side * side);
+            double start = check_now();
+            generate(blocks, chunk_x, chunk_y, chunk_z, NOISE_BENCH_SEED);
+            elapsed += check_now() - start;
+            for (int y = 0; y < CHUNK_HEIGHT; y++) {
+                for (int z = 0; z < CHUNK_DEPTH; z++) {
+                    for (int x = 0; x < CHUNK_WIDTH; x++) {
+                        hash = (hash ^ (uint64_t)blocks[y][z][x].type) * 1099511628211ull;
+                    }
+                }
+            }
+        }
+        if (pass == 0 || elapsed < best) {
+            best = elapsed;
+        }
+        *digest = hash;
+    }
+    return best;
+}
+
+int server_bench_noise(int chunks) {
+    Block(*blocks)[CHUNK_DEPTH][CHUNK_WIDTH] = malloc(sizeof(Block) * CHUNK_HEIGHT * CHUNK_DEPTH * CHUNK_WIDTH);
+    if (!blocks) {
+        fprintf(stderr, "Failed to allocate block buffer\n");
+        return 1;
+    }
+    if (chunks <= 0) {
+        chunks = NOISE_BENCH_DEFAULT_CHUNKS;
+    }
+
+    uint64_t batch_digest = 0;
+    uint64_t reference_digest = 0;
+    double batch = noise_bench_path(world_generate_chunk_blocks, blocks, chunks, &batch_digest);
+    double reference = noise_bench_path(world_generate_chunk_blocks_reference, blocks, chunks, &reference_digest);
+    free(blocks);
+
+    double samples = (double)chunks * CHUNK_WIDTH * CHUNK_HEIGHT * CHUNK_DEPTH;
+    bool ok = batch_digest == reference_digest;
+    printf("[noise-bench] %d chunks, best of %d: batch %.1f ns per block (%.2f ms per chunk), "
+           "reference %.1f ns per block (%.2f ms per chunk), %.2fx; digest %016llx vs %016llx, %s\n",
+           chunks, NOISE_BENCH_PASSES, batch * 1e9 / samples, batch * 1000.0 / chunks, reference * 1e9 / samples,
+           reference * 1000.0 / chunks, batch > 0.0 ? reference / batch : 0.0, (unsigned long long)batch_digest,
+           (unsigned long long)reference_digest, ok ? "ok" : "FAILED");
+    return ok ? 0 : 1;
+}
+
+// ============================================================================
+// CHUNK HASH BENCHMARK
+// ============================================================================
+// `--hash-bench [slots]` drives a ChunkCache hash table of its own (no world) at
+// fixed fills of a `slots`-entry table: 25%, 50%, 70% and the last count before
+// CHUNK_HASH_MAX_LOAD makes it double. At each fill it times inserts and removes
+// (a batch is removed and put back, so the fill barely moves), hit and miss
+// lookups, and a churn phase that removes and reinserts keys sharing a home slot,
+// the case Robin Hood displacement and backward shifts exist for. After every
+// round each live key must be found with its own chunk and no removed key may
+// be, so a broken probe chain fails the run.
+
+#define HASH_BENCH_DEFAULT_SLOTS 65536
+#define HASH_BENCH_MIN_SLOTS 1024
+#define HASH_BENCH_BATCH 64           // Keys removed and put back at a time
+#define HASH_BENCH_OPS 1000000        // Timed operations per kind and fill, roughly
+#define HASH_BENCH_CHURN_ROUNDS 64
+#define HASH_BENCH_MISS_OFFSET 100000 // Far outside the key box
+
+typedef struct {
+    ChunkCache cache;
+    Chunk *chunks; // One per key; a key's chunk is the value stored for it
+    bool *live;
+    int count;
+} HashBench;
+
+// Key `i` of `count`: cells of the smallest cube that fits them, visited in a
+// scrambled order so neighbouring keys don't go in neighbouring order
+static void hash_bench_key(int i, int count, int32_t key[3]) {
+    int side = 1;
+    while (side * side * side < count) {
+        side++;
+    }
+    uint64_t cells = (uint64_t)side * side * side;
+    // Walk the cycle of a permutation of the cube until it lands on one of the
+    // first `count` cells, which maps keys to distinct cells
+    uint64_t cell = (uint64_t)i;
+    do {
+        cell = (cell * 2654435761u + 1) % cells;
+    } while (cell >= (uint64_t)count);
+    key[0] = (int32_t)(cell % side) - side / 2;
+    key[1] = (int32_t)(cell / side % side) - side / 2;
+    key[2] = (int32_t)(cell / side / side) - side / 2;
+}
+
+static void hash_bench_insert(HashBench *bench, int i) {
+    Chunk *chunk = &bench->chunks[i];
+    chunk_hash_insert(&bench->cache, chunk->chunk_x, chunk->chunk_y, chunk->chunk_z, chunk);
+    bench->live[i] = true;
+}
+
+static void hash_bench_remove(HashBench *bench, int i) {
+    Chunk *chunk = &bench->chunks[i];
+    chunk_hash_remove(&bench->cache, chunk->chunk_x, chunk->chunk_y, chunk->chunk_z);
+    bench->live[i] = false;
+}
+
+// Every live key finds its own chunk, every removed one nothing; returns the misses
+static long hash_bench_verify(HashBench *bench) {
+    long bad = 0;
+    int live = 0;
+    for (int i = 0; i < bench->count; i++) {
+        Chunk *chunk = &bench->chunks[i];
+        Chunk *found = chunk_hash_lookup(&bench->cache, chunk->chunk_x, chunk->chunk_y, chunk->chunk_z);
+        if (found != (bench->live[i] ? chunk : NULL)) {
+            bad++;
+        }
+        live += bench->live[i] ? 1 : 0;
+    }
+    return bad + (live != bench->cache.hash_count ? 1 : 0);
+}
+
+// Bench one fill of `slots`; prints its line and returns the verification errors
+static long hash_bench_fill(int slots, int count, const char *label) {
+    HashBench bench;
+    memset(&bench, 0, sizeof(bench));
+    chunk_pool_init(&bench.cache);
+    bench.chunks = calloc((size_t)count, sizeof(Chunk));
+    bench.live = calloc((size_t)count, sizeof(bool));
+    int *colliding = malloc(sizeof(int) * (size_t)count);
+    if (!bench.chunks || !bench.live || !colliding || !chunk_hash_init(&bench.cache, slots)) {
+        fprintf(stderr, "Failed to allocate a %d-slot table for %d keys\n", slots, count);
+        free(bench.chunks);
+        free(bench.live);
+        free(colliding);
+        chunk_hash_destroy(&bench.cache);
+        return 1;
+    }
+    bench.count = count;
+    for (int i = 0; i < count; i++) {
+        int32_t key[3];
+        hash_bench_key(i, count, key);
+        bench.chunks[i].chunk_x = key[0];
+        bench.chunks[i].chunk_y = key[1];
+        bench.chunks[i].chunk_z = key[2];
+    }
+
+    for (int i = 0; i < count; i++) {
+        hash_bench_insert(&bench, i);
+    }
+    long bad = hash_bench_verify(&bench);
+
+    // Remove a batch and put it back, over every key, until enough ops are timed
+    int batches = (count + HASH_BENCH_BATCH - 1) / HASH_BENCH_BATCH;
+    int rounds = HASH_BENCH_OPS / count + 1;
+    double insert_time = 0.0;
+    double remove_time = 0.0;
+    long updates = 0;
+    for (int r = 0; r < rounds; r++) {
+        for (int b = 0; b < batches; b++) {
+            int first = b * HASH_BENCH_BATCH;
+            int last = first + HASH_BENCH_BATCH < count ? first + HASH_BENCH_BATCH : count;
+            double start = check_now();
+            for (int i = first; i < last; i++) {
+                hash_bench_remove(&bench, i);
+            }
+            remove_time += check_now() - start;
+            for (int i = first; i < last; i++) {
+                Chunk *chunk = &bench.chunks[i];
+                bad += chunk_hash_lookup(&bench.cache, chunk->chunk_x, chunk->chunk_y, chunk->chunk_z) ? 1 : 0;
+            }
+            start = check_now();
+            for (int i = first; i < last; i++) {
+                hash_bench_insert(&bench, i);
+            }
+            insert_time += check_now() - start;
+            updates += last - first;
+        }
+        bad += hash_bench_verify(&bench);
+    }
+
+    long lookups = (long)rounds * count;
+    double start = check_now();
+    for (int r = 0; r < rounds; r++) {
+        for (int i = 0; i < count; i++) {
+            Chunk *chunk = &bench.chunks[i];
+            bad += chunk_hash_lookup(&bench.cache, chunk->chunk_x, chunk->chunk_y, chunk->chunk_z) != chunk ? 1 : 0;
+        }
+    }
+    double hit_time = check_now() - start;
+    start = check_now();
+    for (int r = 0; r < rounds; r++) {
+        for (int i = 0; i < count; i++) {
+            Chunk *chunk = &bench.chunks[i];
+            bad += chunk_hash_lookup(&bench.cache, chunk->chunk_x + HASH_BENCH_MISS_OFFSET, chunk->chunk_y,
+                                     chunk->chunk_z) ? 1 : 0;
+        }
+    }
+    double miss_time = check_now() - start;
+
+    // Probe lengths as stored, and which keys share their home slot with another
+    ChunkCache *cache = &bench.cache;
+    uint32_t mask = (uint32_t)(cache->hash_capacity - 1);
+    long probe_total = 0;
+    uint32_t probe_max = 0;
+    int colliding_count = 0;
+    for (int slot = 0; slot < cache->hash_capacity; slot++) {
+        const ChunkHashEntry *entry = &cache->hash_table[slot];
+        if (!entry->chunk) {
+            continue;
+        }
+        uint32_t distance = ((uint32_t)slot - entry->hash) & mask;
+        probe_total += distance;
+        probe_max = distance > probe_max ? distance : probe_max;
+        const ChunkHashEntry *previous = &cache->hash_table[(slot - 1) & mask];
+        const ChunkHashEntry *next = &cache->hash_table[(slot + 1) & mask];
+        if ((previous->chunk && ((previous->hash ^ entry->hash) & mask) == 0) ||
+            (next->chunk && ((next->hash ^ entry->hash) & mask) == 0)) {
+            colliding[colliding_count++] = (int)(entry->chunk - bench.chunks);
+        }
+    }
+
+    // Churn: take every other colliding key out, check, put them back in reverse order
+    double churn_time = 0.0;
+    long churn_ops = 0;
+    for (int r = 0; r < HASH_BENCH_CHURN_ROUNDS && colliding_count > 0; r++) {
+        start = check_now();
+        for (int i = r & 1; i < colliding_count; i += 2) {
+            hash_bench_remove(&bench, colliding[i]);
+        }
+        churn_time += check_now() - start;
+        bad += hash_bench_verify(&bench);
+        start = check_now();
+        for (int i = colliding_count - 1; i >= 0; i--) {
+            if (!bench.live[colliding[i]]) {
+                hash_bench_insert(&bench, colliding[i]);
+                churn_ops += 2;
+            }
+        }
+        churn_time += check_now() - start;
+        bad += hash_bench_verify(&bench);
+    }
+
+    // Every count here is below the grow threshold, so the table must not have grown
+    if (cache->hash_capacity != slots) {
+        bad++;
+    }
+    printf("[hash-bench] %s: %d keys in %d slots, probe distance mean %.2f max %u; insert %.1f ns, remove %.1f ns, "
+           "hit %.1f ns, miss %.1f ns; churn of %d colliding keys %.1f ns per op; %ld errors\n",
+           label, count, cache->hash_capacity, count > 0 ? (double)probe_total / count : 0.0, probe_max,
+           updates > 0 ? insert_time * 1e9 / updates : 0.0, updates > 0 ? remove_time * 1e9 / updates : 0.0,
+           hit_time * 1e9 / lookups, miss_time * 1e9 / lookups, colliding_count,
+           churn_ops > 0 ? churn_time * 1e9 / churn_ops : 0.0, bad);
+
+    chunk_pool_destroy(&bench.cache);
+    chunk_hash_destroy(&bench.cache);
+    free(bench.chunks);
+    free(bench.live);
+    free(colliding);
+    return bad;
+}
+
+int server_bench_hash(int slots) {
+    if (slots <= 0) {
+        slots = HASH_BENCH_DEFAULT_SLOTS;
+    }
+    int capacity = HASH_BENCH_MIN_SLOTS;
+    while (capacity < slots) {
+        capacity *= 2;
+    }
+
+    static const struct {
+        const char *label;
+        double fill;
+    } fills[] = {{"25%", 0.25}, {"50%", 0.5}, {"70%", 0.7}, {"before grow", CHUNK_HASH_MAX_LOAD}};
+    long bad = 0;
+    for (size_t i = 0; i < sizeof(fills) / sizeof(fills[0]); i++) {
+        bad += hash_bench_fill(capacity, (int)(capacity * fills[i].fill), fills[i].label);
+    }
+
+    printf("[hash-bench] %ld errors; %s\n", bad, bad == 0 ? "ok" : "FAILED");
+    return bad == 0 ? 0 : 1;
+}
+
+// ============================================================================
+// MESH BENCHMARK
+// ============================================================================
+// `--mesh-bench [passes]` times chunk_build_mesh (neighbour-padded snapshot and
+// greedy meshing; the server build doesn't bake vertices there) over every chunk
+// around the origin, then the vertex baking the client adds on top of it, and
+// prints the best pass of each in ms per chunk.
+
+#define MESH_BENCH_DEFAULT_PASSES 5
+
+int server_bench_mesh(const char *world_name, int passes) {
+    if (passes <= 0) {
+        passes = MESH_BENCH_DEFAULT_PASSES;
+    }
+    World *world = check_world_open(world_name, CHECK_ANY_SEED, CHECK_LOAD_DIST);
+    if (!world) {
+        return 1;
+    }
+
+    int chunks = 0;
+    long quads = 0;
+    double best_mesh = 0.0;
+    double best_bake = 0.0;
+    for (int pass = 0; pass < passes; pass++) {
+        double mesh_time = 0.0;
+        double bake_time = 0.0;
+        chunks = 0;
+        quads = 0;
+        for (int i = 0; i < world->chunk_cache.chunk_count; i++) {
+            Chunk *chunk = world->chunk_cache.live[i];
+            if (!chunk->generated) {
+                continue;
+            }
+            double start = check_now();
+            chunk_build_mesh(chunk, world);
+            mesh_time += check_now() - start;
+
+            MergedMesh *mesh = chunk->merged_mesh[chunk->active_merged_mesh];
+            if (mesh) {
+                start = check_now();
+                chunk_mesh_build_vertices(mesh, chunk, NULL);
+                bake_time += check_now() - start;
+                for (int face = 0; face < 6; face++) {
+                    quads += mesh->quad_count[face];
+                }
+            }
+            chunks++;
+        }
+        if (pass == 0 || mesh_time < best_mesh) {
+            best_mesh = mesh_time;
+        }
+        if (pass == 0 || bake_time < best_bake) {
+            best_bake = bake_time;
+        }
+    }
+
+    int per = chunks > 0 ? chunks : 1;
+    printf("[mesh-bench] %d chunks, %ld quads: snapshot + mesh %.3f ms per chunk, "
+           "vertex bake %.3f ms per chunk (best of %d)\n",
+           chunks, quads, best_mesh * 1000.0 / per, best_bake * 1000.0 / per, passes);
+    world_free(world);
+    return chunks > 0 ? 0 : 1;
+}
+
+
+// ============================================================================
+// MESH CHECK
+// ============================================================================
+// `--mesh-check` rebuilds every chunk's mesh and checks the greedy quads against
+// the blocks: each exposed face (worked out per block through world_get_block)
+// is covered by exactly one quad of the block's type, and no quad covers anything
+// else. The quads are then baked and the triangles must add up to the same area.
+
+// Per block bitmask of the faces covered by quads so far
+static uint8_t mesh_check_cover[CHUNK_HEIGHT][CHUNK_DEPTH][CHUNK_WIDTH];
+
+static const int mesh_check_normals[6][3] = {
+    {1, 0, 0}, {-1, 0, 0}, {0, 1, 0}, {0, -1, 0}, {0, 0, 1}, {0, 0, -1}};
+
+// Mark the blocks under one quad, returns how many of them were wrong
+static long mesh_check_cover_quad(Chunk *chunk, const MergedQuad *quad) {
+    int size_x = 1;
+    int size_y = 1;
+    int size_z = 1;
+    if (quad->face < 2) {
+        size_z = quad->w;
+        size_y = quad->h;
+    } else if (quad->face < 4) {
+        size_x = quad->w;
+        size_z = quad->h;
+    } else {
+        size_x = quad->w;
+        size_y = quad->h;
+    }
+
+    long bad = 0;
+    for (int dy = 0; dy < size_y; dy++) {
+        for (int dz = 0; dz < size_z; dz++) {
+            for (int dx = 0; dx < size_x; dx++) {
+                int x = quad->x - chunk->chunk_x * CHUNK_WIDTH + dx;
+                int y = quad->y - chunk->chunk_y * CHUNK_HEIGHT + dy;
+                int z = quad->z - chunk->chunk_z * CHUNK_DEPTH + dz;
+                if (x < 0 || x >= CHUNK_WIDTH || y < 0 || y >= CHUNK_HEIGHT || z < 0 || z >= CHUNK_DEPTH) {
+                    bad++; // Outside its chunk
+                    continue;
+                }
+                if ((mesh_check_cover[y][z][x] & (1 << quad->face)) ||
+                    world_chunk_get_block(chunk, x, y, z) != quad->type) {
+                    bad++; // Covered twice, or the quad has the wrong type
+                }
+                mesh_check_cover[y][z][x] |= (uint8_t)(1 << quad->face);
+            }
+        }
+    }
+    return bad;
+}
+
+// Compare the covered faces of a chunk with its exposed faces, returns how many blocks differ
+static long mesh_check_exposed(World *world, Chunk *chunk, long *faces) {
+    int32_t origin_x = chunk->chunk_x * CHUNK_WIDTH;
+    int32_t origin_y = chunk->chunk_y * CHUNK_HEIGHT;
+    int32_t origin_z = chunk->chunk_z * CHUNK_DEPTH;
+    long bad = 0;
+    for (int y = 0; y < CHUNK_HEIGHT; y++) {
+        for (int z = 0; z < CHUNK_DEPTH; z++) {
+            for (int x = 0; x < CHUNK_WIDTH; x++) {
+                BlockType block = world_chunk_get_block(chunk, x, y, z);
+                uint8_t exposed = 0;
+                for (int face = 0; block != BLOCK_AIR && face < 6; face++) {
+                    BlockType neighbor = world_get_block(world, origin_x + x + mesh_check_normals[face][0],
+                                                         origin_y + y + mesh_check_normals[face][1],
+                                                         origin_z + z + mesh_check_normals[face][2]);
+                    if (block_face_is_exposed(block, neighbor)) {
+                        exposed |= (uint8_t)(1 << face);
+                        (*faces)++;
+                    }
+                }
+                if (mesh_check_cover[y][z][x] != exposed) {
+                    bad++;
+                }
+            }
+        }
+    }
+    return bad;
+}
+
+// Bake a mesh and check the vertex list, returns the number of problems; `area` gets
+// the total triangle area, which is one per covered face
+static long mesh_check_vertices(MergedMesh *mesh, Chunk *chunk, double *area) {
+    int quads = 0;
+    for (int face = 0; face < 6; face++) {
+        quads += mesh->quad_count[face];
+    }
+    if (!chunk_mesh_build_vertices(mesh, chunk, NULL)) {
+        return 1;
+    }
+
+    long bad = mesh->vertex_count != quads * 6 ? 1 : 0;
+    int next = 0;
+    bool seen_transparent = false;
+    for (int r = 0; r < mesh->range_count; r++) {
+        const ChunkMeshRange *range = &mesh->ranges[r];
+        if (range->first_vertex != next || (seen_transparent && !range->transparent)) {
+            bad++; // Ranges must be contiguous with opaque ones first
+        }
+        seen_transparent = seen_transparent || range->transparent;
+        next += range->vertex_count;
+    }
+    if (next != mesh->vertex_count) {
+        bad++;
+    }
+
+    for (int v = 0; v + 2 < mesh->vertex_count; v += 3) {
+        const ChunkVertex *a = &mesh->vertices[v];
+        const ChunkVertex *b = a + 1;
+        const ChunkVertex *c = a + 2;
+        double ux = b->x - a->x, uy = b->y - a->y, uz = b->z - a->z;
+        double vx = c->x - a->x, vy = c->y - a->y, vz = c->z - a->z;
+        double cx = uy * vz - uz * vy, cy = uz * vx - ux * vz, cz = ux * vy - uy * vx;
+        *area += 0.5 * sqrt(cx * cx + cy * cy + cz * cz);
+    }
+    return bad;
+}
+
+int server_check_mesh(const char *world_name) {
+    World *world = check_world_open(world_name, CHECK_ANY_SEED, CHECK_LOAD_DIST);
+    if (!world) {
+        return 1;
+    }
+
+    int chunks = 0;
+    long faces = 0;
+    long quads = 0;
+    long cover_bad = 0;
+    long vertex_bad = 0;
+    double area = 0.0;
+    for (int i = 0; i < world->chunk_cache.chunk_count; i++) {
+        Chunk *chunk = world->chunk_cache.live[i];
+        if (!chunk->generated) {
+            continue;
+        }
+        chunk_build_mesh(chunk, world);
+        MergedMesh *mesh = chunk->merged_mesh[chunk->active_merged_mesh];
+
+        memset(mesh_check_cover, 0, sizeof(mesh_check_cover));
+        for (int face = 0; mesh && face < 6; face++) {
+            for (int q = 0; q < mesh->quad_count[face]; q++) {
+                if (mesh->quads[face][q].face != face) {
+                    cover_bad++;
+                }
+                cover_bad += mesh_check_cover_quad(chunk, &mesh->quads[face][q]);
+                quads++;
+            }
+        }
+        cover_bad += mesh_check_exposed(world, chunk, &faces);
+        if (mesh) {
+            vertex_bad += mesh_check_vertices(mesh, chunk, &area);
+        }
+        chunks++;
+    }
+    if (fabs(area - (double)faces) > 0.5) {
+        vertex_bad++;
+    }
+
+    bool ok = chunks > 0 && cover_bad == 0 && vertex_bad == 0;
+    printf("[mesh-check] %d chunks, %ld exposed faces in %ld quads (%.2f faces per quad): "
+           "%ld coverage errors, %ld vertex errors, %s\n",
+           chunks, faces, quads, quads > 0 ? (double)faces / quads : 0.0, cover_bad, vertex_bad, ok ? "ok" : "FAILED");
+    world_free(world);
+    return ok ? 0 : 1;
+}
+
+// ============================================================================
+// RAYCAST CHECK
+// ============================================================================
+// `--raycast-check` compares world_raycast (a DDA voxel walk) with the exact
+// answer, found by a slab test of the ray against every non-air block around it,
+// and with the fixed 0.1-block march block picking used before the DDA. Random
+// rays must hit the exact first block at its entry distance (or another block the
+// ray enters at the same distance, along an edge or corner), and never later than
+// the old march; the old march may miss corners the DDA catches. Rays along each
+// axis must match a block-by-block walk exactly, distance and face included.
+// Origins straddle zero so negative coordinates and chunk borders are covered.
+// The world is generated from a fixed seed so a failure can be reproduced; run
+// it on a world name that doesn't exist yet.
+
+#define RAYCAST_CHECK_SEED 1792122288ull // One of the seeds a fine-march reference used to fail on
+#define RAYCAST_CHECK_RAYS 20000
+#define RAYCAST_CHECK_DISTANCE 8.0f
+#define RAYCAST_CHECK_OLD_STEP 0.1f
+#define RAYCAST_CHECK_TIE 0.002f // Distances this close count as the same boundary
+
+// First non-air block a fixed-step march samples, at sample distance `*distance`
+static bool raycast_check_march(World *world, Vector3 origin, Vector3 direction, float step, int block[3],
+                                float *distance) {
+    for (float t = 0.0f; t < RAYCAST_CHECK_DISTANCE; t += step) {
+        int x = (int)floorf(origin.x + direction.x * t);
+        int y = (int)floorf(origin.y + direction.y * t);
+        int z = (int)floorf(origin.z + direction.z * t);
+        if (world_get_block(world, x, y, z) != BLOCK_AIR) {
+            block[0] = x;
+            block[1] = y;
+            block[2] = z;
+            *distance = t;
+            return true;
+        }
+    }
+    return false;
+}
+
+// Distance at which the ray enters the unit box of `cell` (0 if it starts inside),
+// or a negative value if it passes it by or only reaches it past RAYCAST_CHECK_DISTANCE
+static double raycast_check_enter(const double origin[3], const double direction[3], const int cell[3]) {
+    double enter = 0.0;
+    double exit = RAYCAST_CHECK_DISTANCE;
+    for (int axis = 0; axis < 3; axis++) {
+        double low = (double)cell[axis];
+        double high = low + 1.0;
+        if (direction[axis] == 0.0) {
+            if (origin[axis] < low || origin[axis] >= high) {
+                return -1.0;
+            }
+            continue;
+        }
+        double t0 = (low - origin[axis]) / direction[axis];
+        double t1 = (high - origin[axis]) / direction[axis];
+        if (t0 > t1) {
+            double swap = t0;
+            t0 = t1;
+            t1 = swap;
+        }
+        if (t0 > enter) {
+            enter = t0;
+        }
+        if (t1 < exit) {
+            exit = t1;
+        }
+    }
+    return enter < exit && enter < RAYCAST_CHECK_DISTANCE ? enter : -1.0;
+}
+
+// Exact first non-air block along the ray: slab-test every block in the box the
+// ray segment spans and keep the nearest entry. Distances are in double precision.
+static bool raycast_check_exact(World *world, Vector3 origin, Vector3 direction, int block[3], double *distance) {
+    double o[3] = {origin.x, origin.y, origin.z};
+    double d[3] = {direction.x, direction.y, direction.z};
+    int low[3];
+    int high[3];
+    for (int axis = 0; axis < 3; axis++) {
+        double end = o[axis] + d[axis] * RAYCAST_CHECK_DISTANCE;
+        low[axis] = (int)floor(o[axis] < end ? o[axis] : end);
+        high[axis] = (int)floor(o[axis] < end ? end : o[axis]);
+    }
+
+    bool found = false;
+    int cell[3];
+    for (cell[0] = low[0]; cell[0] <= high[0]; cell[0]++) {
+        for (cell[1] = low[1]; cell[1] <= high[1]; cell[1]++) {
+            for (cell[2] = low[2]; cell[2] <= high[2]; cell[2]++) {
+                double enter = raycast_check_enter(o, d, cell);
+                if (enter < 0.0 || (found && enter >= *distance)) {
+                    continue;
+                }
+                if (world_get_block(world, cell[0], cell[1], cell[2]) != BLOCK_AIR) {
+                    block[0] = cell[0];
+                    block[1] = cell[1];
+                    block[2] = cell[2];
+                    *distance = enter;
+                    found = true;
+                }
+            }
+        }
+    }
+    return found;
+}
+
+// The face a hit reports must lead back to air (or be none when the ray starts inside)
+static bool raycast_check_normal(World *world, const WorldRayHit *hit) {
+    int length = abs(hit->normal_x) + abs(hit->normal_y) + abs(hit->normal_z);
+    if (hit->distance <= 0.0f) {
+        return length == 0;
+    }
+    return length == 1 &&
+           world_get_block(world, hit->x + hit->normal_x, hit->y + hit->normal_y, hit->z + hit->normal_z) == BLOCK_AIR;
+}
+
+// Rays along one axis: walk whole blocks and expect the exact entry distance and face.
+// Returns the number of mismatches.
+static long raycast_check_axis(World *world, Vector3 origin, int axis, int sign, int *hits) {
+    float position[3] = {origin.x, origin.y, origin.z};
+    float direction_axes[3] = {0.0f, 0.0f, 0.0f};
+    direction_axes[axis] = (float)sign;
+    Vector3 direction = {direction_axes[0], direction_axes[1], direction_axes[2]};
+
+    int cell[3] = {(int)floorf(position[0]), (int)floorf(position[1]), (int)floorf(position[2])};
+    bool expected = false;
+    float expected_distance = 0.0f;
+    for (int k = 0; !expected; k++) {
+        float enter = 0.0f;
+        if (k > 0) {
+            enter = sign > 0 ? (float)(cell[axis] + 1) - position[axis] + (float)(k - 1)
+                             : position[axis] - (float)cell[axis] + (float)(k - 1);
+        }
+        if (enter >= RAYCAST_CHECK_DISTANCE) {
+            break;
+        }
+        int block[3] = {cell[0], cell[1], cell[2]};
+        block[axis] += sign * k;
+        if (world_get_block(world, block[0], block[1], block[2]) != BLOCK_AIR) {
+            expected = true;
+            expected_distance = enter;
+            cell[axis] = block[axis];
+        }
+    }
+
+    WorldRayHit hit;
+    bool got = world_raycast(world, origin, direction, RAYCAST_CHECK_DISTANCE, &hit);
+    if (got != expected) {
+        return 1;
+    }
+    if (!got) {
+        return 0;
+    }
+    (*hits)++;
+    int normal[3] = {hit.normal_x, hit.normal_y, hit.normal_z};
+    int expected_normal = expected_distance > 0.0f ? -sign : 0;
+    long bad = 0;
+    if (hit.x != cell[0] || hit.y != cell[1] || hit.z != cell[2] || fabsf(hit.distance - expected_distance) > 1e-4f ||
+        normal[axis] != expected_normal || !raycast_check_normal(world, &hit)) {
+        bad++;
+    }
+
+    // Along an axis the old march can't skip a block, so it has to agree
+    int old_block[3];
+    float old_distance = 0.0f;
+    if (!raycast_check_march(world, origin, direction, RAYCAST_CHECK_OLD_STEP, old_block, &old_distance) ||
+        old_block[0] != hit.x || old_block[1] != hit.y || old_block[2] != hit.z) {
+        bad++;
+    }
+    return bad;
+}
+
+int server_check_raycast(const char *world_name) {
+    World *world = check_world_open(world_name, RAYCAST_CHECK_SEED, CHECK_LOAD_DIST);
+    if (!world) {
+        return 1;
+    }
+
+    // Fixed LCG so every run casts the same rays
+    uint32_t seed = 77;
+    long bad = 0;
+    int hits = 0;
+    int ties = 0;
+    int old_differs = 0;
+    for (int r = 0; r < RAYCAST_CHECK_RAYS; r++) {
+        float v[6];
+        for (int i = 0; i < 6; i++) {
+            seed = seed * 1664525u + 1013904223u;
+            v[i] = (float)(seed >> 8) / (float)(1u << 24); // [0, 1)
+        }
+        Vector3 origin = {v[0] * 80.0f - 40.0f, 40.0f + v[1] * 70.0f, v[2] * 80.0f - 40.0f};
+        Vector3 direction = {v[3] * 2.0f - 1.0f, v[4] * 2.0f - 1.0f, v[5] * 2.0f - 1.0f};
+        float length = sqrtf(direction.x * direction.x + direction.y * direction.y + direction.z * direction.z);
+        if (length < 1e-3f) {
+            continue;
+        }
+        direction.x /= length;
+        direction.y /= length;
+        direction.z /= length;
+
+        WorldRayHit hit;
+        bool got = world_raycast(world, origin, direction, RAYCAST_CHECK_DISTANCE, &hit);
+        int exact_block[3];
+        double exact_distance = 0.0;
+        bool exact = raycast_check_exact(world, origin, direction, exact_block, &exact_distance);
+        if (got != exact ||
+            (got && (hit.x != exact_block[0] || hit.y != exact_block[1] || hit.z != exact_block[2]))) {
+            // Fine: an edge or corner entered at the same distance, or a block right at the distance limit
+            if ((got && exact && fabs(hit.distance - exact_distance) < RAYCAST_CHECK_TIE) ||
+                (got && !exact && RAYCAST_CHECK_DISTANCE - hit.distance < RAYCAST_CHECK_TIE) ||
+                (!got && exact && RAYCAST_CHECK_DISTANCE - exact_distance < RAYCAST_CHECK_TIE)) {
+                ties++;
+            } else {
+                bad++;
+            }
+        } else if (got && fabs(hit.distance - exact_distance) >= RAYCAST_CHECK_TIE) {
+            bad++; // Right block, wrong entry distance
+        }
+        if (got) {
+            hits++;
+            if (!raycast_check_normal(world, &hit)) {
+                bad++;
+            }
+        }
+
+        int old_block[3];
+        float old_distance = 0.0f;
+        bool old = raycast_check_march(world, origin, direction, RAYCAST_CHECK_OLD_STEP, old_block, &old_distance);
+        if (old && (!got || hit.distance > old_distance + 1e-4f)) {
+            bad++; // The DDA must never find a block later than the old march did
+        }
+        if (old != got || (got && (hit.x != old_block[0] || hit.y != old_block[1] || hit.z != old_block[2]))) {
+            old_differs++;
+        }
+    }
+
+    // Axis-aligned rays from a grid of origins either side of zero
+    int axis_rays = 0;
+    int axis_hits = 0;
+    for (int x = -40; x < 40; x += 7) {
+        for (int z = -40; z < 40; z += 7) {
+            for (int y = 48; y < 112; y += 9) {
+                Vector3 origin = {(float)x + 0.37f, (float)y + 0.61f, (float)z + 0.83f};
+                for (int axis = 0; axis < 3; axis++) {
+                    bad += raycast_check_axis(world, origin, axis, 1, &axis_hits);
+                    bad += raycast_check_axis(world, origin, axis, -1, &axis_hits);
+                    axis_rays += 2;
+                }
+            }
+        }
+    }
+
+    bool ok = bad == 0 && hits > 0 && axis_hits > 0;
+    printf("[raycast-check] %d random rays, %d hits (%d edge ties), old march differs on %d; "
+           "%d axis rays, %d hits; %ld errors, %s\n",
+           RAYCAST_CHECK_RAYS, hits, ties, old_differs, axis_rays, axis_hits, bad, ok ? "ok" : "FAILED");
+    world_free(world);
+    return ok ? 0 : 1;
+}
+
+// ============================================================================
+// REGION FILE CHECK
+// ============================================================================
+// `--region-check` stresses region files directly, in a world that must not
+// exist yet: records of random sizes are written, overwritten many times over
+// (so they grow, shrink and move), read back after every round and again after
+// the files are closed and reopened. Threads then write and read their own
+// records concurrently, and per-chunk files from before regions are migrated.
+// Every record must read back byte for byte.
+
+#define REGION_CHECK_RECORDS 300
+#define REGION_CHECK_ROUNDS 20
+#define REGION_CHECK_MAX_SIZE 30000
+#define REGION_CHECK_THREADS 8
+#define REGION_CHECK_THREAD_WRITES 300
+#define REGION_CHECK_LEGACY_FILES 50
+
+typedef struct {
+    int32_t chunk_x, chunk_y, chunk_z;
+    uint8_t *data;
+    size_t size;
+} RegionCheckRecord;
+
+typedef struct {
+    const char *world_name;
+    int id;
+    long bad;
+} RegionCheckThread;
+
+static uint32_t region_check_rand(uint32_t *state) {
+    *state = *state * 1664525u + 1013904223u;
+    return *state >> 8;
+}
+
+// Give a record new contents of `size` bytes, a pattern unique to this write
+static bool region_check_fill(RegionCheckRecord *record, size_t size, uint32_t salt) {
+    uint8_t *data = realloc(record->data, size);
+    if (!data) {
+        return false;
+    }
+    for (size_t k = 0; k < size; k++) {
+        data[k] = (uint8_t)(salt * 31u + k * 7u);
+    }
+    record->data = data;
+    record->size = size;
+    return true;
+}
+
+// Is the stored record exactly these bytes?
+static bool region_check_read(const char *world_name, int32_t chunk_x, int32_t chunk_y, int32_t chunk_z,
+                              const uint8_t *data, size_t size) {
+    RegionChunkView view;
+    if (!region_map_chunk(world_name, chunk_x, chunk_y, chunk_z, &view)) {
+        return false;
+    }
+    bool same = view.size == size && memcmp(view.data, data, size) == 0;
+    region_unmap_chunk(&view);
+    return same;
+}
+
+static long region_check_verify(const char *world_name, const RegionCheckRecord *records) {
+    long bad = 0;
+    for (int i = 0; i < REGION_CHECK_RECORDS; i++) {
+        const RegionCheckRecord *record = &records[i];
+        if (!region_check_read(world_name, record->chunk_x, record->chunk_y, record->chunk_z, record->data,
+                               record->size)) {
+            bad++;
+        }
+    }
+    return bad;
+}
+
+// Each thread rewrites its own 40 chunks (in a z layer of its own), checking every write
+static void *region_check_thread(void *arg) {
+    RegionCheckThread *thread = (RegionCheckThread *)arg;
+    uint8_t *buffer = malloc(REGION_CHECK_MAX_SIZE);
+    if (!buffer) {
+        thread->bad++;
+        return NULL;
+    }
+    for (int r = 0; r < REGION_CHECK_THREAD_WRITES; r++) {
+        int slot = r % 40;
+        int32_t chunk_x = slot % 20 - 10;
+        int32_t chunk_y = slot / 20;
+        int32_t chunk_z = 100 + thread->id;
+        size_t size = 100 + (size_t)(r * 977 + thread->id) % (REGION_CHECK_MAX_SIZE - 100);
+        memset(buffer, (uint8_t)(r + thread->id), size);
+        if (!region_write_chunk(thread->world_name, chunk_x, chunk_y, chunk_z, buffer, size) ||
+            !region_check_read(thread->world_name, chunk_x, chunk_y, chunk_z, buffer, size)) {
+            thread->bad++;
+        }
+    }
+    free(buffer);
+    return NULL;
+}
+
+// Write per-chunk files the way worlds stored chunks before region files, then migrate
+// them. Returns the number of problems.
+static long region_check_migrate(const char *world_name, int *migrated) {
+    uint8_t data[REGION_CHECK_LEGACY_FILES + 50];
+    for (size_t k = 0; k < sizeof(data); k++) {
+        data[k] = (uint8_t)k;
+    }
+
+    char path[512];
+    long bad = 0;
+    for (int i = 0; i < REGION_CHECK_LEGACY_FILES; i++) {
+        snprintf(path, sizeof(path), "./worlds/%s/chunks/chunk_%d_%d_%d.chunk", world_name, i - 25, i % 3, -200 - i);
+        FILE *file = fopen(path, "wb");
+        if (!file || fwrite(data, 1, (size_t)(50 + i), file) != (size_t)(50 + i)) {
+            bad++;
+        }
+        if (file) {
+            fclose(file);
+        }
+    }
+    // Not a chunk file, so migration must leave it alone
+    snprintf(path, sizeof(path), "./worlds/%s/chunks/notachunk.txt", world_name);
+    FILE *other = fopen(path, "w");
+    if (other) {
+        fclose(other);
+    }
+
+    int failed = 0;
+    *migrated = region_migrate_chunk_files(world_name, &failed);
+    if (*migrated != REGION_CHECK_LEGACY_FILES || failed != 0) {
+        bad++;
+    }
+    struct stat st;
+    if (stat(path, &st) != 0) {
+        bad++;
+    }
+    for (int i = 0; i < REGION_CHECK_LEGACY_FILES; i++) {
+        if (!region_check_read(world_name, i - 25, i % 3, -200 - i, data, (size_t)(50 + i))) {
+            bad++;
+        }
+        snprintf(path, sizeof(path), "./worlds/%s/chunks/chunk_%d_%d_%d.chunk", world_name, i - 25, i % 3, -200 - i);
+        if (stat(path, &st) == 0) {
+            bad++; // Migrated files are removed
+        }
+    }
+    return bad;
+}
+
+int server_check_region(const char *world_name) {
+    char path[512];
+    snprintf(path, sizeof(path), "./worlds/%s", world_name);
+    struct stat st;
+    if (stat(path, &st) == 0) {
+        fprintf(stderr, "--region-check writes raw records: give it a world name that doesn't exist yet\n");
+        return 1;
+    }
+    world_system_init();
+    char mkdir_cmd[600];
+    snprintf(mkdir_cmd, sizeof(mkdir_cmd), "mkdir -p \"./worlds/%s/chunks\"", world_name);
+    system(mkdir_cmd);
+
+    RegionCheckRecord *records = calloc(REGION_CHECK_RECORDS, sizeof(RegionCheckRecord));
+    if (!records) {
+        fprintf(stderr, "Failed to allocate records\n");
+        return 1;
+    }
+
+    // Distinct random chunks over a few regions, either side of zero
+    uint32_t seed = 5;
+    long bad = 0;
+    for (int i = 0; i < REGION_CHECK_RECORDS; i++) {
+        RegionCheckRecord *record = &records[i];
+        bool unique;
+        do {
+            record->chunk_x = (int32_t)(region_check_rand(&seed) % 40) - 20;
+            record->chunk_y = (int32_t)(region_check_rand(&seed) % 8) - 4;
+            record->chunk_z = (int32_t)(region_check_rand(&seed) % 40) - 20;
+            unique = true;
+            for (int j = 0; j < i && unique; j++) {
+                unique = records[j].chunk_x != record->chunk_x || records[j].chunk_y != record->chunk_y ||
+                         records[j].chunk_z != record->chunk_z;
+            }
+        } while (!unique);
+    }
+
+    // Initial writes, then rounds of rewrites at new sizes
+    int writes = 0;
+    for (int round = 0; round <= REGION_CHECK_ROUNDS; round++) {
+        for (int k = 0; k < REGION_CHECK_RECORDS; k++) {
+            int i = round == 0 ? k : (int)(region_check_rand(&seed) % REGION_CHECK_RECORDS);
+            RegionCheckRecord *record = &records[i];
+            size_t size = 10 + region_check_rand(&seed) % REGION_CHECK_MAX_SIZE;
+            if (!region_check_fill(record, size, region_check_rand(&seed)) ||
+                !region_write_chunk(world_name, record->chunk_x, record->chunk_y, record->chunk_z, record->data,
+                                    record->size)) {
+                bad++;
+            }
+            writes++;
+        }
+        bad += region_check_verify(world_name, records);
+    }
+    region_close_all();
+    bad += region_check_verify(world_name, records);
+
+    RegionCheckThread threads[REGION_CHECK_THREADS];
+    pthread_t handles[REGION_CHECK_THREADS];
+    bool started[REGION_CHECK_THREADS];
+    for (int t = 0; t < REGION_CHECK_THREADS; t++) {
+        threads[t] = (RegionCheckThread){.world_name = world_name, .id = t, .bad = 0};
+        started[t] = pthread_create(&handles[t], NULL, region_check_thread, &threads[t]) == 0;
+        if (!started[t]) {
+            threads[t].bad++;
+        }
+    }
+    for (int t = 0; t < REGION_CHECK_THREADS; t++) {
+        if (started[t]) {
+            pthread_join(handles[t], NULL);
+        }
+        bad += threads[t].bad;
+    }
+    region_close_all();
+    bad += region_check_verify(world_name, records);
+
+    int migrated = 0;
+    bad += region_check_migrate(world_name, &migrated);
+    region_close_all();
+
+    bool ok = bad == 0;
+    printf("[region-check] %d records written %d times, %d threads x %d writes, %d files migrated; %ld errors, %s\n",
+           REGION_CHECK_RECORDS, writes, REGION_CHECK_THREADS, REGION_CHECK_THREAD_WRITES, migrated, bad,
+           ok ? "ok" : "FAILED");
+    for (int i = 0; i < REGION_CHECK_RECORDS; i++) {
+        free(records[i].data);
+    }
+    free(records);
+    return ok ? 0 : 1;
+}
+
+// ============================================================================
+// CHUNK LOAD BENCHMARK
+// ============================================================================
+// `--load-bench [passes]` stores every chunk around the origin, then times
+// loading them back: each pass drops every chunk (world_load) and brings each
+// one back with world_load_or_create_chunk, which maps its record from the
+// region file and decodes it in place. The spawn area world_load loads itself
+// is not timed. Page cache is warm, so this is the per-chunk CPU latency, not
+// disk time. Every chunk loaded must match the chunk it was saved from.
+
+#define LOAD_BENCH_DEFAULT_PASSES 5
+#define LOAD_BENCH_BLOCKS (CHUNK_WIDTH * CHUNK_HEIGHT * CHUNK_DEPTH)
+
+// Block types of a chunk, one byte per block in y/z/x order
+static void load_bench_types(Chunk *chunk, uint8_t *types) {
+    for (int y = 0; y < CHUNK_HEIGHT; y++) {
+        for (int z = 0; z < CHUNK_DEPTH; z++) {
+            for (int x = 0; x < CHUNK_WIDTH; x++) {
+                *types++ = (uint8_t)world_chunk_get_block(chunk, x, y, z);
+            }
+        }
+    }
+}
+
+int server_bench_load(const char *world_name, int passes) {
+    if (passes <= 0) {
+        passes = LOAD_BENCH_DEFAULT_PASSES;
+    }
+    World *world = check_world_open(world_name, CHECK_ANY_SEED, CHECK_LOAD_DIST);
+    if (!world) {
+        return 1;
+    }
+
+    // Store every chunk, edited or not
+    pthread_mutex_lock(&world->cache_mutex);
+    for (int i = 0; i < world->chunk_cache.chunk_count; i++) {
+        Chunk *chunk = world->chunk_cache.live[i];
+        pthread_mutex_lock(&chunk->mutex);
+        chunk->modified = chunk->generated;
+        pthread_mutex_unlock(&chunk->mutex);
+    }
+    pthread_mutex_unlock(&world->cache_mutex);
+    if (!world_save(world, world_name)) {
+        fprintf(stderr, "Failed to save world '%s'\n", world_name);
+        world_free(world);
+        return 1;
+    }
+
+    int count = world->chunk_cache.chunk_count;
+    int32_t *coords = malloc(sizeof(int32_t) * 3 * (size_t)(count > 0 ? count : 1));
+    uint8_t *expected = malloc((size_t)LOAD_BENCH_BLOCKS * (size_t)(count > 0 ? count : 1));
+    uint8_t *scratch = malloc(LOAD_BENCH_BLOCKS);
+    if (!coords || !expected || !scratch) {
+        fprintf(stderr, "Failed to allocate block buffers\n");
+        free(coords);
+        free(expected);
+        free(scratch);
+        world_free(world);
+        return 1;
+    }
+    for (int i = 0; i < count; i++) {
+        Chunk *chunk = world->chunk_cache.live[i];
+        coords[i * 3 + 0] = chunk->chunk_x;
+        coords[i * 3 + 1] = chunk->chunk_y;
+        coords[i * 3 + 2] = chunk->chunk_z;
+        load_bench_types(chunk, expected + (size_t)i * LOAD_BENCH_BLOCKS);
+    }
+
+    long bad = 0;
+    int timed = 0;
+    double best = 0.0;
+    for (int pass = 0; pass < passes; pass++) {
+        if (!world_load(world, world_name)) { // Drops every chunk, then loads the spawn area again
+            bad++;
+            break;
+        }
+        double elapsed = 0.0;
+        timed = 0;
+        pthread_mutex_lock(&world->cache_mutex);
+        for (int i = 0; i < count; i++) {
+            int32_t chunk_x = coords[i * 3 + 0];
+            int32_t chunk_y = coords[i * 3 + 1];
+            int32_t chunk_z = coords[i * 3 + 2];
+            if (world_get_chunk(world, chunk_x, chunk_y, chunk_z)) {
+                continue; // Spawn area
+            }
+            double start = check_now();
+            world_load_or_create_chunk(world, chunk_x, chunk_y, chunk_z);
+            elapsed += check_now() - start;
+            timed++;
+        }
+        for (int i = 0; i < count; i++) {
+            Chunk *chunk = world_get_chunk(world, coords[i * 3 + 0], coords[i * 3 + 1], coords[i * 3 + 2]);
+            if (!chunk || !chunk->loaded) {
+                bad++;
+            } else if (pass == 0) {
+                load_bench_types(chunk, scratch);
+                bad += memcmp(expected + (size_t)i * LOAD_BENCH_BLOCKS, scratch, LOAD_BENCH_BLOCKS) != 0 ? 1 : 0;
+            }
+        }
+        pthread_mutex_unlock(&world->cache_mutex);
+        worker_flush_queue(world); // Meshing of the spawn area is not part of the next pass
+        if (pass == 0 || elapsed < best) {
+            best = elapsed;
+        }
+    }
+
+    bool ok = count > 0 && timed > 0 && bad == 0;
+    printf("[load-bench] %d chunks, %d loaded per pass: %.1f us per chunk (best of %d); %ld load errors, %s\n", count,
+           timed, best * 1e6 / (timed > 0 ? timed : 1), passes, bad, ok ? "ok" : "FAILED");
+    free(coords);
+    free(expected);
+    free(scratch);
+    world_free(world);
+    return ok ? 0 : 1;
+}
+
+// ============================================================================
+// LOAD STORM BENCHMARK
+// ============================================================================
+// `--load-storm [jumps]` teleports to `jumps` spots far apart and, at each, times
+// how long every chunk in view distance takes to come off disk and appear. A
+// first, untimed pass generates and stores every chunk the storm visits, so the
+// timed pass only reads (from a warm page cache). Compare read engines by
+// switching chunk_io in options.conf between runs.
+
+#define LOAD_STORM_DEFAULT_JUMPS 16
+#define LOAD_STORM_LOAD_DIST 2 // Chunks around the player in each direction
+#define LOAD_STORM_ROW 8       // Jumps per row of the grid
+
+// Chunk the player lands in for `jump`. Spots are far enough apart that no two
+// jumps share a chunk, and clear of the spawn area world_load keeps loaded.
+static void load_storm_spot(int jump, int32_t *chunk_x, int32_t *chunk_z) {
+    int stride = 2 * (LOAD_STORM_LOAD_DIST + 2) + 1;
+    *chunk_x = (1 + jump % LOAD_STORM_ROW) * stride;
+    *chunk_z = (1 + jump / LOAD_STORM_ROW) * stride;
+}
+
+// Teleport to `jump` and wait until its chunks are loaded or queued for generation.
+// Returns how many chunks around the spot are in memory; `main_time` gets how long
+// the main thread itself spent in world_update_chunks.
+static int load_storm_visit(World *world, int jump, bool mark_modified, double *main_time) {
+    int32_t spot_x = 0;
+    int32_t spot_z = 0;
+    load_storm_spot(jump, &spot_x, &spot_z);
+    Vector3 position = {spot_x * CHUNK_WIDTH + CHUNK_WIDTH / 2.0f, 100.0f, spot_z * CHUNK_DEPTH + CHUNK_DEPTH / 2.0f};
+    Vector3 down = {0.0f, -1.0f, 0.0f}; // No horizontal view, so no chunk counts as behind the player
+    int32_t spot_y = (int32_t)(position.y / CHUNK_HEIGHT);
+
+    worker_set_interest(world, position, down);
+    double start = check_now();
+    world_update_chunks(world, position, down, (float)(LOAD_STORM_LOAD_DIST * CHUNK_WIDTH));
+    *main_time = check_now() - start;
+    chunk_io_flush(world);
+    if (mark_modified) {
+        worker_flush_queue(world); // Chunks that were not stored yet are generated by the workers
+    }
+
+    int count = 0;
+    pthread_mutex_lock(&world->cache_mutex);
+    for (int cx = spot_x - LOAD_STORM_LOAD_DIST; cx <= spot_x + LOAD_STORM_LOAD_DIST; cx++) {
+        for (int cy = spot_y - LOAD_STORM_LOAD_DIST; cy <= spot_y + LOAD_STORM_LOAD_DIST; cy++) {
+            for (int cz = spot_z - LOAD_STORM_LOAD_DIST; cz <= spot_z + LOAD_STORM_LOAD_DIST; cz++) {
+                Chunk *chunk = world_get_chunk(world, cx, cy, cz);
+                if (!chunk || !chunk->generated) {
+                    continue;
+                }
+                if (mark_modified) {
+                    // Stored by the next world_save even if nothing was edited
+                    pthread_mutex_lock(&chunk->mutex);
+                    chunk->modified = true;
+                    pthread_mutex_unlock(&chunk->mutex);
+                }
+                count++;
+            }
+        }
+    }
+    pthread_mutex_unlock(&world->cache_mutex);
+    return count;
+}
+
+int server_bench_load_storm(const char *world_name, int jumps) {
+    if (jumps <= 0) {
+        jumps = LOAD_STORM_DEFAULT_JUMPS;
+    }
+    World *world = check_world_create(world_name, CHECK_ANY_SEED);
+    if (!world) {
+        return 1;
+    }
+
+    printf("[storm] Generating and storing %d jump(s) of chunks...\n", jumps);
+    double main_time = 0.0;
+    for (int jump = 0; jump < jumps; jump++) {
+        load_storm_visit(world, jump, true, &main_time);
+        if (!world_save(world, world_name)) {
+            fprintf(stderr, "Failed to save world '%s'\n", world_name);
+            world_free(world);
+            return 1;
+        }
+    }
+
+    // Drop every chunk so the timed pass has to read them all back
+    world_load(world, world_name);
+    worker_flush_queue(world);
+
+    static const char *const backend_names[] = {"auto", "io_uring", "threads", "sync"};
+    int total = 0;
+    double elapsed = 0.0;
+    double main_total = 0.0;
+    double main_worst = 0.0;
+    for (int jump = 0; jump < jumps; jump++) {
+        double start = check_now();
+        total += load_storm_visit(world, jump, false, &main_time);
+        elapsed += check_now() - start;
+        main_total += main_time;
+        if (main_time > main_worst) {
+            main_worst = main_time;
+        }
+        // Meshing of this jump's chunks is not part of the next one's time
+        worker_flush_queue(world);
+    }
+
+    // Loaded: until every chunk was in memory. Main thread: the frame stall a player would see.
+    printf("[storm] %s: %d chunks over %d jumps loaded in %.3fs (%.0f chunks/s, %.2f ms per jump); "
+           "main thread %.2f ms per jump, worst %.2f ms\n",
+           backend_names[world->chunk_io.backend], total, jumps, elapsed, elapsed > 0.0 ? total / elapsed : 0.0,
+           elapsed * 1000.0 / jumps, main_total * 1000.0 / jumps, main_worst * 1000.0);
+
+    world_free(world);
+    return 0;
+}
+
+// ============================================================================
+// SAVE ROUND-TRIP CHECK
+// ============================================================================
+// `--save-check` edits blocks across a spread of chunks, queues every chunk for
+// saving several times over (each modified chunk must be queued at most once per
+// pass), keeps editing while the save thread writes, then saves. Afterwards no
+// chunk may still be modified. The world is then freed, opened again from disk,
+// and every edit must be there. Last, a chunk whose stored record this build
+// can't decode must load read-only: edits to it are refused, and saving the
+// world leaves the record byte for byte as it was.
+
+#define SAVE_CHECK_Y 70     // Edited layer, inside the chunks check_world_open loads
+#define SAVE_CHECK_ROW_Y 80 // Row edited while the save thread is busy
+#define SAVE_CHECK_ROW_EDITS 200
+#define SAVE_CHECK_FOREIGN_X -1 // Chunk given a record in an unknown method, below the edited layer
+#define SAVE_CHECK_FOREIGN_Y 0
+#define SAVE_CHECK_FOREIGN_Z -1
+
+// A well-formed record in a method no build knows ("B3DV", version 2, method 200)
+static const uint8_t SAVE_CHECK_FOREIGN_RECORD[] = {'B', '3', 'D', 'V', 2, 200, 1, 0, 0, 0, 1, 0, 0, 0, 0xAB};
+
+// Store the foreign record, open the world and check it is left alone; returns the errors
+static long save_check_foreign(const char *world_name) {
+    if (!region_write_chunk(world_name, SAVE_CHECK_FOREIGN_X, SAVE_CHECK_FOREIGN_Y, SAVE_CHECK_FOREIGN_Z,
+                            SAVE_CHECK_FOREIGN_RECORD, sizeof(SAVE_CHECK_FOREIGN_RECORD))) {
+        return 1;
+    }
+    World *world = check_world_open(world_name, CHECK_ANY_SEED, CHECK_LOAD_DIST);
+    if (!world) {
+        return 1;
+    }
+
+    long bad = 0;
+    int x = SAVE_CHECK_FOREIGN_X * CHUNK_WIDTH + 5;
+    int y = SAVE_CHECK_FOREIGN_Y * CHUNK_HEIGHT + 5;
+    int z = SAVE_CHECK_FOREIGN_Z * CHUNK_DEPTH + 5;
+    pthread_mutex_lock(&world->cache_mutex);
+    Chunk *chunk = world_get_chunk(world, SAVE_CHECK_FOREIGN_X, SAVE_CHECK_FOREIGN_Y, SAVE_CHECK_FOREIGN_Z);
+    if (!chunk || !chunk->read_only || !chunk->generated) {
+        bad++;
+    } else {
+        // Even if something marks it modified, no save may write it
+        pthread_mutex_lock(&chunk->mutex);
+        chunk->modified = true;
+        pthread_mutex_unlock(&chunk->mutex);
+    }
+    pthread_mutex_unlock(&world->cache_mutex);
+    if (world_set_block(world, x, y, z, BLOCK_GLASS) || world_get_block(world, x, y, z) == BLOCK_GLASS) {
+        bad++;
+    }
+    if (!world_save(world, world_name)) {
+        bad++;
+    }
+    world_free(world);
+
+    RegionChunkView view;
+    if (!region_map_chunk(world_name, SAVE_CHECK_FOREIGN_X, SAVE_CHECK_FOREIGN_Y, SAVE_CHECK_FOREIGN_Z, &view)) {
+        return bad + 1;
+    }
+    if (view.size != sizeof(SAVE_CHECK_FOREIGN_RECORD) ||
+        memcmp(view.data, SAVE_CHECK_FOREIGN_RECORD, sizeof(SAVE_CHECK_FOREIGN_RECORD)) != 0) {
+        bad++;
+    }
+    region_unmap_chunk(&view);
+    return bad;
+}
+
+static BlockType save_check_type(int n) {
+    return (BlockType)(BLOCK_STONE + n % (BLOCK_GLASS - BLOCK_STONE));
+}
+
+// One edited block per chunk column around the origin; returns how many differ from what was written
+static long save_check_edits(World *world, bool write) {
+    long bad = 0;
+    int n = 0;
+    for (int chunk_x = -CHECK_LOAD_DIST; chunk_x <= CHECK_LOAD_DIST; chunk_x++) {
+        for (int chunk_z = -CHECK_LOAD_DIST; chunk_z <= CHECK_LOAD_DIST; chunk_z++) {
+            int x = chunk_x * CHUNK_WIDTH + 3;
+            int z = chunk_z * CHUNK_DEPTH + 4;
+            if (write) {
+                world_set_block(world, x, SAVE_CHECK_Y, z, save_check_type(n));
+            } else if (world_get_block(world, x, SAVE_CHECK_Y, z) != save_check_type(n)) {
+                bad++;
+            }
+            n++;
+        }
+    }
+    return bad;
+}
+
+int server_check_save(const char *world_name) {
+    World *world = check_world_open(world_name, CHECK_ANY_SEED, CHECK_LOAD_DIST);
+    if (!world) {
+        return 1;
+    }
+
+    long bad = 0;
+    save_check_edits(world, true);
+    worker_flush_queue(world);
+
+    // Queue everything several times: already-queued chunks must not be queued again
+    int modified = 0;
+    int queued = 0;
+    pthread_mutex_lock(&world->cache_mutex);
+    for (int i = 0; i < world->chunk_cache.chunk_count; i++) {
+        modified += world->chunk_cache.live[i]->modified ? 1 : 0;
+    }
+    for (int pass = 0; pass < 5; pass++) {
+        for (int i = 0; i < world->chunk_cache.chunk_count; i++) {
+            queued += save_queue_chunk(world, world->chunk_cache.live[i]) ? 1 : 0;
+        }
+    }
+    pthread_mutex_unlock(&world->cache_mutex);
+    if (queued > modified) {
+        bad++;
+    }
+
+    // Edit while the save thread may be writing the same chunks
+    for (int k = 0; k < SAVE_CHECK_ROW_EDITS; k++) {
+        world_set_block(world, 10 + k % 20, SAVE_CHECK_ROW_Y, 10, BLOCK_COBBLESTONE);
+    }
+    if (!world_save(world, world_name)) {
+        bad++;
+    }
+    int still_modified = 0;
+    pthread_mutex_lock(&world->cache_mutex);
+    for (int i = 0; i < world->chunk_cache.chunk_count; i++) {
+        still_modified += world->chunk_cache.live[i]->modified ? 1 : 0;
+    }
+    pthread_mutex_unlock(&world->cache_mutex);
+    bad += still_modified;
+    world_free(world);
+
+    // Everything must come back from disk
+    world = check_world_open(world_name, CHECK_ANY_SEED, CHECK_LOAD_DIST);
+    if (!world) {
+        return 1;
+    }
+    long lost = save_check_edits(world, false);
+    for (int k = 0; k < 20; k++) {
+        if (world_get_block(world, 10 + k, SAVE_CHECK_ROW_Y, 10) != BLOCK_COBBLESTONE) {
+            lost++;
+        }
+    }
+    bad += lost;
+    world_free(world);
+
+    long foreign = save_check_foreign(world_name);
+    bad += foreign;
+
+    bool ok = bad == 0;
+    printf("[save-check] %d modified chunks, %d queued over 5 passes, %d still modified after save, "
+           "%ld edits lost on reload, %ld errors with an undecodable record; %s\n",
+           modified, queued, still_modified, lost, foreign, ok ? "ok" : "FAILED");
+    return ok ? 0 : 1;
+}
+
+// ============================================================================
+// SMOKE TEST
+// ============================================================================
+// `--smoke` runs the world the way a session does: chunk updates while the view
+// turns, so queued generation is re-prioritised and chunks behind the view are
+// unloaded mid-flight. After a last update looking down and once the queues drain,
+// every chunk around the player must be published and meshed, and (in a world
+// that didn't exist before) hold exactly the blocks world_generate_chunk_blocks
+// gives. An edit must be visible at once and remesh its chunk, and collision
+// lookups must read missing chunks as solid. Edits into chunks still waiting for
+// their terrain must be refused, and those that were accepted must survive the
+// publish. Moving on to a smaller area must hand chunk slab memory back (see
+// chunk_pool.c). Prints a digest of the terrain.
+
+#define SMOKE_TURNS 8
+#define SMOKE_PENDING_EDITS 256 // Most chunks edited while a far area is still loading
+#define SMOKE_SHRINK_FRAMES 2000 // Bound on chunk updates while shrinking (one unload each)
+#define SMOKE_SHRINK_SETTLED 4   // Updates without an unload before the area counts as shrunk
+
+int server_check_smoke(const char *world_name) {
+    char path[512];
+    snprintf(path, sizeof(path), "./worlds/%s", world_name);
+    struct stat st;
+    bool fresh = stat(path, &st) != 0;
+
+    World *world = check_world_create(world_name, CHECK_ANY_SEED);
+    if (!world) {
+        return 1;
+    }
+
+    // Turn a full circle in steps without waiting for the workers in between
+    double start = check_now();
+    for (int turn = 0; turn < SMOKE_TURNS; turn++) {
+        float angle = (float)turn * 6.2831853f / SMOKE_TURNS;
+        Vector3 forward = {sinf(angle), 0.0f, cosf(angle)};
+        worker_set_interest(world, CHECK_POSITION, forward);
+        world_update_chunks(world, CHECK_POSITION, forward, (float)(CHECK_LOAD_DIST * CHUNK_WIDTH));
+    }
+    // Turning unloads chunks that fell behind; looking down brings back every one in range
+    Vector3 down = {0.0f, -1.0f, 0.0f};
+    worker_set_interest(world, CHECK_POSITION, down);
+    world_update_chunks(world, CHECK_POSITION, down, (float)(CHECK_LOAD_DIST * CHUNK_WIDTH));
+    chunk_io_flush(world);
+    worker_flush_queue(world);
+    double load_time = check_now() - start;
+
+    Block(*blocks)[CHUNK_DEPTH][CHUNK_WIDTH] = malloc(sizeof(Block) * CHUNK_HEIGHT * CHUNK_DEPTH * CHUNK_WIDTH);
+    if (!blocks) {
+        fprintf(stderr, "Failed to allocate block buffer\n");
+        world_free(world);
+        return 1;
+    }
+
+    int32_t center_y = (int32_t)floorf(CHECK_POSITION.y / CHUNK_HEIGHT);
+    int chunks = 0;
+    long missing = 0;
+    long differ = 0;
+    uint64_t digest = 1469598103934665603ull; // FNV-1a over every block, in chunk order
+    for (int32_t cx = -CHECK_LOAD_DIST; cx <= CHECK_LOAD_DIST; cx++) {
+        for (int32_t cy = center_y - CHECK_LOAD_DIST; cy <= center_y + CHECK_LOAD_DIST; cy++) {
+            for (int32_t cz = -CHECK_LOAD_DIST; cz <= CHECK_LOAD_DIST; cz++) {
+                pthread_mutex_lock(&world->cache_mutex);
+                Chunk *chunk = world_get_chunk(world, cx, cy, cz);
+                bool ready = chunk && chunk->generated && chunk->loaded && !chunk->pending_generate &&
+                             __atomic_load_n(&chunk->mesh_version, __ATOMIC_ACQUIRE) > 0;
+                pthread_mutex_unlock(&world->cache_mutex);
+                if (!ready) {
+                    missing++;
+                    continue;
+                }
+                chunks++;
+
+                if (fresh) {
+                    world_generate_chunk_blocks(blocks, cx, cy, cz, world->seed);
+                }
+                for (int y = 0; y < CHUNK_HEIGHT; y++) {
+                    for (int z = 0; z < CHUNK_DEPTH; z++) {
+                        for (int x = 0; x < CHUNK_WIDTH; x++) {
+                            BlockType type = world_chunk_get_block(chunk, x, y, z);
+                            digest = (digest ^ (uint64_t)type) * 1099511628211ull;
+                            if (fresh && type != blocks[y][z][x].type) {
+                                differ++;
+                            }
+                        }
+                    }
+                }
+            }
+        }
+    }
+    free(blocks);
+
+    // An edit shows up at once and rebuilds the chunk's mesh on the spot
+    long bad = 0;
+    int edit_x = 5;
+    int edit_y = (int)CHECK_POSITION.y;
+    int edit_z = 5;
+    Chunk *edited = world_get_chunk(world, 0, center_y, 0);
+    uint32_t version = edited ? __atomic_load_n(&edited->mesh_version, __ATOMIC_ACQUIRE) : 0;
+    BlockType before = world_get_block(world, edit_x, edit_y, edit_z);
+    BlockType placed = before == BLOCK_GLASS ? BLOCK_WOOD : BLOCK_GLASS;
+    world_set_block(world, edit_x, edit_y, edit_z, placed);
+    if (world_get_block(world, edit_x, edit_y, edit_z) != placed || !edited ||
+        __atomic_load_n(&edited->mesh_version, __ATOMIC_ACQUIRE) == version) {
+        bad++;
+    }
+    world_set_block(world, edit_x, edit_y, edit_z, before);
+    worker_flush_queue(world);
+
+    // Collision reads loaded blocks as they are and chunks that aren't there as solid
+    int far = (CHECK_LOAD_DIST + 8) * CHUNK_WIDTH;
+    if (world_get_block_or_solid(world, edit_x, edit_y, edit_z) != before ||
+        world_get_block_or_solid(world, far, edit_y, far) == BLOCK_AIR ||
+        world_get_block(world, far, edit_y, far) != BLOCK_AIR) {
+        bad++;
+    }
+
+    // Move to an area nothing has loaded yet and edit one block (glass, which terrain
+    // never has) in every chunk still pending, before the queues get to them
+    Vector3 away = {(float)-far, CHECK_POSITION.y, (float)-far};
+    worker_set_interest(world, away, down);
+    world_update_chunks(world, away, down, (float)(CHECK_LOAD_DIST * CHUNK_WIDTH));
+    int edits[SMOKE_PENDING_EDITS][3];
+    bool applied[SMOKE_PENDING_EDITS];
+    int edit_count = 0;
+    pthread_mutex_lock(&world->cache_mutex);
+    for (int i = 0; i < world->chunk_cache.chunk_count && edit_count < SMOKE_PENDING_EDITS; i++) {
+        Chunk *chunk = world->chunk_cache.live[i];
+        if (__atomic_load_n(&chunk->generated, __ATOMIC_ACQUIRE)) {
+            continue;
+        }
+        edits[edit_count][0] = chunk->chunk_x * CHUNK_WIDTH + 3;
+        edits[edit_count][1] = chunk->chunk_y * CHUNK_HEIGHT + 3;
+        edits[edit_count][2] = chunk->chunk_z * CHUNK_DEPTH + 3;
+        edit_count++;
+    }
+    pthread_mutex_unlock(&world->cache_mutex);
+    int refused = 0;
+    for (int i = 0; i < edit_count; i++) {
+        applied[i] = world_set_block(world, edits[i][0], edits[i][1], edits[i][2], BLOCK_GLASS);
+        refused += applied[i] ? 0 : 1;
+    }
+    chunk_io_flush(world);
+    worker_flush_queue(world);
+    long lost = 0;
+    for (int i = 0; i < edit_count; i++) {
+        bool glass = world_get_block(world, edits[i][0], edits[i][1], edits[i][2]) == BLOCK_GLASS;
+        if (glass != applied[i]) {
+            lost++;
+        }
+    }
+    if (refused == 0 || lost > 0) {
+        bad++;
+    }
+
+    // Shrink to the nearest chunks of a third area; what the pool keeps mapped must drop
+    pthread_mutex_lock(&world->cache_mutex);
+    size_t peak_bytes = chunk_pool_reserved_bytes(&world->chunk_cache);
+    int peak_chunks = world->chunk_cache.chunk_count;
+    pthread_mutex_unlock(&world->cache_mutex);
+    Vector3 shrunk = {(float)far, CHECK_POSITION.y, (float)-far};
+    worker_set_interest(world, shrunk, down);
+    int settled = 0;
+    int previous = peak_chunks;
+    for (int frame = 0; frame < SMOKE_SHRINK_FRAMES && settled < SMOKE_SHRINK_SETTLED; frame++) {
+        world_update_chunks(world, shrunk, down, (float)CHUNK_WIDTH);
+        world->last_chunk_update_position.x = 1e10f; // Next update runs in full even though nothing moved
+        chunk_io_flush(world);
+        worker_flush_queue(world);
+        save_queue_flush(world);
+        pthread_mutex_lock(&world->cache_mutex);
+        int count = world->chunk_cache.chunk_count;
+        pthread_mutex_unlock(&world->cache_mutex);
+        settled = count == previous ? settled + 1 : 0;
+        previous = count;
+    }
+    pthread_mutex_lock(&world->cache_mutex);
+    size_t shrunk_bytes = chunk_pool_reserved_bytes(&world->chunk_cache);
+    int shrunk_chunks = world->chunk_cache.chunk_count;
+    pthread_mutex_unlock(&world->cache_mutex);
+    if (shrunk_chunks >= peak_chunks || shrunk_bytes >= peak_bytes) {
+        bad++;
+    }
+
+    bool ok = chunks > 0 && missing == 0 && differ == 0 && bad == 0;
+    printf("[smoke] %d chunks ready in %.3fs, %ld missing, %s, %d edits to loading chunks (%d refused, %ld lost), "
+           "chunk pool %zu KiB for %d chunks, %zu KiB after shrinking to %d, %ld other errors, digest %016llx; %s\n",
+           chunks, load_time, missing,
+           fresh ? (differ == 0 ? "blocks match generation" : "BLOCKS DIFFER from generation")
+                 : "stored world (generation not compared)",
+           edit_count, refused, lost, peak_bytes / 1024, peak_chunks, shrunk_bytes / 1024, shrunk_chunks, bad,
+           (unsigned long long)digest, ok ? "ok" : "FAILED");
+    world_free(world);
+    return ok ? 0 : 1;
+}
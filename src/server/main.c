@@ -13,6 +13,7 @@
 #include "../../include/player.h"
 #include "../../include/game_server.h"
 #include "../../include/console.h"
+#include "../../include/server_checks.h"
 
 static int set_nonblocking(int fd) {
     int flags = fcntl(fd, F_GETFL, 0);
@@ -121,11 +122,52 @@ static int accept_client_connection(int listen_fd, char *out_addr, size_t addr_s
 
 int b3dv_main(int argc, char **argv) {
     if (argc < 2) {
-        fprintf(stderr, "Usage: b3dv-server <world_name> [port]\n");
+        fprintf(stderr, "Usage: b3dv-server <world_name> [port]\n"
+                        "       b3dv-server <world_name> --noise-bench [chunks]\n"
+                        "       b3dv-server <world_name> --hash-bench [slots]\n"
+                        "       b3dv-server <world_name> --mesh-bench [passes]\n"
+                        "       b3dv-server <world_name> --mesh-check\n"
+                        "       b3dv-server <world_name> --raycast-check\n"
+                        "       b3dv-server <new_world_name> --region-check\n"
+                        "       b3dv-server <world_name> --load-bench [passes]\n"
+                        "       b3dv-server <world_name> --save-check\n"
+                        "       b3dv-server <world_name> --load-storm [jumps]\n"
+                        "       b3dv-server <world_name> --smoke\n");
         return 1;
     }
 
     const char *world_name = argv[1];
+    if (argc >= 3 && strcmp(argv[2], "--noise-bench") == 0) {
+        return server_bench_noise(argc >= 4 ? atoi(argv[3]) : 0);
+    }
+    if (argc >= 3 && strcmp(argv[2], "--hash-bench") == 0) {
+        return server_bench_hash(argc >= 4 ? atoi(argv[3]) : 0);
+    }
+    if (argc >= 3 && strcmp(argv[2], "--mesh-bench") == 0) {
+        return server_bench_mesh(world_name, argc >= 4 ? atoi(argv[3]) : 0);
+    }
+    if (argc >= 3 && strcmp(argv[2], "--mesh-check") == 0) {
+        return server_check_mesh(world_name);
+    }
+    if (argc >= 3 && strcmp(argv[2], "--raycast-check") == 0) {
+        return server_check_raycast(world_name);
+    }
+    if (argc >= 3 && strcmp(argv[2], "--region-check") == 0) {
+        return server_check_region(world_name);
+    }
+    if (argc >= 3 && strcmp(argv[2], "--load-bench") == 0) {
+        return server_bench_load(world_name, argc >= 4 ? atoi(argv[3]) : 0);
+    }
+    if (argc >= 3 && strcmp(argv[2], "--save-check") == 0) {
+        return server_check_save(world_name);
+    }
+    if (argc >= 3 && strcmp(argv[2], "--load-storm") == 0) {
+        return server_bench_load_storm(world_name, argc >= 4 ? atoi(argv[3]) : 0);
+    }
+    if (argc >= 3 && strcmp(argv[2], "--smoke") == 0) {
+        return server_check_smoke(world_name);
+    }
+
     int port = 42069;
     if (argc >= 3) {
         int parsed_port = atoi(argv[2]);
@@ -291,8 +333,8 @@ int b3dv_main(int argc, char **argv) {
                     int z = 0;
                     if (sscanf(line + 11, "%d %d %d", &x, &y, &z) == 3) {
                         BlockType current = world_get_block(srv.world, x, y, z);
-                        if (current != BLOCK_AIR && current != BLOCK_BEDROCK) {
-                            world_set_block(srv.world, x, y, z, BLOCK_AIR);
+                        if (current != BLOCK_AIR && current != BLOCK_BEDROCK &&
+                            world_set_block(srv.world, x, y, z, BLOCK_AIR)) {
                             char update[256];
                             int len = snprintf(update, sizeof(update), "BLOCKSET %d %d %d %d\n", x, y, z, BLOCK_AIR);
                             if (len > 0) {
@@ -307,8 +349,8 @@ int b3dv_main(int argc, char **argv) {
                     int block_type = 0;
                     if (sscanf(line + 11, "%d %d %d %d", &x, &y, &z, &block_type) == 4) {
                         BlockType place_type = (BlockType)block_type;
-                        if (place_type >= BLOCK_AIR && place_type <= BLOCK_GLASS) {
-                            world_set_block(srv.world, x, y, z, place_type);
+                        if (place_type >= BLOCK_AIR && place_type <= BLOCK_GLASS &&
+                            world_set_block(srv.world, x, y, z, place_type)) {
                             char update[256];
                             int len = snprintf(update, sizeof(update), "BLOCKSET %d %d %d %d\n", x, y, z, place_type);
                             if (len > 0) {